@@ -11,6 +11,13 @@
 #include <stdint.h>
 #include "lcd_port.h"
 #include "lcd_font.h"
+#include "lcd_stream.h"
+#include "lcd_fill_plan.h"
+#include "lcd_window.h"
+#include "lcd_rmw.h"
+
+/* 各型号/方向中最长的一行 (1.47" 横屏 320), 行缓冲按此分配 */
+#define LCD_LINE_MAX    320
 
 typedef enum {
     LCD_0_96_INCH = 0,
@@ -37,14 +44,19 @@ typedef struct __lcd_hw {
 typedef struct __lcd {
     lcd_io* io;
     lcd_hw* hw;
+    lcd_hw geometry;        // 本实例的型号/尺寸/方向, lcd_init_dev 后 hw 指向这里
     lcd_font font;
     
     void (*init)(lcd_io*, lcd_hw*);
     void (*print)(lcd_io*, uint16_t x, uint16_t y, uint16_t colar, const char *fmt, ...);
 
     uint16_t* line_buffer;
+    uint16_t* line_buffer_alt;  // 乒乓发送的第二行缓冲, 可为 NULL
     uint16_t* frame_buffer; // frame_w/h/size
     uint32_t timeout;
+
+    const uint8_t* offset;  // 当前型号/方向的地址偏移 (lcd_init_hw 时查表)
+    lcd_window window;      // 面板当前窗口, 未变化的 CASET/RASET 不再发送
 } lcd;
 
 extern lcd_hw lcd_hw_0_96;
@@ -54,6 +66,7 @@ extern lcd_hw lcd_hw_1_47;
 void lcd_init_dev(lcd* plcd, lcd_type type, lcd_rotate rotate);
 void lcd_init_hw(lcd* plcd);
 void lcd_clear(lcd* plcd, uint16_t color);
+void lcd_set_vsync(lcd* plcd, bool on);
 
 void lcd_draw_point(lcd* plcd, uint16_t x, uint16_t y, uint16_t color);
 void lcd_show_char(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr);
@@ -65,6 +78,12 @@ void lcd_fill(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uin
 void lcd_set_font(lcd* plcd, font_type type, uint16_t front_color, uint16_t back_color);
 void lcd_show_picture(lcd* plcd, uint16_t x, uint16_t y, uint16_t length, uint16_t width, uint8_t* pic);
 void lcd_set_address(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+void lcd_draw_lines(lcd* plcd, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                    lcd_line_gen gen, void* arg);
+bool lcd_modify(lcd* plcd, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                lcd_rmw_fn fn, void* arg);
+bool lcd_fill_blend(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                    uint16_t color, uint8_t alpha);
 
 void lcd_write_reg_data(lcd_io* lcdio, int len, ...);
 #define NUMARGS(...)  (sizeof((int[]){__VA_ARGS__}) / sizeof(int))
@@ -2,9 +2,71 @@
 #include <stdarg.h> 
 #include <stdio.h>
 
+#if LCD_ANIM_BANDED
+/* --- 条带渲染: 图元列表 + 两个条带缓冲 --- */
+// 2 * 320 * 16 * 2 Bytes = 20,480 Bytes
+static lcd_prim s_prims[LCD_ANIM_PRIMS];
+static lcd_scene s_scene;
+static uint16_t s_band[2][LCD_ANIM_MAX_WIDTH * LCD_ANIM_BAND_LINES];
+#else
 /* --- Framebuffer --- */
-// 240 * 135 * 2 Bytes = 64,800 Bytes
-uint16_t g_gram[LCD_WIDTH * LCD_HEIGHT];
+// 默认 240 * 135 * 2 Bytes = 64,800 Bytes (8bpp 32,400 Bytes, 4bpp 16,200 Bytes), 见 LCD_ANIM_GRAM_BYTES
+#define GRAM_PER_WORD   (16 / LCD_ANIM_BPP)             // 每个 uint16_t 存放的像素数
+#define GRAM_MAX_WORDS  (LCD_SURFACE_STRIDE(LCD_ANIM_MAX_WIDTH, LCD_ANIM_BPP) / 2)
+uint16_t g_gram[(LCD_ANIM_GRAM_BYTES + 1) / 2];
+
+#if LCD_ANIM_BPP != 16
+static lcd_palette s_palette;
+#endif
+#endif
+
+/* --- 根表面: 整个屏幕, 尺寸取自面板 --- */
+static lcd_surface s_screen;
+
+/* --- 脏矩形 --- */
+static lcd_dirty s_damage;      // 上次刷新后改变的区域
+static lcd_dirty s_footprint;   // 上次清屏后绘制过的区域, 清屏时转为 s_damage
+
+static lcd_anim_flush_mode s_flush_mode = LCD_ANIM_FLUSH_DIRTY;
+
+/* --- 覆盖层: 发送时合成, s_blend 为当前发送的矩形需要合成的覆盖层 --- */
+static lcd_overlay* s_overlay;
+#if !LCD_ANIM_BANDED
+static const lcd_overlay* s_blend;
+#endif
+
+/* --- 保留模式: 显示列表, 重画时绘制裁剪到 s_clip --- */
+static bool s_redraw;           // 重画区域已由 lcd_dlist_diff 计入, 绘制时不再记录
+static lcd_rect s_clip;         // 根表面坐标, 平时为全屏
+#if !LCD_ANIM_BANDED
+static lcd_dlist s_list;
+#endif
+
+/* --- 当前绘制的表面: 坐标偏移与裁剪范围 (表面 ∩ s_clip, 根表面坐标) --- */
+static int16_t s_ox, s_oy;
+static lcd_rect s_draw;
+
+#if !LCD_ANIM_BANDED
+/* --- 分块哈希: 每块只保存上一帧的哈希 (最多 20 x 20 块, 1,600 Bytes) --- */
+static lcd_tiles s_tiles;
+static uint32_t s_tile_hash[LCD_TILE_COLS(GRAM_MAX_WORDS) * LCD_TILE_ROWS(LCD_ANIM_MAX_HEIGHT)];
+#if LCD_TILE_HW_CRC
+static const lcd_tile_hash_ops* const s_tile_ops = &lcd_tile_hash_crc;
+#else
+static const lcd_tile_hash_ops* const s_tile_ops = &lcd_tile_hash_soft;
+#endif
+static uint32_t s_tile_ctx;
+
+/* --- 增量清屏: 按行记录上次清屏后画过的像素段 (320 行 * 4 段, 约 5.4 KB) --- */
+static lcd_anim_clear_mode s_clear_mode = LCD_ANIM_CLEAR_SPANS;
+static lcd_span s_erase_row[LCD_ANIM_MAX_HEIGHT][LCD_SPAN_MAX];
+static uint8_t s_erase_count[LCD_ANIM_MAX_HEIGHT];
+static lcd_spans s_erase;
+
+/* --- 异步清屏: 全清交给 s_m2m, 之后第一次绘制/刷新前等待 --- */
+static lcd_m2m* s_m2m;
+static bool s_clearing;
+#endif
 
 static const Point3D cube_vertices[8] = {
     {-1, -1, -1}, { 1, -1, -1}, { 1,  1, -1}, {-1,  1, -1},
@@ -17,15 +79,122 @@ static const uint8_t cube_edges[12][2] = {
     {0,4}, {1,5}, {2,6}, {3,7}  // 连接线
 };
 
-/* --- RAM 画点 (极快) --- */
-static void _draw_point_ram(int16_t x, int16_t y, uint16_t color)
+/* --- 等待异步清屏完成 --- */
+static void _clear_sync(void)
+{
+#if !LCD_ANIM_BANDED
+    if (s_clearing) {
+        lcd_m2m_wait(s_m2m);
+        s_clearing = false;
+    }
+#endif
+}
+
+/* --- 开始在 surf 上绘制: 之后的坐标 (根表面坐标) 都裁剪到 s_draw --- */
+static void _begin(const lcd_surface* surf)
+{
+    _clear_sync();
+    lcd_surface_rect(surf, &s_draw);
+    if (s_draw.x1 < s_clip.x1) s_draw.x1 = s_clip.x1;
+    if (s_draw.y1 < s_clip.y1) s_draw.y1 = s_clip.y1;
+    if (s_draw.x2 > s_clip.x2) s_draw.x2 = s_clip.x2;
+    if (s_draw.y2 > s_clip.y2) s_draw.y2 = s_clip.y2;
+    s_ox = surf->x;
+    s_oy = surf->y;
+#if LCD_ANIM_BANDED
+    lcd_scene_clip(&s_scene, s_draw.x1, s_draw.y1, s_draw.x2, s_draw.y2);
+#endif
+}
+
+/* --- 记录改变的区域 --- */
+static void _mark_ram(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if (s_redraw) return;
+    if (x1 < s_draw.x1) x1 = s_draw.x1;
+    if (y1 < s_draw.y1) y1 = s_draw.y1;
+    if (x2 > s_draw.x2) x2 = s_draw.x2;
+    if (y2 > s_draw.y2) y2 = s_draw.y2;
+    if (x1 > x2 || y1 > y2) return;
+    lcd_dirty_add(&s_damage, x1, y1, x2, y2);
+    lcd_dirty_add(&s_footprint, x1, y1, x2, y2);
+}
+
+#if LCD_ANIM_BANDED
+/* --- 条带模式下只记录图元 --- */
+static void _draw_line_ram(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    x1 += s_ox; y1 += s_oy;
+    x2 += s_ox; y2 += s_oy;
+    _mark_ram((x1 < x2 ? x1 : x2) - 1, (y1 < y2 ? y1 : y2) - 1,
+              (x1 > x2 ? x1 : x2) + 1, (y1 > y2 ? y1 : y2) + 1);
+    lcd_scene_line(&s_scene, x1, y1, x2, y2, LCD_PIXEL(color));
+}
+#else
+/* --- 颜色 -> 显存中的值: LCD_PIXEL 格式或调色板索引 --- */
+static uint16_t _gram_value(uint16_t color)
+{
+#if LCD_ANIM_BPP == 16
+    // 16 位帧模式下即本机字节序, 无需交换
+    return LCD_PIXEL(color);
+#else
+    return lcd_palette_index(&s_palette, color);
+#endif
+}
+
+/* --- 写根表面中的一个像素 --- */
+static inline void _gram_put(int16_t x, int16_t y, uint16_t value)
+{
+    uint8_t* row = s_screen.pixels + (uint32_t)y * s_screen.stride;
+
+#if LCD_ANIM_BPP == 16
+    ((uint16_t *)row)[x] = value;
+#elif LCD_ANIM_BPP == 8
+    row[x] = value;
+#else
+    uint8_t* p = &row[x >> 1];
+    *p = (x & 1) ? (*p & 0x0F) | (value << 4) : (*p & 0xF0) | value;
+#endif
+}
+
+/* --- 把显存中一行的 [x1, x2] 清为 0 --- */
+static void _clear_span(int16_t y, int16_t x1, int16_t x2)
 {
-    if (x < 0 || x >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT) return;
+#if LCD_ANIM_BPP == 4
+    for (int16_t x = x1; x <= x2; x++)
+        _gram_put(x, y, 0);
+#else
+    memset(s_screen.pixels + (uint32_t)y * s_screen.stride + x1 * (LCD_ANIM_BPP / 8), 0,
+           (x2 - x1 + 1) * (LCD_ANIM_BPP / 8));
+#endif
+}
+
+/* --- 记录下次清屏时要擦除的像素段 --- */
+static void _erase_span(int16_t y, int16_t x1, int16_t x2)
+{
+    if (s_clear_mode != LCD_ANIM_CLEAR_SPANS || s_redraw) return;
+    if (y < s_draw.y1 || y > s_draw.y2) return;
+    if (x1 < s_draw.x1) x1 = s_draw.x1;
+    if (x2 > s_draw.x2) x2 = s_draw.x2;
+    if (x1 <= x2)
+        lcd_spans_add(&s_erase, y, x1, x2);
+}
+
+static void _erase_rect(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if (s_clear_mode != LCD_ANIM_CLEAR_SPANS || s_redraw) return;
+    if (x1 < s_draw.x1) x1 = s_draw.x1;
+    if (y1 < s_draw.y1) y1 = s_draw.y1;
+    if (x2 > s_draw.x2) x2 = s_draw.x2;
+    if (y2 > s_draw.y2) y2 = s_draw.y2;
+    lcd_spans_add_rect(&s_erase, x1, y1, x2, y2);
+}
+
+/* --- RAM 写像素 (根表面坐标), 不记录脏区域 --- */
+static void _plot_ram(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < s_draw.x1 || x > s_draw.x2 || y < s_draw.y1 || y > s_draw.y2) return;
     
-    // 写入数组，注意：这里为了DMA传输效率，建议直接存交换后的大小端
-    // 如果你的 lcd_write_bulk 内部没有交换大小端，这里需要 color = (color<<8)|(color>>8);
-    // 假设 lcd_write_bulk 是纯数据发送，我们在存的时候就交换好：
-    g_gram[y * LCD_WIDTH + x] = (color << 8) | (color >> 8);
+    _gram_put(x, y, _gram_value(color));
 }
 
 /* --- RAM 画线 (Bresenham算法) --- */
@@ -35,6 +204,10 @@ static void _draw_line_ram(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint1
     int delta_x = x2 - x1, delta_y = y2 - y1;
     int distance;
     int incx, incy, uRow, uCol;
+    int run_y, run_x1, run_x2;  // 当前行画过的范围, 换行时记录为擦除段
+
+    x1 += s_ox; y1 += s_oy;
+    x2 += s_ox; y2 += s_oy;
 
     if (delta_x > 0) incx = 1;
     else if (delta_x == 0) incx = 0;
@@ -47,29 +220,63 @@ static void _draw_line_ram(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint1
     uRow = x1; uCol = y1;
     distance = delta_x > delta_y ? delta_x : delta_y;
 
+    // 终点之后还会多画一步, 外包框各扩 1 像素
+    _mark_ram((x1 < x2 ? x1 : x2) - 1, (y1 < y2 ? y1 : y2) - 1,
+              (x1 > x2 ? x1 : x2) + 1, (y1 > y2 ? y1 : y2) + 1);
+
+    run_y = uCol; run_x1 = run_x2 = uRow;
     for (int t = 0; t <= distance + 1; t++) {
-        _draw_point_ram(uRow, uCol, color); // <--- 画到 RAM
+        _plot_ram(uRow, uCol, color); // <--- 画到 RAM
+        if (uCol != run_y) {
+            _erase_span(run_y, run_x1, run_x2);
+            run_y = uCol; run_x1 = run_x2 = uRow;
+        } else if (uRow < run_x1) {
+            run_x1 = uRow;
+        } else if (uRow > run_x2) {
+            run_x2 = uRow;
+        }
         xerr += delta_x;
         yerr += delta_y;
         if (xerr > distance) { xerr -= distance; uRow += incx; }
         if (yerr > distance) { yerr -= distance; uCol += incy; }
     }
+    _erase_span(run_y, run_x1, run_x2);
 }
+#endif
 
 /**
  * @brief 在 RAM 中显示一个字符
  */
-void lcd_show_char_ram(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
+void lcd_show_char_ram(const lcd_surface* surf, uint16_t x, uint16_t y, uint16_t chr)
 {
+    lcd* plcd = surf->plcd;
+#if !LCD_ANIM_BANDED
     uint8_t width_cnt = 0; // 当前行的像素计数
     uint8_t y_offset = 0;  // 当前行的 Y 偏移
+#endif
     
     // 1. 基础边界检查
-    // 如果起始位置已经超出屏幕，直接返回
-    if(x >= plcd->hw->width || y >= plcd->hw->height) return;
+    // 如果起始位置已经超出表面，直接返回
+    if(x >= surf->width || y >= surf->height) return;
+
+    _begin(surf);
+    x += s_ox;
+    y += s_oy;
+    _mark_ram(x, y, x + plcd->font.width - 1, y + plcd->font.height - 1);
 
     // 2. 字符偏移计算
     chr = chr - ' '; 
+
+#if LCD_ANIM_BANDED
+    lcd_scene_char(&s_scene, x, y, &plcd->font.addr[chr * plcd->font.bytes],
+                   plcd->font.width, plcd->font.height,
+                   LCD_PIXEL(plcd->font.front_color), LCD_PIXEL(plcd->font.back_color));
+#else
+    uint16_t front = _gram_value(plcd->font.front_color);
+    uint16_t back  = _gram_value(plcd->font.back_color);
+
+    _erase_rect(x, y, x + plcd->font.width - 1, y + plcd->font.height - 1);
+
     
     // 3. 遍历字库数据的每一个字节
     for(int idx = 0; idx < plcd->font.bytes; idx++) 
@@ -84,17 +291,16 @@ void lcd_show_char_ram(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
             int16_t draw_x = x + width_cnt;
             int16_t draw_y = y + y_offset;
 
-            // 二次边界检查：确保像素没画出屏幕外
-            if (draw_x < plcd->hw->width && draw_y < plcd->hw->height) 
+            // 二次边界检查：确保像素没画出表面外
+            if (draw_x >= s_draw.x1 && draw_x <= s_draw.x2 && draw_y >= s_draw.y1 && draw_y <= s_draw.y2) 
             {
-                uint32_t ram_addr = draw_y * plcd->hw->width + draw_x;
                 uint16_t color_to_write;
 
                 // 判断该位是 0 还是 1
                 if(data & 0x01) {
-                    color_to_write = plcd->font.front_color; // 字体颜色
+                    color_to_write = front; // 字体颜色
                 } else {
-                    color_to_write = plcd->font.back_color;  // 背景颜色
+                    color_to_write = back;  // 背景颜色
                 }
 
                 /* * 【重要】透明背景处理：
@@ -102,11 +308,10 @@ void lcd_show_char_ram(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
                  * 请把下面的 else 分支注释掉！
                  */
                 if (data & 0x01) {
-                    // 大小端交换 (适配 DMA)
-                    g_gram[ram_addr] = (color_to_write << 8) | (color_to_write >> 8);
+                    _gram_put(draw_x, draw_y, color_to_write);
                 } else {
                     // 如果需要背景色，保留这行；如果想要透明，注释掉这行
-                    g_gram[ram_addr] = (color_to_write << 8) | (color_to_write >> 8);
+                    _gram_put(draw_x, draw_y, color_to_write);
                 }
             }
 
@@ -124,22 +329,25 @@ void lcd_show_char_ram(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
             }
         }
     }
+#endif
 }
 
 /**
  * @brief 在 RAM 中显示一个字符串
  */
-void lcd_show_string_ram(lcd* plcd, uint16_t x, uint16_t y, const char *p)
+void lcd_show_string_ram(const lcd_surface* surf, uint16_t x, uint16_t y, const char *p)
 {
+    lcd* plcd = surf->plcd;
+
     while(*p != '\0') {
         // 自动换行检查 (可选)
-        if(x > plcd->hw->width - plcd->font.width) {
+        if(x > surf->width - plcd->font.width) {
             x = 0;
             y += plcd->font.height;
         }
         
         // 画字符
-        lcd_show_char_ram(plcd, x, y, *p++); 
+        lcd_show_char_ram(surf, x, y, *p++); 
         
         // 移动光标
         x += plcd->font.width;
@@ -169,15 +377,137 @@ static void _project_point(Point3D p, Point2D *p2d, float size,
 
 /* --- 公开接口实现 --- */
 
-void lcd_anim_init_buffer(void)
+lcd_surface* lcd_anim_init_buffer(lcd* plcd)
 {
+    uint16_t width = plcd->hw->width, height = plcd->hw->height;
+
+    _clear_sync();
+    if (width > LCD_ANIM_MAX_WIDTH || height > LCD_ANIM_MAX_HEIGHT)
+        return NULL;
+#if LCD_ANIM_BANDED
+    lcd_surface_init(&s_screen, plcd, NULL, 0, width, height, 16);
+    lcd_scene_init(&s_scene, s_prims, LCD_ANIM_PRIMS, width, height);
+#else
+    if (!lcd_surface_init(&s_screen, plcd, (uint8_t *)g_gram, sizeof(g_gram), width, height, LCD_ANIM_BPP))
+        return NULL;
     // 初始化显存为全黑
-    memset(g_gram, 0, sizeof(g_gram));
+    memset(g_gram, 0, (uint32_t)s_screen.stride * height);
+#endif
+#if LCD_ANIM_BPP != 16
+    lcd_palette_init(&s_palette, LCD_ANIM_BPP, !LCD_SPI_16BIT);
+#endif
+    lcd_surface_rect(&s_screen, &s_clip);
+
+    // 面板内容未知, 第一次刷新发送全屏
+    lcd_dirty_init(&s_damage, width, height);
+    lcd_dirty_init(&s_footprint, width, height);
+#if !LCD_ANIM_BANDED
+    lcd_spans_init(&s_erase, s_erase_row, s_erase_count, width, height);
+#endif
+    lcd_anim_invalidate(0, 0, width - 1, height - 1);
+#if !LCD_ANIM_BANDED
+    lcd_tiles_init(&s_tiles, s_screen.stride / 2, height, s_tile_hash);
+    lcd_dlist_init(&s_list);
+#endif
+    return &s_screen;
 }
 
-void lcd_anim_cube_init(lcd_anim_cube_t* anim, lcd* plcd, float size, uint16_t color, int16_t x, int16_t y)
+/**
+ * @brief 清空显存, 上一次清空后画过的区域在下次刷新时发送
+ * @note  LCD_ANIM_CLEAR_SPANS 时只擦除记录下的像素段, 结果与 memset 相同
+ */
+void lcd_anim_clear(void)
 {
-    anim->lcd_handle = plcd;
+#if LCD_ANIM_BANDED
+    lcd_scene_reset(&s_scene);
+#else
+    _clear_sync();
+    if (s_clear_mode == LCD_ANIM_CLEAR_FULL && s_m2m) {
+        s_clearing = lcd_m2m_clear(s_m2m, &s_screen, 0);
+    } else if (s_clear_mode == LCD_ANIM_CLEAR_FULL) {
+        memset(g_gram, 0, (uint32_t)s_screen.stride * s_screen.height);
+    } else {
+        for (int16_t y = s_erase.y1; y <= s_erase.y2; y++)
+            for (uint8_t i = 0; i < s_erase.count[y]; i++)
+                _clear_span(y, s_erase.row[y][i].x1, s_erase.row[y][i].x2);
+        lcd_spans_reset(&s_erase);
+    }
+#endif
+
+    lcd_dirty_merge(&s_damage, &s_footprint);
+    lcd_dirty_reset(&s_footprint);
+}
+
+/**
+ * @brief 标记直接修改过 g_gram 的区域, 下次刷新时发送
+ */
+void lcd_anim_invalidate(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    lcd_dirty_add(&s_damage, x1, y1, x2, y2);
+#if !LCD_ANIM_BANDED
+    // 直接写入的内容也由下次清屏擦除
+    _begin(&s_screen);
+    _erase_rect(x1, y1, x2, y2);
+#endif
+}
+
+void lcd_anim_set_flush_mode(lcd_anim_flush_mode mode)
+{
+    // 切换后第一次刷新发送全屏, 哈希表在这次扫描中建立
+    if (mode != s_flush_mode) {
+#if !LCD_ANIM_BANDED
+        lcd_tiles_invalidate(&s_tiles);
+#endif
+        lcd_anim_invalidate(0, 0, s_screen.width - 1, s_screen.height - 1);
+    }
+    s_flush_mode = mode;
+}
+
+void lcd_anim_set_clear_mode(lcd_anim_clear_mode mode)
+{
+#if !LCD_ANIM_BANDED
+    // 全清期间没有记录像素段, 切换后第一次清屏擦除全屏
+    if (mode == LCD_ANIM_CLEAR_SPANS && s_clear_mode != mode) {
+        s_clear_mode = mode;
+        _begin(&s_screen);
+        _erase_rect(0, 0, s_screen.width - 1, s_screen.height - 1);
+    }
+    s_clear_mode = mode;
+#endif
+}
+
+void lcd_anim_set_m2m(lcd_m2m* m2m)
+{
+#if !LCD_ANIM_BANDED
+    _clear_sync();
+    s_m2m = m2m;
+#endif
+}
+
+void lcd_anim_clear_wait(void)
+{
+    _clear_sync();
+}
+
+void lcd_anim_set_overlay(lcd_overlay* ov)
+{
+    lcd_rect r;
+
+    if (ov == s_overlay) return;
+    // 之前积累的改变包含在全屏中
+    if (ov)
+        lcd_overlay_take_dirty(ov, &r);
+    s_overlay = ov;
+#if !LCD_ANIM_BANDED
+    // 分块模式下全屏由下一次扫描得出
+    lcd_tiles_invalidate(&s_tiles);
+#endif
+    lcd_dirty_add(&s_damage, 0, 0, s_screen.width - 1, s_screen.height - 1);
+}
+
+void lcd_anim_cube_init(lcd_anim_cube_t* anim, const lcd_surface* surf, float size, uint16_t color, int16_t x, int16_t y)
+{
+    anim->surface = surf;
     anim->size = size;
     anim->color = color;
     anim->cx = x;
@@ -186,6 +516,27 @@ void lcd_anim_cube_init(lcd_anim_cube_t* anim, lcd* plcd, float size, uint16_t c
     anim->angX = 0; anim->angY = 0; anim->angZ = 0;
 }
 
+/* --- 按当前角度投影 8 个顶点 --- */
+static void _cube_project(const lcd_anim_cube_t* anim, Point2D* p2d)
+{
+    for(int i=0; i<8; i++) {
+        _project_point(cube_vertices[i], &p2d[i], anim->size,
+                       anim->angX, anim->angY, anim->angZ,
+                       anim->cx, anim->cy);
+    }
+}
+
+/* --- 绘制线框到 RAM --- */
+static void _cube_draw(const lcd_anim_cube_t* anim, const Point2D* p2d)
+{
+    _begin(anim->surface);
+    for (int i = 0; i < 12; i++) {
+        Point2D p1 = p2d[cube_edges[i][0]];
+        Point2D p2 = p2d[cube_edges[i][1]];
+        _draw_line_ram(p1.x, p1.y, p2.x, p2.y, anim->color);
+    }
+}
+
 void lcd_anim_cube_update(lcd_anim_cube_t* anim)
 {
     Point2D p2d[8];
@@ -202,29 +553,21 @@ void lcd_anim_cube_update(lcd_anim_cube_t* anim)
     anim->angZ += anim->speed * 0.3f;
 
     // C. 计算坐标
-    for(int i=0; i<8; i++) {
-        _project_point(cube_vertices[i], &p2d[i], anim->size,
-                       anim->angX, anim->angY, anim->angZ,
-                       anim->cx, anim->cy);
-    }
+    _cube_project(anim, p2d);
 
     // D. 绘制线框到 RAM
-    for (int i = 0; i < 12; i++) {
-        Point2D p1 = p2d[cube_edges[i][0]];
-        Point2D p2 = p2d[cube_edges[i][1]];
-        _draw_line_ram(p1.x, p1.y, p2.x, p2.y, anim->color);
-    }
+    _cube_draw(anim, p2d);
 }
 
 /**
  * @brief 在 RAM 显存中格式化打印字符串
- * @param plcd  LCD 句柄 (包含字体信息)
+ * @param surf  绘制到的表面 (所属面板包含字体信息)
  * @param x     起始 X 坐标
  * @param y     起始 Y 坐标
  * @param fmt   格式化字符串 (如 "FPS: %d")
  * @param ...   参数列表
  */
-void lcd_print_ram(lcd* plcd, uint16_t x, uint16_t y, const char *fmt, ...)
+void lcd_print_ram(const lcd_surface* surf, uint16_t x, uint16_t y, const char *fmt, ...)
 {
     unsigned char buffer[128] = { 0 }; 
     va_list ap;
@@ -233,18 +576,400 @@ void lcd_print_ram(lcd* plcd, uint16_t x, uint16_t y, const char *fmt, ...)
     vsnprintf((char*)buffer, sizeof(buffer), fmt, ap);
     va_end(ap);
 
-    lcd_show_string_ram(plcd, x, y, (const char*)buffer);
+    lcd_show_string_ram(surf, x, y, (const char*)buffer);
+}
+
+#if !LCD_ANIM_BANDED
+/* ============================ 保留模式 ============================ */
+
+/* --- 清空一个重画区域并把绘制裁剪到该区域, r 为 NULL 时恢复全屏 --- */
+static void _redraw_region(void* ctx, const lcd_rect* r)
+{
+    if (!r) {
+        lcd_surface_rect(&s_screen, &s_clip);
+        return;
+    }
+
+    for (int16_t y = r->y1; y <= r->y2; y++)
+        _clear_span(y, r->x1, r->x2);
+    s_clip = *r;
+}
+
+/* --- 设置外包框: 表面坐标裁剪到表面后换算为根表面坐标 --- */
+static void _item_set(lcd_dlist_item* item, const lcd_surface* surf,
+                      int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t key)
+{
+    lcd_rect r = { x1, y1, x2, y2 };
+
+    if (!lcd_surface_clip(surf, &r))
+        r = (lcd_rect){ 0, 0, -1, -1 };
+    lcd_dlist_set(item, r.x1, r.y1, r.x2, r.y2, key);
+}
+
+/* --- 立方体: 外包框为 8 个顶点 (画线多走一步, 各扩 1 像素) --- */
+static void _cube_sync(lcd_anim_cube_t* anim)
+{
+    int16_t x1 = anim->p2d[0].x, y1 = anim->p2d[0].y, x2 = x1, y2 = y1;
+    uint32_t key;
+
+    for (int i = 1; i < 8; i++) {
+        if (anim->p2d[i].x < x1) x1 = anim->p2d[i].x;
+        if (anim->p2d[i].x > x2) x2 = anim->p2d[i].x;
+        if (anim->p2d[i].y < y1) y1 = anim->p2d[i].y;
+        if (anim->p2d[i].y > y2) y2 = anim->p2d[i].y;
+    }
+    key = lcd_dlist_key(LCD_DLIST_KEY_INIT, anim->p2d, sizeof(anim->p2d));
+    key = lcd_dlist_key(key, &anim->color, sizeof(anim->color));
+    _item_set(&anim->item, anim->surface, x1 - 1, y1 - 1, x2 + 1, y2 + 1, key);
+}
+
+static void _cube_draw_item(void* obj)
+{
+    lcd_anim_cube_t* anim = obj;
+
+    _cube_draw(anim, anim->p2d);
 }
 
 /**
- * @brief 将显存中的内容一次性推送到屏幕 (防撕裂关键)
+ * @brief 把立方体加入显示列表 (按当前角度)
  */
-void lcd_anim_flush(lcd* plcd)
+void lcd_anim_cube_add(lcd_anim_cube_t* anim)
 {
-    // 1. 设置全屏窗口
-    lcd_set_address(plcd, 0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
-    
-    // 2. 发送显存数据
-    // 注意：这里 g_gram 已经是交换过大小端的了
-    lcd_write_bulk(plcd->io, (uint8_t*)g_gram, sizeof(g_gram));
+    lcd_dlist_add(&s_list, &anim->item, _cube_draw_item, anim);
+    _cube_project(anim, anim->p2d);
+    _cube_sync(anim);
+}
+
+/**
+ * @brief 转动一步, 只更新显示列表, 由 lcd_anim_update 重画
+ */
+void lcd_anim_cube_step(lcd_anim_cube_t* anim)
+{
+    anim->angX += anim->speed;
+    anim->angY += anim->speed * 0.6f;
+    anim->angZ += anim->speed * 0.3f;
+
+    _cube_project(anim, anim->p2d);
+    _cube_sync(anim);
+}
+
+/* --- 文字: 外包框按 lcd_show_string_ram 的换行规则计算 --- */
+static void _text_sync(lcd_anim_text_t* text)
+{
+    uint16_t width = text->surface->width;
+    uint16_t x = text->x, y = text->y;
+    int16_t x1 = 0, y1 = 0, x2 = -1, y2 = -1;
+    uint32_t key;
+
+    for (const char* p = text->text; *p; p++) {
+        if (x > width - text->font.width) {
+            x = 0;
+            y += text->font.height;
+        }
+        if (x2 < x1) {
+            x1 = x; y1 = y;
+            x2 = x + text->font.width - 1; y2 = y + text->font.height - 1;
+        } else {
+            if (x < x1) x1 = x;
+            if (x + text->font.width - 1 > x2) x2 = x + text->font.width - 1;
+            if (y + text->font.height - 1 > y2) y2 = y + text->font.height - 1;
+        }
+        x += text->font.width;
+    }
+
+    key = lcd_dlist_key(LCD_DLIST_KEY_INIT, text->text, strlen(text->text));
+    key = lcd_dlist_key(key, &text->font.front_color, sizeof(text->font.front_color));
+    key = lcd_dlist_key(key, &text->font.back_color, sizeof(text->font.back_color));
+    key = lcd_dlist_key(key, &text->font.type, sizeof(text->font.type));
+    _item_set(&text->item, text->surface, x1, y1, x2, y2, key);
+}
+
+static void _text_draw_item(void* obj)
+{
+    lcd_anim_text_t* text = obj;
+    lcd* plcd = text->surface->plcd;
+    lcd_font font = plcd->font;
+
+    plcd->font = text->font;
+    lcd_show_string_ram(text->surface, text->x, text->y, text->text);
+    plcd->font = font;
+}
+
+/**
+ * @brief 加入一段文字, 字体与颜色取 surf 所属面板当前的设置, 内容为空
+ */
+void lcd_anim_text_add(lcd_anim_text_t* text, const lcd_surface* surf, uint16_t x, uint16_t y)
+{
+    text->surface = surf;
+    text->font = surf->plcd->font;
+    text->x = x;
+    text->y = y;
+    text->text[0] = '\0';
+
+    lcd_dlist_add(&s_list, &text->item, _text_draw_item, text);
+    _text_sync(text);
+}
+
+/**
+ * @brief 格式化设置文字内容, 与上一帧相同时不产生重画
+ */
+void lcd_anim_text_printf(lcd_anim_text_t* text, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(text->text, sizeof(text->text), fmt, ap);
+    va_end(ap);
+
+    _text_sync(text);
+}
+
+void lcd_anim_text_move(lcd_anim_text_t* text, uint16_t x, uint16_t y)
+{
+    text->x = x;
+    text->y = y;
+    _text_sync(text);
+}
+
+void lcd_anim_text_color(lcd_anim_text_t* text, uint16_t front, uint16_t back)
+{
+    text->font.front_color = front;
+    text->font.back_color = back;
+    _text_sync(text);
+}
+
+/* --- 线段/实心矩形 --- */
+static void _shape_draw_item(void* obj)
+{
+    lcd_anim_shape_t* shape = obj;
+
+    _begin(shape->surface);
+    if (!shape->fill) {
+        _draw_line_ram(shape->x1, shape->y1, shape->x2, shape->y2, shape->color);
+        return;
+    }
+    for (int16_t y = shape->y1 + s_oy; y <= shape->y2 + s_oy; y++)
+        for (int16_t x = shape->x1 + s_ox; x <= shape->x2 + s_ox; x++)
+            _plot_ram(x, y, shape->color);
+    _mark_ram(shape->x1 + s_ox, shape->y1 + s_oy, shape->x2 + s_ox, shape->y2 + s_oy);
+}
+
+void lcd_anim_shape_set(lcd_anim_shape_t* shape, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    int16_t pad = shape->fill ? 0 : 1;
+    uint32_t key;
+
+    // 矩形按左上/右下保存; 线段保留方向, 画线起点不同时像素可能不同
+    if (shape->fill && x1 > x2) { int16_t t = x1; x1 = x2; x2 = t; }
+    if (shape->fill && y1 > y2) { int16_t t = y1; y1 = y2; y2 = t; }
+    shape->x1 = x1; shape->y1 = y1;
+    shape->x2 = x2; shape->y2 = y2;
+    shape->color = color;
+
+    key = lcd_dlist_key(LCD_DLIST_KEY_INIT, &shape->x1, sizeof(int16_t) * 4);
+    key = lcd_dlist_key(key, &shape->color, sizeof(shape->color));
+    _item_set(&shape->item, shape->surface, (x1 < x2 ? x1 : x2) - pad, (y1 < y2 ? y1 : y2) - pad,
+                  (x1 > x2 ? x1 : x2) + pad, (y1 > y2 ? y1 : y2) + pad, key);
+}
+
+void lcd_anim_line_add(lcd_anim_shape_t* shape, const lcd_surface* surf, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    shape->surface = surf;
+    shape->fill = false;
+    lcd_dlist_add(&s_list, &shape->item, _shape_draw_item, shape);
+    lcd_anim_shape_set(shape, x1, y1, x2, y2, color);
+}
+
+void lcd_anim_rect_add(lcd_anim_shape_t* shape, const lcd_surface* surf, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    shape->surface = surf;
+    shape->fill = true;
+    lcd_dlist_add(&s_list, &shape->item, _shape_draw_item, shape);
+    lcd_anim_shape_set(shape, x1, y1, x2, y2, color);
+}
+
+void lcd_anim_remove(lcd_dlist_item* item)
+{
+    lcd_dlist_remove(&s_list, item);
+}
+
+/**
+ * @brief 与上一帧比较显示列表, 在显存中清空并重画改变的区域, 下次 lcd_anim_flush 时发送
+ */
+void lcd_anim_update(void)
+{
+    lcd_dirty damage;
+
+    _clear_sync();
+    lcd_dirty_init(&damage, s_screen.width, s_screen.height);
+    lcd_dlist_diff(&s_list, &damage);
+
+    s_redraw = true;
+    lcd_dlist_render(&s_list, &damage, _redraw_region, NULL);
+    s_redraw = false;
+
+    lcd_dirty_merge(&s_damage, &damage);
+}
+#endif
+
+#if LCD_ANIM_BANDED
+static void _band_gen(void* arg, uint16_t row, uint16_t rows, uint16_t* buf, uint16_t width)
+{
+    uint16_t y = *(uint16_t *)arg + row;
+    lcd_rect band = { 0, y, width - 1, y + rows - 1 };
+
+    lcd_scene_raster(&s_scene, y, rows, buf);
+    if (s_overlay && lcd_overlay_hit(s_overlay, &band)) {
+        for (uint16_t i = 0; i < rows; i++)
+            lcd_overlay_blend(s_overlay, 0, y + i, buf + (uint32_t)i * width, width, LCD_PIXEL(s_overlay->color));
+    }
+}
+
+static void _band_write(void* ctx, uint8_t* data, uint32_t len)
+{
+    lcd_write_pixels_async(ctx, (const uint16_t *)data, len / 2);
+}
+
+static void _band_wait(void* ctx)
+{
+    lcd_write_wait(ctx);
+}
+
+/* --- 条带模式: 改变区域所在的行整行重画, 一条在发送时光栅化下一条 --- */
+static void _flush_bands(lcd* plcd)
+{
+    uint16_t width = s_screen.width;
+    uint16_t y1 = s_screen.height, y2 = 0;
+    lcd_stream stream = {
+        .buf   = { s_band[0], s_band[1] },
+        .ctx   = plcd->io,
+        .write = _band_write,
+        .wait  = _band_wait,
+    };
+
+    for (uint8_t i = 0; i < s_damage.count; i++) {
+        if (s_damage.rect[i].y1 < y1) y1 = s_damage.rect[i].y1;
+        if (s_damage.rect[i].y2 > y2) y2 = s_damage.rect[i].y2;
+    }
+
+    lcd_set_address(plcd, 0, y1, width - 1, y2);
+    lcd_stream_bands(&stream, width, y2 - y1 + 1, LCD_ANIM_BAND_LINES, _band_gen, &y1);
+    lcd_window_advance(&plcd->window, (uint32_t)width * (y2 - y1 + 1));
+}
+#else
+#if LCD_ANIM_BPP != 16
+/* --- 展开矩形中的一行: 调色板索引 -> 行缓冲 --- */
+static void _expand_line(void* arg, uint16_t row, uint16_t* line, uint16_t width)
+{
+    const lcd_rect* r = arg;
+    const uint8_t* src = s_screen.pixels + (uint32_t)(r->y1 + row) * s_screen.stride;
+
+#if LCD_ANIM_BPP == 8
+    lcd_palette_expand8(&s_palette, src, r->x1, line, width);
+#else
+    lcd_palette_expand4(&s_palette, src, r->x1, line, width);
+#endif
+    if (s_blend)
+        lcd_overlay_blend(s_blend, r->x1, r->y1 + row, line, width, LCD_PIXEL(s_blend->color));
+}
+
+/* --- 发送一个矩形: 逐行展开, 一行在发送时展开下一行 --- */
+static void _flush_rect(lcd* plcd, const lcd_rect* r)
+{
+    s_blend = s_overlay && lcd_overlay_hit(s_overlay, r) ? s_overlay : NULL;
+    lcd_draw_lines(plcd, r->x1, r->y1, r->x2 - r->x1 + 1, r->y2 - r->y1 + 1,
+                   _expand_line, (void *)r);
+}
+#else
+/* --- 复制矩形中的一行到行缓冲并合成覆盖层 --- */
+static void _blend_line(void* arg, uint16_t row, uint16_t* line, uint16_t width)
+{
+    const lcd_rect* r = arg;
+    const uint16_t* src = (const uint16_t *)(s_screen.pixels + (uint32_t)(r->y1 + row) * s_screen.stride) + r->x1;
+
+    memcpy(line, src, (uint32_t)width * 2);
+    lcd_overlay_blend(s_blend, r->x1, r->y1 + row, line, width, LCD_PIXEL(s_blend->color));
+}
+
+/* --- 发送一个矩形: 整行宽度时显存连续, 否则逐行发送; 与覆盖层相交时经行缓冲合成 --- */
+static void _flush_rect(lcd* plcd, const lcd_rect* r)
+{
+    uint16_t w = r->x2 - r->x1 + 1;
+    uint16_t h = r->y2 - r->y1 + 1;
+
+    if (s_overlay && lcd_overlay_hit(s_overlay, r)) {
+        s_blend = s_overlay;
+        lcd_draw_lines(plcd, r->x1, r->y1, w, h, _blend_line, (void *)r);
+        return;
+    }
+
+    lcd_set_address(plcd, r->x1, r->y1, r->x2, r->y2);
+
+    // 注意：这里 g_gram 已经是 LCD_PIXEL 格式
+    if (w * 2 == s_screen.stride) {
+        lcd_write_pixels_async(plcd->io, (const uint16_t *)(s_screen.pixels + (uint32_t)r->y1 * s_screen.stride),
+                               (uint32_t)w * h);
+    } else {
+        for (uint16_t y = r->y1; y <= r->y2; y++)
+            lcd_write_pixels_async(plcd->io, (const uint16_t *)(s_screen.pixels + (uint32_t)y * s_screen.stride) + r->x1, w);
+    }
+    lcd_window_advance(&plcd->window, (uint32_t)w * h);
+}
+#endif
+
+/* --- 分块扫描的输出: 一行中连续改变的块 (坐标以 uint16_t 为单位, 换算为像素) --- */
+static void _tile_span(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    lcd_dirty_add((lcd_dirty *)ctx, x1 * GRAM_PER_WORD, y1, x2 * GRAM_PER_WORD + GRAM_PER_WORD - 1, y2);
+}
+#endif
+
+/**
+ * @brief 将显存中改变过的区域推送到屏幕 (防撕裂关键)
+ * @note  DMA 异步发送, 修改 g_gram 前需调用 lcd_anim_flush_wait
+ */
+void lcd_anim_flush(const lcd_surface* surf)
+{
+    lcd* plcd = surf->plcd;
+
+    _clear_sync();
+#if !LCD_ANIM_BANDED
+    // 分块模式下改为由哈希比较得出改变的区域 (上下相邻的段在 lcd_dirty_add 中合并)
+    if (s_flush_mode == LCD_ANIM_FLUSH_TILES) {
+        lcd_dirty_reset(&s_damage);
+        lcd_tiles_scan(&s_tiles, g_gram, s_tile_ops, &s_tile_ctx, _tile_span, &s_damage);
+    }
+#endif
+    // 覆盖层不在显存中, 它的改变另外计入
+    if (s_overlay) {
+        lcd_rect r;
+
+        if (lcd_overlay_take_dirty(s_overlay, &r))
+            lcd_dirty_add(&s_damage, r.x1, r.y1, r.x2, r.y2);
+    }
+    if (!s_damage.count) return;
+
+    // 0. 打开了 TE 同步时等待刷新窗口
+    lcd_io_vsync_begin(plcd->io);
+
+    // 1. 逐个发送脏矩形 (事务在 DMA 完成后才释放总线)
+    lcd_io_begin(plcd->io);
+#if LCD_ANIM_BANDED
+    _flush_bands(plcd);
+#else
+    for (uint8_t i = 0; i < s_damage.count; i++)
+        _flush_rect(plcd, &s_damage.rect[i]);
+#endif
+    lcd_io_end(plcd->io);
+    lcd_io_vsync_end(plcd->io);
+
+    lcd_dirty_reset(&s_damage);
+}
+
+/**
+ * @brief 等待显存推送完成, 等待期间任务让出 CPU
+ */
+void lcd_anim_flush_wait(const lcd_surface* surf)
+{
+    lcd_write_wait(surf->plcd->io);
 }
\ No newline at end of file
@@ -2,21 +2,74 @@
 #define __LCD_ANIM_H__
 
 #include "lcd.h"
+#include "lcd_dirty.h"
+#include "lcd_scene.h"
+#include "lcd_palette.h"
+#include "lcd_dlist.h"
+#include "lcd_span.h"
+#include "lcd_surface.h"
+#include "lcd_m2m.h"
+#include "lcd_overlay.h"
+#include "lcd_tile.h"
 #include <math.h>
 #include <string.h>
 
 /* --- 配置参数 --- */
-#define LCD_WIDTH   240
-#define LCD_HEIGHT  135
+/* 屏幕尺寸在 lcd_anim_init_buffer 时取自面板; 以下只决定各表格的容量,
+ * 默认按最大的 1.47" 屏 (320 x 172, 竖屏 172 x 320) */
+#ifndef LCD_ANIM_MAX_WIDTH
+#define LCD_ANIM_MAX_WIDTH  320
+#endif
+#ifndef LCD_ANIM_MAX_HEIGHT
+#define LCD_ANIM_MAX_HEIGHT 320
+#endif
+
+/* 条带渲染: 不分配整帧显存, 绘制函数只记录图元, 刷新时逐条光栅化发送 */
+#ifndef LCD_ANIM_BANDED
+#define LCD_ANIM_BANDED     0
+#endif
+#ifndef LCD_ANIM_BAND_LINES
+#define LCD_ANIM_BAND_LINES 16      // 每条行数, 两个条带缓冲共 LCD_ANIM_MAX_WIDTH * 行数 * 4 Bytes
+#endif
+#ifndef LCD_ANIM_PRIMS
+#define LCD_ANIM_PRIMS      64      // 每帧最多图元数 (线段/字符)
+#endif
+
+/* 显存格式: 16 为 RGB565; 8/4 为调色板索引, 刷新时逐行查表展开到行缓冲 */
+#ifndef LCD_ANIM_BPP
+#define LCD_ANIM_BPP        16
+#endif
+
+/* 显存字节数, 默认放得下 1.14" 屏 (240 x 135);
+ * 1.47" 屏 16 位需 110,080 Bytes, 超出 F411 的内存, 可改用 8/4 位或条带渲染 */
+#ifndef LCD_ANIM_GRAM_BYTES
+#define LCD_ANIM_GRAM_BYTES (LCD_SURFACE_STRIDE(240, LCD_ANIM_BPP) * 135)
+#endif
+
+#if LCD_ANIM_BANDED && LCD_ANIM_BPP != 16
+#error "LCD_ANIM_BANDED requires LCD_ANIM_BPP 16"
+#endif
 
 /* --- 数据结构 --- */
+/* 刷新方式: 按绘制时记录的脏矩形, 或按分块哈希比较显存内容 */
+typedef enum {
+    LCD_ANIM_FLUSH_DIRTY = 0,
+    LCD_ANIM_FLUSH_TILES,
+} lcd_anim_flush_mode;
+
+/* 清屏方式: 只擦除上次清屏后画过的像素段 (默认), 或 memset 整个显存 */
+typedef enum {
+    LCD_ANIM_CLEAR_SPANS = 0,
+    LCD_ANIM_CLEAR_FULL,
+} lcd_anim_clear_mode;
+
 typedef struct { float x, y, z; } Point3D;
 typedef struct { int16_t x, y; } Point2D;
 
 /* 立方体动画对象 */
 typedef struct {
-    // 关联的 LCD 句柄
-    lcd* lcd_handle;
+    // 绘制到的表面 (坐标相对于表面左上角)
+    const lcd_surface* surface;
     
     // 属性
     float size;         // 大小
@@ -26,27 +79,99 @@ typedef struct {
 
     // 内部状态
     float angX, angY, angZ;
+
+    // 保留模式
+    lcd_dlist_item item;
+    Point2D p2d[8];     // 上一次 lcd_anim_cube_step 的投影结果
 } lcd_anim_cube_t;
 
+/* 保留模式文字, 内容/位置/颜色改变时才重画 */
+typedef struct {
+    lcd_dlist_item item;
+    const lcd_surface* surface;
+    lcd_font font;      // 加入时复制 surface->plcd->font, 可用 lcd_anim_text_color 修改颜色
+    uint16_t x, y;
+    char text[32];
+} lcd_anim_text_t;
+
+/* 保留模式线段/实心矩形 */
+typedef struct {
+    lcd_dlist_item item;
+    const lcd_surface* surface;
+    int16_t x1, y1, x2, y2;
+    uint16_t color;
+    bool fill;
+} lcd_anim_shape_t;
+
 /* --- 函数接口 --- */
 
 /**
- * @brief 初始化动画模块 (分配/清空显存)
+ * @brief 按面板当前的尺寸初始化动画模块 (清空显存)
+ * @return 整个屏幕的根表面, 可再用 lcd_surface_view 划出子视图;
+ *         尺寸超出 LCD_ANIM_MAX_* 或 LCD_ANIM_GRAM_BYTES 时返回 NULL
  */
-void lcd_anim_init_buffer(void);
+lcd_surface* lcd_anim_init_buffer(lcd* plcd);
+
+/**
+ * @brief 清空显存 (只有画过的区域会在下次刷新时发送)
+ */
+void lcd_anim_clear(void);
+void lcd_anim_invalidate(int16_t x1, int16_t y1, int16_t x2, int16_t y2);  // 根表面坐标
+
+/**
+ * @brief 选择刷新方式; 分块哈希模式不依赖绘制函数记录, 直接修改 g_gram 也能发现
+ * @note  条带渲染时没有 g_gram, 只按脏矩形所在的行刷新
+ */
+void lcd_anim_set_flush_mode(lcd_anim_flush_mode mode);
+void lcd_anim_set_clear_mode(lcd_anim_clear_mode mode);
+
+/**
+ * @brief 设置后 LCD_ANIM_CLEAR_FULL 的清屏交给 m2m 异步完成 (NULL 恢复 memset),
+ *        清屏期间 CPU 可以先做投影等计算, 第一次绘制/刷新时才等待
+ * @note  按像素段清屏都是短段, 仍由 CPU 完成; 直接修改 g_gram 前需调用 lcd_anim_clear_wait
+ */
+void lcd_anim_set_m2m(lcd_m2m* m2m);
+void lcd_anim_clear_wait(void);
+
+/* 以下绘制函数的坐标都相对于 surf 的左上角, 超出 surf 的部分被裁掉;
+ * 对象保存表面指针, 表面 (视图) 需在对象使用期间保持有效 */
 
 /**
  * @brief 初始化一个立方体
  */
-void lcd_anim_cube_init(lcd_anim_cube_t* anim, lcd* plcd, float size, uint16_t color, int16_t x, int16_t y);
+void lcd_anim_cube_init(lcd_anim_cube_t* anim, const lcd_surface* surf, float size, uint16_t color, int16_t x, int16_t y);
 
 /**
  * @brief 核心函数：
- * 1. 清空显存
- * 2. 计算并绘制立方体到显存
+ * 1. 推进角度, 计算投影
+ * 2. 绘制线框到显存, 记录改变的区域 (不清空显存, 每帧先调用 lcd_anim_clear)
+ * @note  不发送; 由 lcd_anim_flush 异步发送, 上一次发送可能未完成时先调用 lcd_anim_flush_wait
  */
 void lcd_anim_cube_update(lcd_anim_cube_t* anim);
-void lcd_print_ram(lcd* plcd, uint16_t x, uint16_t y, const char *fmt, ...);
-void lcd_anim_flush(lcd* plcd);
+void lcd_show_char_ram(const lcd_surface* surf, uint16_t x, uint16_t y, uint16_t chr);
+void lcd_show_string_ram(const lcd_surface* surf, uint16_t x, uint16_t y, const char *p);
+void lcd_print_ram(const lcd_surface* surf, uint16_t x, uint16_t y, const char *fmt, ...);
+/* 发送整个根表面中改变的区域到 surf 所属的面板 */
+void lcd_anim_flush(const lcd_surface* surf);
+/* 1 位覆盖层, 刷新时合成到发送的每一行, 不写入显存; 尺寸与根表面相同, NULL 时取消
+ * 覆盖层的改变由 lcd_overlay_take_dirty 取走计入发送区域, 设置/取消时发送全屏 */
+void lcd_anim_set_overlay(lcd_overlay* ov);
+
+/* --- 保留模式: 对象注册一次, 之后只修改属性 ---
+ * lcd_anim_update 与上一帧比较, 只清空并重画改变的区域, 然后由 lcd_anim_flush 发送;
+ * 使用保留模式时不要再调用 lcd_anim_clear. 条带渲染 (LCD_ANIM_BANDED) 下不可用 */
+void lcd_anim_cube_add(lcd_anim_cube_t* anim);
+void lcd_anim_cube_step(lcd_anim_cube_t* anim);
+void lcd_anim_text_add(lcd_anim_text_t* text, const lcd_surface* surf, uint16_t x, uint16_t y);
+void lcd_anim_text_printf(lcd_anim_text_t* text, const char *fmt, ...);
+void lcd_anim_text_move(lcd_anim_text_t* text, uint16_t x, uint16_t y);
+void lcd_anim_text_color(lcd_anim_text_t* text, uint16_t front, uint16_t back);
+void lcd_anim_line_add(lcd_anim_shape_t* shape, const lcd_surface* surf, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+void lcd_anim_rect_add(lcd_anim_shape_t* shape, const lcd_surface* surf, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+void lcd_anim_shape_set(lcd_anim_shape_t* shape, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+/* item 为对象中的 item 成员; 对象内存需保留到下一次 lcd_anim_update */
+void lcd_anim_remove(lcd_dlist_item* item);
+void lcd_anim_update(void);
+void lcd_anim_flush_wait(const lcd_surface* surf);
 
 #endif
\ No newline at end of file
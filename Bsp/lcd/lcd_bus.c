@@ -0,0 +1,54 @@
+#include "lcd_bus.h"
+
+void lcd_bus_init(lcd_bus* bus)
+{
+    bus->owner = 0;
+    bus->wait  = 0;
+}
+
+/* 总线空闲时立即占用并返回 true, 否则按优先级排队并返回 false;
+   排队的设备在 lcd_bus_release 中被移交总线 */
+bool lcd_bus_acquire(lcd_bus* bus, lcd_bus_dev* dev)
+{
+    lcd_bus_dev** pos = &bus->wait;
+
+    if(!bus->owner || bus->owner == dev) {
+        bus->owner = dev;
+        return true;
+    }
+
+    /* 已在队列中 */
+    for(lcd_bus_dev* it = bus->wait; it; it = it->next) {
+        if(it == dev)
+            return false;
+    }
+
+    while(*pos && (*pos)->priority >= dev->priority)
+        pos = &(*pos)->next;
+    dev->next = *pos;
+    *pos = dev;
+
+    return false;
+}
+
+/* 结束事务, 总线直接移交给队首设备并返回它 (调用者负责唤醒), 无人等待时返回 NULL */
+lcd_bus_dev* lcd_bus_release(lcd_bus* bus, lcd_bus_dev* dev)
+{
+    lcd_bus_dev* next = bus->wait;
+
+    if(bus->owner != dev)
+        return 0;
+
+    if(next) {
+        bus->wait  = next->next;
+        next->next = 0;
+    }
+    bus->owner = next;
+
+    return next;
+}
+
+bool lcd_bus_owned(const lcd_bus* bus, const lcd_bus_dev* dev)
+{
+    return bus->owner == dev;
+}
@@ -0,0 +1,26 @@
+/*
+ * @Describe: 共享 SPI 总线的事务排队
+ */
+#ifndef __LCD_BUS_H
+#define __LCD_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct __lcd_bus_dev {
+    struct __lcd_bus_dev* next; // 等待队列链接
+    uint8_t priority;           // 数值越大越先获得总线, 同优先级先到先得
+    void* task;                 // 等待总线的任务, 由移植层使用
+} lcd_bus_dev;
+
+typedef struct __lcd_bus {
+    lcd_bus_dev* owner;         // 当前事务的持有者, NULL 表示空闲
+    lcd_bus_dev* wait;          // 按优先级排序的等待队列
+} lcd_bus;
+
+void lcd_bus_init(lcd_bus* bus);
+bool lcd_bus_acquire(lcd_bus* bus, lcd_bus_dev* dev);
+lcd_bus_dev* lcd_bus_release(lcd_bus* bus, lcd_bus_dev* dev);
+bool lcd_bus_owned(const lcd_bus* bus, const lcd_bus_dev* dev);
+
+#endif
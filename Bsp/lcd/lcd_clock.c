@@ -0,0 +1,35 @@
+#include "lcd_clock.h"
+
+/* APB 时钟 = SystemCoreClock (AHB 不分频) / APB 分频系数 */
+uint32_t lcd_clock_pclk(uint32_t sysclk, uint8_t apb_div)
+{
+    return apb_div ? sysclk / apb_div : sysclk;
+}
+
+/* 不超过 target 的最小分频对应的 BR 位; target 过低时取最大分频 */
+uint8_t lcd_clock_br(uint32_t pclk, uint32_t target)
+{
+    uint8_t br = 0;
+
+    while(br < LCD_CLK_BR_MAX && lcd_clock_hz(pclk, br) > target)
+        br++;
+
+    return br;
+}
+
+uint32_t lcd_clock_hz(uint32_t pclk, uint8_t br)
+{
+    return pclk >> (br + 1);
+}
+
+void lcd_clock_profile_make(lcd_clock_profile* profile, uint32_t pclk,
+                            const lcd_clock_cfg* cfg)
+{
+    for(int i = 0; i < LCD_CLK_PHASES; i++) {
+        uint32_t target = cfg->hz[i];
+
+        if(cfg->spi_max && target > cfg->spi_max)
+            target = cfg->spi_max;
+        profile->br[i] = lcd_clock_br(pclk, target);
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * @Describe: SPI 时钟分档
+ */
+#ifndef __LCD_CLOCK_H
+#define __LCD_CLOCK_H
+
+#include <stdint.h>
+
+/* 各阶段目标 SCK, 实际频率取不超过目标的最高档 */
+#ifndef LCD_CLK_INIT_HZ
+#define LCD_CLK_INIT_HZ     10000000U   // 复位/初始化序列, 保守
+#endif
+#ifndef LCD_CLK_CMD_HZ
+#define LCD_CLK_CMD_HZ      25000000U   // 窗口等命令
+#endif
+#ifndef LCD_CLK_PIXEL_HZ
+#define LCD_CLK_PIXEL_HZ    62500000U   // RAMWR 像素数据, ST7789 写周期最小 16ns
+#endif
+#ifndef LCD_CLK_READ_HZ
+#define LCD_CLK_READ_HZ     6000000U    // RAMRD 等读操作, ST7789 读周期最小 150ns
+#endif
+
+/* BR[2:0] 取值范围, fSCK = fPCLK / 2^(BR+1) */
+#define LCD_CLK_BR_MAX      7
+
+typedef enum {
+    LCD_CLK_INIT = 0,
+    LCD_CLK_CMD,
+    LCD_CLK_PIXEL,
+    LCD_CLK_READ,
+    LCD_CLK_PHASES,
+} lcd_clk_phase;
+
+typedef struct __lcd_clock_cfg {
+    uint32_t hz[LCD_CLK_PHASES];    // 各阶段目标 SCK
+    uint32_t spi_max;               // SPI 外设允许的最高 SCK, 0 表示不限制
+} lcd_clock_cfg;
+
+typedef struct __lcd_clock_profile {
+    uint8_t br[LCD_CLK_PHASES];     // 各阶段 BR 位
+} lcd_clock_profile;
+
+uint32_t lcd_clock_pclk(uint32_t sysclk, uint8_t apb_div);
+uint8_t lcd_clock_br(uint32_t pclk, uint32_t target);
+uint32_t lcd_clock_hz(uint32_t pclk, uint8_t br);
+void lcd_clock_profile_make(lcd_clock_profile* profile, uint32_t pclk,
+                            const lcd_clock_cfg* cfg);
+
+#endif
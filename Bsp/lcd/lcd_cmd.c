@@ -0,0 +1,66 @@
+#include <assert.h>
+#include "lcd_cmd.h"
+
+/* 放不下或没有打开的命令包是调用错误: 截断后发送的命令包格式错误, 不能静默丢弃 */
+static bool lcd_cmd_check(bool ok)
+{
+    assert(ok);
+    return ok;
+}
+
+void lcd_cmd_reset(lcd_cmd_queue* queue)
+{
+    queue->used = 0;
+    queue->last = 0;
+}
+
+/* 开始一个新命令包 */
+bool lcd_cmd_begin(lcd_cmd_queue* queue, uint8_t cmd)
+{
+    if(!lcd_cmd_check(queue->used + 2 <= LCD_CMD_QUEUE_SIZE))
+        return false;
+
+    queue->buf[queue->used++] = cmd;
+    queue->last = queue->used;
+    queue->buf[queue->used++] = 0;
+    return true;
+}
+
+/* 向当前命令包追加参数 */
+bool lcd_cmd_param(lcd_cmd_queue* queue, uint8_t data)
+{
+    if(!lcd_cmd_check(queue->used && queue->used + 1 <= LCD_CMD_QUEUE_SIZE))
+        return false;
+
+    queue->buf[queue->used++] = data;
+    queue->buf[queue->last]++;
+    return true;
+}
+
+/* 16 位参数, 高字节在前 */
+bool lcd_cmd_param16(lcd_cmd_queue* queue, uint16_t data)
+{
+    if(!lcd_cmd_check(queue->used + 2 <= LCD_CMD_QUEUE_SIZE))
+        return false;
+
+    return lcd_cmd_param(queue, data >> 8) && lcd_cmd_param(queue, data & 0xff);
+}
+
+/* 每个命令包只发送两段: 命令字节 + 全部参数, 发送后清空队列 */
+void lcd_cmd_flush(lcd_cmd_queue* queue, lcd_cmd_emit emit, void* ctx)
+{
+    uint16_t pos = 0;
+
+    while(pos + 2 <= queue->used) {
+        const uint8_t* cmd = &queue->buf[pos];
+        uint8_t len = queue->buf[pos + 1];
+
+        emit(ctx, false, cmd, 1);
+        if(len)
+            emit(ctx, true, &queue->buf[pos + 2], len);
+
+        pos += 2 + len;
+    }
+
+    lcd_cmd_reset(queue);
+}
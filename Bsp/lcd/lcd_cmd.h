@@ -0,0 +1,29 @@
+/*
+ * @Describe: LCD 命令包打包与批量发送
+ */
+#ifndef __LCD_CMD_H
+#define __LCD_CMD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 驱动中最长的序列: 0.96" gamma 设置 18 字节, 窗口 + 画点 16 字节; 超出时断言失败 */
+#define LCD_CMD_QUEUE_SIZE  48
+
+/* 命令队列: 依次存放 [命令][参数个数][参数...] */
+typedef struct __lcd_cmd_queue {
+    uint8_t buf[LCD_CMD_QUEUE_SIZE];
+    uint16_t used;
+    uint16_t last;      // 当前命令包参数个数所在位置
+} lcd_cmd_queue;
+
+/* 发送回调: dc=false 为命令, dc=true 为参数, 一次调用发送一段连续数据 */
+typedef void (*lcd_cmd_emit)(void* ctx, bool dc, const uint8_t* data, uint32_t len);
+
+void lcd_cmd_reset(lcd_cmd_queue* queue);
+bool lcd_cmd_begin(lcd_cmd_queue* queue, uint8_t cmd);
+bool lcd_cmd_param(lcd_cmd_queue* queue, uint8_t data);
+bool lcd_cmd_param16(lcd_cmd_queue* queue, uint16_t data);
+void lcd_cmd_flush(lcd_cmd_queue* queue, lcd_cmd_emit emit, void* ctx);
+
+#endif
@@ -0,0 +1,107 @@
+#include "lcd_console.h"
+
+/* printf 输出的控制台, NULL 时丢弃 */
+static lcd_console* lcd_console_out;
+
+static void lcd_console_send(lcd_console* con, lcd_cmd_queue* queue)
+{
+    if(queue->used)
+        lcd_write_cmds(con->plcd->io, queue);
+}
+
+/* 清除 y 处的文本行 */
+static void lcd_console_clear_line(lcd_console* con, uint16_t y)
+{
+    lcd* plcd = con->plcd;
+
+    lcd_fill(plcd, 0, y, plcd->hw->width - 1, y + con->scroll.line_h - 1,
+             plcd->font.back_color);
+}
+
+/******************************************************************************
+      函数说明：初始化控制台, 清屏并定义滚动区
+      注意：    垂直滚动沿面板的扫描方向, 只支持竖屏 LCD_ROTATE_0;
+                其他方向返回 false
+******************************************************************************/
+bool lcd_console_init(lcd_console* con, lcd* plcd)
+{
+    lcd_cmd_queue queue = { 0 };
+
+    if(plcd->hw->rotate != LCD_ROTATE_0)
+        return false;
+    if(!lcd_scroll_init(&con->scroll, plcd->offset[2], plcd->hw->height, plcd->font.height))
+        return false;
+
+    con->plcd = plcd;
+    con->col  = 0;
+    con->cols = plcd->hw->width / plcd->font.width;
+
+    lcd_clear(plcd, plcd->font.back_color);
+    lcd_scroll_define(&con->scroll, &queue);
+
+    lcd_io_begin(plcd->io);
+    lcd_console_send(con, &queue);
+    lcd_io_end(plcd->io);
+
+    return true;
+}
+
+/* 换行: 屏幕已满时只发送 0x37, 然后清除滚入的那一行 */
+static void lcd_console_newline(lcd_console* con)
+{
+    lcd_cmd_queue queue = { 0 };
+    uint16_t y = lcd_scroll_newline(&con->scroll, &queue);
+
+    lcd_io_begin(con->plcd->io);
+    lcd_console_send(con, &queue);
+    lcd_console_clear_line(con, y);
+    lcd_io_end(con->plcd->io);
+
+    con->col = 0;
+}
+
+void lcd_console_putc(lcd_console* con, char c)
+{
+    lcd* plcd = con->plcd;
+
+    switch(c) {
+    case '\n':
+        lcd_console_newline(con);
+        return;
+    case '\r':
+        con->col = 0;
+        return;
+    default:
+        break;
+    }
+
+    if(c < ' ' || c > '~')
+        return;
+
+    if(con->col >= con->cols)
+        lcd_console_newline(con);
+
+    lcd_show_char(plcd, con->col * plcd->font.width, lcd_scroll_cursor_y(&con->scroll), c);
+    con->col++;
+}
+
+void lcd_console_write(lcd_console* con, const char* str, uint32_t len)
+{
+    lcd_io_begin(con->plcd->io);
+    while(len--)
+        lcd_console_putc(con, *str++);
+    lcd_io_end(con->plcd->io);
+}
+
+/* 绑定 printf 输出的控制台, 必须在任务中使用 (不能在中断中 printf) */
+void lcd_console_stdout(lcd_console* con)
+{
+    lcd_console_out = con;
+}
+
+int lcd_console_putchar(int ch)
+{
+    if(lcd_console_out)
+        lcd_console_putc(lcd_console_out, (char)ch);
+    return ch;
+}
@@ -0,0 +1,34 @@
+/*
+ * @Describe: 基于硬件垂直滚动的文本控制台
+ */
+#ifndef __LCD_CONSOLE_H
+#define __LCD_CONSOLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lcd.h"
+#include "lcd_scroll.h"
+
+typedef struct __lcd_console {
+    lcd* plcd;
+    lcd_scroll scroll;
+    uint16_t col;       // 当前列 (字符)
+    uint16_t cols;      // 每行字符数
+} lcd_console;
+
+bool lcd_console_init(lcd_console* con, lcd* plcd);
+void lcd_console_putc(lcd_console* con, char c);
+void lcd_console_write(lcd_console* con, const char* str, uint32_t len);
+
+/****** 标准输出 (syscalls.c 的 __io_putchar) ******/
+/* 默认关闭: printf 会在调用它的任务中直接驱动面板, 与其他绘制任务共用 lcd 时需由调用者保证互斥;
+   定义为 1 后由 lcd_console_putchar 提供 __io_putchar */
+#ifndef LCD_CONSOLE_STDOUT
+#define LCD_CONSOLE_STDOUT  0
+#endif
+
+void lcd_console_stdout(lcd_console* con);
+int lcd_console_putchar(int ch);
+
+#endif
@@ -27,7 +27,8 @@ lcd_hw lcd_hw_1_47 = {
     .height = 172,
 };
 
-lcd_hw* lcd_hw_desc[] = {
+/* 型号模板, 只读; 旋转后的尺寸保存在各 lcd 实例中 */
+lcd_hw* const lcd_hw_desc[] = {
     &lcd_hw_0_96,
     &lcd_hw_1_14,
     &lcd_hw_1_47,
@@ -55,24 +56,67 @@ uint8_t lcd_cfg_address[][4][4] = {
       函数说明：设置起始和结束地址
       入口数据：x1,x2 设置列的起始和结束地址
                 y1,y2 设置行的起始和结束地址
+                mem   随后的存储器命令, 0 表示按写指针选择 0x2C/0x3C
       返回值：  无
 ******************************************************************************/
-void lcd_set_address(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+static void lcd_address_cmds(lcd* plcd, lcd_cmd_queue* queue,
+                             uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t mem)
 {
+    const uint8_t* offset = plcd->offset;
+    uint8_t cmds = lcd_window_set(&plcd->window, x1, y1, x2, y2);
+
+    /* 续写不更新缓存的窗口, 指定的命令 (如 RAMRD) 需要新窗口先生效 */
+    if(mem && (cmds & LCD_WIN_RAMWRC)) {
+        lcd_window_reset(&plcd->window);
+        cmds = lcd_window_set(&plcd->window, x1, y1, x2, y2);
+    }
+
     /* 列地址设置 */
-    lcd_config_reg(plcd->io, 0x2a);
-    lcd_write_halfword(plcd->io, x1 + lcd_cfg_address[plcd->hw->type][plcd->hw->rotate][0]);
-    lcd_write_halfword(plcd->io, x2 + lcd_cfg_address[plcd->hw->type][plcd->hw->rotate][1]);
+    if(cmds & LCD_WIN_CASET) {
+        lcd_cmd_begin(queue, 0x2a);
+        lcd_cmd_param16(queue, x1 + offset[0]);
+        lcd_cmd_param16(queue, x2 + offset[1]);
+    }
     /* 行地址设置 */
-    lcd_config_reg(plcd->io, 0x2b);
-    lcd_write_halfword(plcd->io, y1 + lcd_cfg_address[plcd->hw->type][plcd->hw->rotate][2]);
-    lcd_write_halfword(plcd->io, y2 + lcd_cfg_address[plcd->hw->type][plcd->hw->rotate][3]);
-    /* 储存器写 */
-    lcd_config_reg(plcd->io, 0x2c);
+    if(cmds & LCD_WIN_RASET) {
+        lcd_cmd_begin(queue, 0x2b);
+        lcd_cmd_param16(queue, y1 + offset[2]);
+        lcd_cmd_param16(queue, y2 + offset[3]);
+    }
+    /* 指定的命令总是从窗口起点开始 */
+    if(mem) {
+        lcd_cmd_begin(queue, mem);
+        plcd->window.pos = 0;
+        return;
+    }
+    /* 储存器写 / 从上次位置继续写 */
+    lcd_cmd_begin(queue, (cmds & LCD_WIN_RAMWRC) ? 0x3c : 0x2c);
+}
+
+/******************************************************************************
+      函数说明：设置起始和结束地址, 窗口未变化时跳过 CASET/RASET,
+                写指针恰好停在新窗口起点时用 0x3C 续写
+      注意：    之后写入的像素数需通过 lcd_window_advance 记录
+******************************************************************************/
+void lcd_set_address(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    lcd_cmd_queue queue = { 0 };
+
+    lcd_address_cmds(plcd, &queue, x1, y1, x2, y2, 0);
+    lcd_io_begin(plcd->io);
+    lcd_write_cmds(plcd->io, &queue);
+    lcd_io_end(plcd->io);
 }
 
 void lcd_init_hw(lcd* plcd)
 {
+    lcd_io_init(plcd->io);
+    lcd_io_clock_init(plcd->io, true);
+    plcd->offset = lcd_cfg_address[plcd->hw->type][plcd->hw->rotate];
+    lcd_window_reset(&plcd->window);
+
+    lcd_io_begin(plcd->io);
+
     lcd_io_rst(plcd->io, 0);
     lcd_delay(100);
     lcd_io_rst(plcd->io, 1);
@@ -151,20 +195,28 @@ void lcd_init_hw(lcd* plcd)
 
     /* Display on */
     lcd_config_reg(plcd->io, 0x29);
+
+    lcd_io_clock_init(plcd->io, false);
+    lcd_io_end(plcd->io);
 }
 
 void lcd_write_reg_data(lcd_io* lcdio, int len, ...)
 {
+    lcd_cmd_queue queue = { 0 };
     va_list args;
     va_start(args, len);
     
-    lcd_write_reg(lcdio, (uint8_t)va_arg(args, unsigned int));
+    lcd_cmd_begin(&queue, (uint8_t)va_arg(args, unsigned int));
     
     for (int i = 1; i < len; i++) {
-        lcd_write_byte(lcdio, (uint8_t)va_arg(args, unsigned int));
+        lcd_cmd_param(&queue, (uint8_t)va_arg(args, unsigned int));
     }
 
 	va_end(args);     
+
+    lcd_io_begin(lcdio);
+    lcd_write_cmds(lcdio, &queue);
+    lcd_io_end(lcdio);
 }
 
 void lcd_init_dev(lcd* plcd, lcd_type type, lcd_rotate rotate)
@@ -172,7 +224,9 @@ void lcd_init_dev(lcd* plcd, lcd_type type, lcd_rotate rotate)
     uint16_t width;
     uint16_t height;
     
-    plcd->hw = lcd_hw_desc[type];
+    /* 复制模板, 同型号的多块屏互不影响 */
+    plcd->geometry = *lcd_hw_desc[type];
+    plcd->hw = &plcd->geometry;
     
     switch (rotate) {
 	case LCD_ROTATE_0:
@@ -194,6 +248,23 @@ void lcd_init_dev(lcd* plcd, lcd_type type, lcd_rotate rotate)
     lcd_clear(plcd, BLACK);
 }
 
+/******************************************************************************
+      函数说明：打开/关闭 TE 同步, 打开后 lcd_anim_flush 在 TE 之后的窗口内开始
+      注意：    需要 io->te 接到面板 TE 引脚
+******************************************************************************/
+void lcd_set_vsync(lcd* plcd, bool on)
+{
+    if(on) {
+        lcd_io_te(plcd->io, true);
+        /* Tearing Effect Line On, 只在 V-blank 输出 */
+        lcd_config_reg(plcd->io, 0x35, 0x00);
+    } else {
+        /* Tearing Effect Line Off */
+        lcd_config_reg(plcd->io, 0x34);
+        lcd_io_te(plcd->io, false);
+    }
+}
+
 void lcd_clear(lcd* plcd, uint16_t color)
 {
     lcd_fill(plcd, 0, 0, plcd->hw->width - 1, plcd->hw->height - 1, color);
@@ -201,31 +272,99 @@ void lcd_clear(lcd* plcd, uint16_t color)
 
 void lcd_draw_point(lcd* plcd, uint16_t x, uint16_t y, uint16_t color)
 {
-    lcd_set_address(plcd, x, y, x, y);
-    lcd_write_halfword(plcd->io, color);
+    lcd_cmd_queue queue = { 0 };
+
+    /* 像素数据作为 RAMWR 的参数, 与窗口命令一起发送 */
+    lcd_address_cmds(plcd, &queue, x, y, x, y, 0);
+    lcd_cmd_param16(&queue, color);
+    lcd_io_begin(plcd->io);
+    lcd_write_cmds(plcd->io, &queue);
+    lcd_io_end(plcd->io);
+    lcd_window_advance(&plcd->window, 1);
+}
+
+static void lcd_stream_write(void* ctx, uint8_t* data, uint32_t len)
+{
+    lcd_write_pixels_async(ctx, (const uint16_t *)data, len / 2);
+}
+
+static void lcd_stream_wait(void* ctx)
+{
+    lcd_write_wait(ctx);
+}
+
+/******************************************************************************
+      函数说明：逐行生成并发送一个矩形区域
+      入口数据：x,y 起点坐标
+                width,height 区域大小
+                gen 行生成回调, 一行在发送时生成下一行
+      返回值：  无
+******************************************************************************/
+void lcd_draw_lines(lcd* plcd, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                    lcd_line_gen gen, void* arg)
+{
+    lcd_stream stream = {
+        .buf   = { plcd->line_buffer, plcd->line_buffer_alt },
+        .ctx   = plcd->io,
+        .write = lcd_stream_write,
+        .wait  = lcd_stream_wait,
+    };
+
+    lcd_io_begin(plcd->io);
+    lcd_set_address(plcd, x, y, x + width - 1, y + height - 1);
+    lcd_stream_lines(&stream, width, height, gen, arg);
+    lcd_io_end(plcd->io);
+    lcd_window_advance(&plcd->window, (uint32_t)width * height);
+}
+
+static void lcd_fill_line(void* arg, uint16_t row, uint16_t* line, uint16_t width)
+{
+    uint16_t color = *(uint16_t *)arg;
+
+    /* 纯色: 两个缓冲各填一次即可 */
+    if(row >= 2)
+        return;
+
+    for(int i = 0; i < width; i++)
+        line[i] = color;
 }
 
 void lcd_fill(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
 {
     uint16_t width, height;
+    lcd_fill_plan plan;
     width  = x2 - x1 + 1;
     height = y2 - y1 + 1;
-    
-    color = (color << 8) | (color >> 8);
 
-    if(!plcd->line_buffer) {
+    lcd_fill_plan_make(&plan, width, height, LCD_DMA_MAX_LEN,
+                       LCD_SPI_16BIT && lcd_io_has_dma(plcd->io), plcd->line_buffer != NULL);
+
+    if(plan.mode == LCD_FILL_REPEAT) {
+        bool ok;
+
+        lcd_io_begin(plcd->io);
+        lcd_set_address(plcd, x1, y1, x2, y2);
+        ok = lcd_write_repeat(plcd->io, LCD_PIXEL(color), plan.pixels);
+        lcd_io_end(plcd->io);
+        if(ok) {
+            lcd_window_advance(&plcd->window, plan.pixels);
+            return;
+        }
+        /* DMA 启动失败, 回退到下面的方式重新发送 */
+        lcd_fill_plan_make(&plan, width, height, 0, false, plcd->line_buffer != NULL);
+    }
+
+    if(plan.mode == LCD_FILL_POINT) {
+        lcd_io_begin(plcd->io);
         for(int i = 0; i < height; i++) {
             for(int j = 0; j < width; j++) {
                 lcd_draw_point(plcd, x1 + j, y1 + i, color);
             }
         }
+        lcd_io_end(plcd->io);
     } else {
-        for(int i = 0; i < width; i++)
-            plcd->line_buffer[i] = color;
-
-        lcd_set_address(plcd, x1, y1, x2, y2);
-        for(int i = 0; i < height; i++)
-            lcd_write_bulk(plcd->io, (uint8_t *)&plcd->line_buffer[0], width * 2);
+        color = LCD_PIXEL(color);
+        lcd_draw_lines(plcd, x1, y1, width, height, lcd_fill_line, &color);
     }
 }
 
@@ -261,6 +400,7 @@ void lcd_draw_line(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2
 
     distance = delta_x > delta_y ? delta_x : delta_y;   //选取基本增量坐标轴 
 
+    lcd_io_begin(plcd->io);
     for(int i = 0; i <= distance + 1; i++ ) {
         lcd_draw_point(plcd, pos_x, pos_y, color);
         xerr += delta_x; 
@@ -274,14 +414,17 @@ void lcd_draw_line(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2
             pos_y += incy; 
         }
     }
+    lcd_io_end(plcd->io);
 }
 
 void lcd_draw_rectangle(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
 {
+    lcd_io_begin(plcd->io);
     lcd_draw_line(plcd, x1, y1, x2, y1, color);
     lcd_draw_line(plcd, x1, y1, x1, y2, color);
     lcd_draw_line(plcd, x1, y2, x2, y2, color);
     lcd_draw_line(plcd, x2, y1, x2, y2, color);
+    lcd_io_end(plcd->io);
 }
 
 void lcd_set_font(lcd* plcd, font_type type, uint16_t front_color, uint16_t back_color)
@@ -291,50 +434,110 @@ void lcd_set_font(lcd* plcd, font_type type, uint16_t front_color, uint16_t back
     plcd->font.back_color  = back_color;
 }
 
-//在指定位置显示一个字符
-//num:要显示的字符:" "--->"~"
-void lcd_show_char(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
+/* 同一行中相邻的若干字符 */
+typedef struct __lcd_text_run {
+    const lcd_font* font;
+    const uint8_t* str;
+    uint16_t count;
+} lcd_text_run;
+
+/* 展开一行字符的第 row 条扫描线, 字模每行 (width + 7) / 8 字节, 低位在左 */
+static void lcd_text_line(void* arg, uint16_t row, uint16_t* line, uint16_t width)
 {
-    uint8_t width = 0;
-    chr = chr - ' ';
-    
-    if(x > plcd->hw->width - plcd->font.width ||
-       y > plcd->hw->height - plcd->font.height) {
-        return;
+    const lcd_text_run* run = arg;
+    const lcd_font* font = run->font;
+    uint16_t stride = (font->width + 7) / 8;
+    uint16_t front = LCD_PIXEL(font->front_color);
+    uint16_t back  = LCD_PIXEL(font->back_color);
+
+    for(uint16_t i = 0; i < run->count; i++) {
+        const uint8_t* bits = &font->addr[(run->str[i] - ' ') * font->bytes + row * stride];
+
+        for(uint16_t c = 0; c < font->width; c++)
+            *line++ = (bits[c >> 3] >> (c & 7)) & 0x01 ? front : back;
     }
+}
 
-    lcd_set_address(plcd, x, y, x + plcd->font.width - 1, y + plcd->font.height - 1);
-    
-    for(int idx = 0; idx < plcd->font.bytes; idx++) {
-        uint8_t data = plcd->font.addr[chr * plcd->font.bytes + idx];
-        for(int pixel = 0; pixel < 8; pixel++) {
-            if(data & 0x01)
-                lcd_write_halfword(plcd->io, plcd->font.front_color);
-            else
-                lcd_write_halfword(plcd->io, plcd->font.back_color);
-            data >>= 1;
-
-            width++;
-            if(width == plcd->font.width) {
-                width = 0;
-                break;
+/* 没有行缓冲: 每个字符一个窗口, 逐像素发送 */
+static void lcd_show_run_point(lcd* plcd, uint16_t x, uint16_t y, const uint8_t* str, uint16_t count)
+{
+    const lcd_font* font = &plcd->font;
+    uint16_t stride = (font->width + 7) / 8;
+
+    lcd_io_begin(plcd->io);
+    for(uint16_t i = 0; i < count; i++, x += font->width) {
+        const uint8_t* glyph = &font->addr[(str[i] - ' ') * font->bytes];
+
+        lcd_set_address(plcd, x, y, x + font->width - 1, y + font->height - 1);
+        for(uint16_t r = 0; r < font->height; r++) {
+            for(uint16_t c = 0; c < font->width; c++) {
+                if((glyph[r * stride + (c >> 3)] >> (c & 7)) & 0x01)
+                    lcd_write_halfword(plcd->io, font->front_color);
+                else
+                    lcd_write_halfword(plcd->io, font->back_color);
             }
         }
-    }  	 	  
+        lcd_window_advance(&plcd->window, (uint32_t)font->width * font->height);
+    }
+    lcd_io_end(plcd->io);
+}
+
+/* 一个窗口覆盖 count 个字符, 逐条扫描线展开到行缓冲, 每条一次批量发送 */
+static void lcd_show_run(lcd* plcd, uint16_t x, uint16_t y, const uint8_t* str, uint16_t count)
+{
+    lcd_text_run run = { &plcd->font, str, count };
+
+    if(!count || y > plcd->hw->height - plcd->font.height)
+        return;
+    if(!plcd->line_buffer) {
+        lcd_show_run_point(plcd, x, y, str, count);
+        return;
+    }
+    lcd_draw_lines(plcd, x, y, count * plcd->font.width, plcd->font.height, lcd_text_line, &run);
 }
 
-/*** *p:字符串起始地址 用16字体 ***/
+//在指定位置显示一个字符
+//num:要显示的字符:" "--->"~"
+void lcd_show_char(lcd* plcd, uint16_t x, uint16_t y, uint16_t chr)
+{
+    uint8_t c = chr;
+
+    if(x > plcd->hw->width - plcd->font.width)
+        return;
+    lcd_show_run(plcd, x, y, &c, 1);
+}
+
+/*** *p:字符串起始地址 用16字体
+     换行规则与逐字符显示相同, 每一行文字只设置一次窗口 ***/
 void lcd_show_string(lcd* plcd, uint16_t x, uint16_t y, const uint8_t *p)
 {
+    lcd_io_begin(plcd->io);
     while(*p != '\0') {
+        const uint8_t* start;
+        uint16_t count = 0;
+
         if(x > plcd->hw->width - plcd->font.width) {
             x = 0;
             y += plcd->font.height;
         }
 
-        lcd_show_char(plcd, x, y, *p++); 
-        x += plcd->font.width;
+        // 本行放得下的字符
+        start = p;
+        while(*p != '\0' && x + (count + 1) * plcd->font.width <= plcd->hw->width) {
+            p++;
+            count++;
+        }
+        // 面板比一个字符还窄: 逐字符换行, 都不显示
+        if(!count) {
+            p++;
+            x += plcd->font.width;
+            continue;
+        }
+
+        lcd_show_run(plcd, x, y, start, count);
+        x += count * plcd->font.width;
     }
+    lcd_io_end(plcd->io);
 }
 
 void lcd_print(lcd* plcd, uint16_t x, uint16_t y, const char *fmt, ...)
@@ -359,6 +562,89 @@ void lcd_print(lcd* plcd, uint16_t x, uint16_t y, const char *fmt, ...)
 ******************************************************************************/
 void lcd_show_picture(lcd* plcd, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t* pic)
 {
+    /* 图片已是屏幕字节序, 直接从源数据发送, 无需经过行缓冲;
+       需要解码/转换的图片使用 lcd_draw_lines 逐行生成 */
+    lcd_io_begin(plcd->io);
     lcd_set_address(plcd, x, y, x + width - 1, y + height - 1);
     lcd_write_bulk(plcd->io, pic, width * height * 2);
+    lcd_io_end(plcd->io);
+    lcd_window_advance(&plcd->window, (uint32_t)width * height);
+}
+
+/************ 读-改-写 (RAMRD) ************/
+static void lcd_rmw_address(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, bool read)
+{
+    lcd* plcd = ctx;
+    lcd_cmd_queue queue = { 0 };
+
+    lcd_address_cmds(plcd, &queue, x1, y1, x2, y2, read ? 0x2e : 0x2c);
+    lcd_write_cmds(plcd->io, &queue);
+}
+
+static void lcd_rmw_read(void* ctx, uint8_t* data, uint32_t len)
+{
+    lcd_read_bulk(((lcd *)ctx)->io, data, len);
+}
+
+static void lcd_rmw_write(void* ctx, uint16_t* pixels, uint32_t count)
+{
+    lcd* plcd = ctx;
+
+    for(uint32_t i = 0; i < count; i++)
+        pixels[i] = LCD_PIXEL(pixels[i]);
+
+    lcd_write_pixels(plcd->io, pixels, count);
+    lcd_window_advance(&plcd->window, count);
+}
+
+static const lcd_rmw_ops lcd_rmw_port = {
+    .address = lcd_rmw_address,
+    .read    = lcd_rmw_read,
+    .write   = lcd_rmw_write,
+};
+
+/******************************************************************************
+      函数说明：读回面板 GRAM 中的区域, 由 fn 修改后写回, 不需要整屏显存
+      入口数据：x,y 起点坐标
+                width,height 区域大小
+                fn 修改回调, 像素为 RGB565
+      返回值：  没有行缓冲时返回 false
+      注意：    行缓冲作为暂存区, 区域按其大小分块读写
+******************************************************************************/
+bool lcd_modify(lcd* plcd, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                lcd_rmw_fn fn, void* arg)
+{
+    bool ok;
+
+    if(!plcd->line_buffer)
+        return false;
+
+    lcd_io_begin(plcd->io);
+    ok = lcd_rmw_region(&lcd_rmw_port, plcd, x, y, width, height,
+                        (uint8_t *)plcd->line_buffer, plcd->hw->width * 2, fn, arg);
+    lcd_io_end(plcd->io);
+
+    return ok;
+}
+
+typedef struct {
+    uint16_t color;
+    uint8_t alpha;
+} lcd_blend_arg;
+
+static void lcd_blend_fn(void* arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t* pixels)
+{
+    const lcd_blend_arg* blend = arg;
+
+    for(uint32_t i = 0; i < (uint32_t)w * h; i++)
+        pixels[i] = lcd_rmw_blend(blend->color, pixels[i], blend->alpha);
+}
+
+/* 半透明填充: alpha 为 0~255 */
+bool lcd_fill_blend(lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+                    uint16_t color, uint8_t alpha)
+{
+    lcd_blend_arg blend = { color, alpha };
+
+    return lcd_modify(plcd, x1, y1, x2 - x1 + 1, y2 - y1 + 1, lcd_blend_fn, &blend);
 }
@@ -0,0 +1,140 @@
+#include "lcd_dirty.h"
+
+void lcd_dirty_init(lcd_dirty* dirty, uint16_t width, uint16_t height)
+{
+    dirty->width  = width;
+    dirty->height = height;
+    dirty->count  = 0;
+}
+
+void lcd_dirty_reset(lcd_dirty* dirty)
+{
+    dirty->count = 0;
+}
+
+uint32_t lcd_rect_area(const lcd_rect* rect)
+{
+    return (uint32_t)(rect->x2 - rect->x1 + 1) * (uint32_t)(rect->y2 - rect->y1 + 1);
+}
+
+static lcd_rect lcd_rect_union(const lcd_rect* a, const lcd_rect* b)
+{
+    lcd_rect u = {
+        a->x1 < b->x1 ? a->x1 : b->x1,
+        a->y1 < b->y1 ? a->y1 : b->y1,
+        a->x2 > b->x2 ? a->x2 : b->x2,
+        a->y2 > b->y2 ? a->y2 : b->y2,
+    };
+    return u;
+}
+
+/* 合并后多发送的像素不超过少一个窗口节省的开销时才值得合并 */
+static bool lcd_rect_worth(const lcd_rect* a, const lcd_rect* b, lcd_rect* u)
+{
+    *u = lcd_rect_union(a, b);
+    return lcd_rect_area(u) <= lcd_rect_area(a) + lcd_rect_area(b) + LCD_DIRTY_OVERHEAD;
+}
+
+static void lcd_dirty_remove(lcd_dirty* dirty, uint8_t idx)
+{
+    dirty->rect[idx] = dirty->rect[--dirty->count];
+}
+
+/* 合并 a 与 b 多发送的像素 (重叠时可能为负) */
+static int32_t lcd_rect_cost(const lcd_rect* a, const lcd_rect* b)
+{
+    lcd_rect u = lcd_rect_union(a, b);
+
+    return (int32_t)lcd_rect_area(&u) - (int32_t)lcd_rect_area(a) - (int32_t)lcd_rect_area(b);
+}
+
+static void lcd_dirty_insert(lcd_dirty* dirty, lcd_rect rect)
+{
+    lcd_rect u;
+    bool merged;
+
+    /* 合并后的矩形可能又与其他矩形值得合并, 重复直到稳定 */
+    do {
+        merged = false;
+        for(uint8_t i = 0; i < dirty->count; i++) {
+            if(lcd_rect_worth(&dirty->rect[i], &rect, &u)) {
+                rect = u;
+                lcd_dirty_remove(dirty, i);
+                merged = true;
+                break;
+            }
+        }
+    } while(merged);
+
+    if(dirty->count < LCD_DIRTY_MAX) {
+        dirty->rect[dirty->count++] = rect;
+        return;
+    }
+
+    /* 已满: 在已有矩形和新矩形中找合并代价最小的一对 (不一定包含新矩形) */
+    uint8_t bi = 0, bj = LCD_DIRTY_MAX;
+    int32_t best = INT32_MAX;
+
+    for(uint8_t i = 0; i < LCD_DIRTY_MAX; i++) {
+        for(uint8_t j = i + 1; j <= LCD_DIRTY_MAX; j++) {
+            const lcd_rect* b = j < LCD_DIRTY_MAX ? &dirty->rect[j] : &rect;
+            int32_t cost = lcd_rect_cost(&dirty->rect[i], b);
+
+            if(cost < best) {
+                best = cost;
+                bi = i;
+                bj = j;
+            }
+        }
+    }
+
+    if(bj == LCD_DIRTY_MAX) {
+        rect = lcd_rect_union(&dirty->rect[bi], &rect);
+        lcd_dirty_remove(dirty, bi);
+    } else {
+        lcd_rect pair = lcd_rect_union(&dirty->rect[bi], &dirty->rect[bj]);
+
+        /* 先移除下标大的, 避免 remove 搬动 bi */
+        lcd_dirty_remove(dirty, bj);
+        lcd_dirty_remove(dirty, bi);
+        dirty->rect[dirty->count++] = rect;
+        rect = pair;
+    }
+    lcd_dirty_insert(dirty, rect);
+}
+
+/* 坐标可以超出屏幕, 裁剪后为空则忽略 */
+void lcd_dirty_add(lcd_dirty* dirty, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    lcd_rect rect;
+
+    if(x1 > x2) { int16_t t = x1; x1 = x2; x2 = t; }
+    if(y1 > y2) { int16_t t = y1; y1 = y2; y2 = t; }
+
+    if(x1 < 0) x1 = 0;
+    if(y1 < 0) y1 = 0;
+    if(x2 >= dirty->width)  x2 = dirty->width - 1;
+    if(y2 >= dirty->height) y2 = dirty->height - 1;
+    if(x1 > x2 || y1 > y2)
+        return;
+
+    rect.x1 = x1; rect.y1 = y1;
+    rect.x2 = x2; rect.y2 = y2;
+    lcd_dirty_insert(dirty, rect);
+}
+
+void lcd_dirty_merge(lcd_dirty* dirty, const lcd_dirty* other)
+{
+    for(uint8_t i = 0; i < other->count; i++)
+        lcd_dirty_insert(dirty, other->rect[i]);
+}
+
+/* 各矩形面积之和 (矩形之间可能重叠) */
+uint32_t lcd_dirty_area(const lcd_dirty* dirty)
+{
+    uint32_t area = 0;
+
+    for(uint8_t i = 0; i < dirty->count; i++)
+        area += lcd_rect_area(&dirty->rect[i]);
+    return area;
+}
@@ -0,0 +1,31 @@
+/*
+ * @Describe: 脏矩形收集与合并
+ */
+#ifndef __LCD_DIRTY_H
+#define __LCD_DIRTY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LCD_DIRTY_MAX       16
+/* 每多一个窗口的额外开销, 折算为像素数 (CASET/RASET/RAMWR 与一次 DMA 启动) */
+#define LCD_DIRTY_OVERHEAD  64
+
+typedef struct __lcd_rect {
+    int16_t x1, y1, x2, y2;     // 闭区间
+} lcd_rect;
+
+typedef struct __lcd_dirty {
+    lcd_rect rect[LCD_DIRTY_MAX];
+    uint8_t count;
+    uint16_t width, height;     // 裁剪范围
+} lcd_dirty;
+
+void lcd_dirty_init(lcd_dirty* dirty, uint16_t width, uint16_t height);
+void lcd_dirty_reset(lcd_dirty* dirty);
+void lcd_dirty_add(lcd_dirty* dirty, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+void lcd_dirty_merge(lcd_dirty* dirty, const lcd_dirty* other);
+uint32_t lcd_dirty_area(const lcd_dirty* dirty);
+uint32_t lcd_rect_area(const lcd_rect* rect);
+
+#endif
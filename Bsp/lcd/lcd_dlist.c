@@ -0,0 +1,112 @@
+#include "lcd_dlist.h"
+
+void lcd_dlist_init(lcd_dlist* list)
+{
+    list->head = 0;
+    list->tail = 0;
+}
+
+void lcd_dlist_add(lcd_dlist* list, lcd_dlist_item* item, lcd_dlist_draw draw, void* obj)
+{
+    item->next = 0;
+    item->draw = draw;
+    item->obj  = obj;
+    item->box.x1 = item->box.y1 = 0;
+    item->box.x2 = item->box.y2 = -1;
+    item->key = 0;
+    item->shown = false;
+    item->removed = false;
+
+    if(list->tail)
+        list->tail->next = item;
+    else
+        list->head = item;
+    list->tail = item;
+}
+
+void lcd_dlist_remove(lcd_dlist* list, lcd_dlist_item* item)
+{
+    (void)list;
+    item->removed = true;
+}
+
+void lcd_dlist_set(lcd_dlist_item* item, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t key)
+{
+    item->box.x1 = x1;
+    item->box.y1 = y1;
+    item->box.x2 = x2;
+    item->box.y2 = y2;
+    item->key = key;
+}
+
+static void lcd_dlist_damage(lcd_dirty* damage, const lcd_rect* r)
+{
+    if(r->x1 <= r->x2 && r->y1 <= r->y2)
+        lcd_dirty_add(damage, r->x1, r->y1, r->x2, r->y2);
+}
+
+static bool lcd_rect_same(const lcd_rect* a, const lcd_rect* b)
+{
+    return a->x1 == b->x1 && a->y1 == b->y1 && a->x2 == b->x2 && a->y2 == b->y2;
+}
+
+void lcd_dlist_diff(lcd_dlist* list, lcd_dirty* damage)
+{
+    lcd_dlist_item** link = &list->head;
+    lcd_dlist_item* prev = 0;
+
+    while(*link) {
+        lcd_dlist_item* item = *link;
+
+        if(item->removed) {
+            if(item->shown)
+                lcd_dlist_damage(damage, &item->shown_box);
+            *link = item->next;
+            if(list->tail == item)
+                list->tail = prev;
+            continue;
+        }
+
+        if(!item->shown) {
+            lcd_dlist_damage(damage, &item->box);
+        } else if(item->key != item->shown_key || !lcd_rect_same(&item->box, &item->shown_box)) {
+            lcd_dlist_damage(damage, &item->shown_box);
+            lcd_dlist_damage(damage, &item->box);
+        }
+        item->shown_box = item->box;
+        item->shown_key = item->key;
+        item->shown = true;
+
+        prev = item;
+        link = &item->next;
+    }
+}
+
+static bool lcd_rect_overlap(const lcd_rect* a, const lcd_rect* b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+void lcd_dlist_render(const lcd_dlist* list, const lcd_dirty* damage, lcd_dlist_region region, void* ctx)
+{
+    for(uint8_t i = 0; i < damage->count; i++) {
+        region(ctx, &damage->rect[i]);
+        for(lcd_dlist_item* item = list->head; item; item = item->next) {
+            if(lcd_rect_overlap(&item->box, &damage->rect[i]))
+                item->draw(item->obj);
+        }
+    }
+    if(damage->count)
+        region(ctx, 0);
+}
+
+uint32_t lcd_dlist_key(uint32_t key, const void* data, uint32_t len)
+{
+    const uint8_t* p = data;
+
+    while(len--) {
+        key ^= *p++;
+        key *= 0x01000193U;
+    }
+    return key;
+}
@@ -0,0 +1,49 @@
+/*
+ * @Describe: 保留模式显示列表, 与上一帧比较得出需要重画的区域
+ *            对象注册一次, 之后只修改外包框和属性摘要, 没有变化的对象不产生任何开销
+ */
+#ifndef __LCD_DLIST_H
+#define __LCD_DLIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_dirty.h"
+
+typedef void (*lcd_dlist_draw)(void* obj);
+/* 重画一个区域前调用: 清空 rect 并把绘制裁剪到 rect; rect 为 NULL 时取消裁剪 */
+typedef void (*lcd_dlist_region)(void* ctx, const lcd_rect* rect);
+
+typedef struct __lcd_dlist_item {
+    struct __lcd_dlist_item* next;
+    lcd_dlist_draw draw;
+    void* obj;
+
+    lcd_rect box;               // 当前外包框
+    uint32_t key;               // 当前属性摘要, 改变即重画
+    lcd_rect shown_box;         // 上一帧画出时的值
+    uint32_t shown_key;
+    bool shown;
+    bool removed;
+} lcd_dlist_item;
+
+/* 列表顺序即绘制顺序, 后加入的画在上面 */
+typedef struct __lcd_dlist {
+    lcd_dlist_item* head;
+    lcd_dlist_item* tail;
+} lcd_dlist;
+
+void lcd_dlist_init(lcd_dlist* list);
+void lcd_dlist_add(lcd_dlist* list, lcd_dlist_item* item, lcd_dlist_draw draw, void* obj);
+/* 下一次 lcd_dlist_diff 时擦除并移出列表, 在此之前 item 的内存需保持有效 */
+void lcd_dlist_remove(lcd_dlist* list, lcd_dlist_item* item);
+void lcd_dlist_set(lcd_dlist_item* item, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t key);
+/* 比较上一帧, 把移动/改变/加入/移除对象的新旧外包框加入 damage, 并记为已画出 */
+void lcd_dlist_diff(lcd_dlist* list, lcd_dirty* damage);
+/* 按 damage 逐个区域重画与之相交的对象 */
+void lcd_dlist_render(const lcd_dlist* list, const lcd_dirty* damage, lcd_dlist_region region, void* ctx);
+/* FNV-1a, 用于计算属性摘要 */
+uint32_t lcd_dlist_key(uint32_t key, const void* data, uint32_t len);
+
+#define LCD_DLIST_KEY_INIT  0x811C9DC5U
+
+#endif
@@ -0,0 +1,30 @@
+#include "lcd_fill_plan.h"
+
+/* seg_max: 单次 DMA 最多发送的像素数 */
+void lcd_fill_plan_make(lcd_fill_plan* plan, uint16_t width, uint16_t height,
+                        uint32_t seg_max, bool dma, bool line_buffer)
+{
+    plan->pixels = (uint32_t)width * height;
+
+    if(dma && seg_max && plan->pixels >= LCD_FILL_REPEAT_MIN) {
+        plan->mode     = LCD_FILL_REPEAT;
+        plan->segments = (plan->pixels + seg_max - 1) / seg_max;
+        plan->seg_len  = plan->pixels < seg_max ? plan->pixels : seg_max;
+        plan->last_len = plan->pixels - (plan->segments - 1) * seg_max;
+    } else if(line_buffer) {
+        plan->mode     = LCD_FILL_LINES;
+        plan->segments = height;
+        plan->seg_len  = width;
+        plan->last_len = width;
+    } else {
+        plan->mode     = LCD_FILL_POINT;
+        plan->segments = plan->pixels;
+        plan->seg_len  = 1;
+        plan->last_len = 1;
+    }
+
+    if(!plan->pixels) {
+        plan->segments = 0;
+        plan->last_len = 0;
+    }
+}
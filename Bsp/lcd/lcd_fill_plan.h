@@ -0,0 +1,30 @@
+/*
+ * @Describe: 纯色填充传输规划
+ */
+#ifndef __LCD_FILL_PLAN_H
+#define __LCD_FILL_PLAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 区域小于该像素数时不值得启动 DMA */
+#define LCD_FILL_REPEAT_MIN     32
+
+typedef enum {
+    LCD_FILL_POINT = 0,     // 无行缓冲: 逐点绘制
+    LCD_FILL_LINES,         // 行缓冲逐行发送
+    LCD_FILL_REPEAT,        // DMA 源地址不递增, 重复发送同一像素
+} lcd_fill_mode;
+
+typedef struct __lcd_fill_plan {
+    lcd_fill_mode mode;
+    uint32_t pixels;        // 总像素数
+    uint32_t segments;      // 传输次数
+    uint32_t seg_len;       // 每次传输的像素数 (最后一次除外)
+    uint32_t last_len;      // 最后一次传输的像素数
+} lcd_fill_plan;
+
+void lcd_fill_plan_make(lcd_fill_plan* plan, uint16_t width, uint16_t height,
+                        uint32_t seg_max, bool dma, bool line_buffer);
+
+#endif
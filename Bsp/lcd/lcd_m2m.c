@@ -0,0 +1,286 @@
+#include "lcd_m2m.h"
+#include <string.h>
+
+void lcd_m2m_init(lcd_m2m* m2m, const lcd_m2m_ops* ops, void* ctx)
+{
+    m2m->ops      = ops;
+    m2m->ctx      = ctx;
+    m2m->head     = 0;
+    m2m->count    = 0;
+    m2m->busy     = false;
+    m2m->complete = 0;
+    m2m->fallback = 0;
+}
+
+/* 取 dst/src 都对齐的最宽数据项; 两者相对字对齐时先拆出行首零头, 之后按字传输 */
+bool lcd_m2m_plan(lcd_m2m_req* req, lcd_m2m_seg* seg)
+{
+    uint32_t left, len;
+    uintptr_t dst, src;
+    uint8_t width;
+
+    if(req->y >= req->rows || !req->row)
+        return false;
+
+    left = req->row - req->offset;
+    seg->dst   = req->dst + (uint32_t)req->y * req->dst_stride + req->offset;
+    seg->src   = req->fill ? req->src : req->src + (uint32_t)req->y * req->src_stride + req->offset;
+    seg->fixed = req->fill;
+
+    // 填充的源是按字重复的图样, 任意位置都可按字读取
+    dst = (uintptr_t)seg->dst;
+    src = req->fill ? dst : (uintptr_t)seg->src;
+    for(width = 4; width > req->unit; width >>= 1) {
+        if(!((dst | src) & (width - 1)) && left >= width)
+            break;
+    }
+
+    if(width < 4 && left >= 8 && !((dst ^ src) & 3) && (dst & 3))
+        len = 4 - (dst & 3);
+    else
+        len = left - left % width;
+    if(len > (uint32_t)LCD_M2M_MAX_ITEMS * width)
+        len = (uint32_t)LCD_M2M_MAX_ITEMS * width;
+
+    seg->len   = len;
+    seg->width = width;
+
+    req->offset += len;
+    if(req->offset >= req->row) {
+        req->offset = 0;
+        req->y++;
+    }
+    return true;
+}
+
+static void lcd_m2m_cpu(const lcd_m2m_seg* seg)
+{
+    if(!seg->fixed) {
+        memcpy(seg->dst, seg->src, seg->len);
+    } else if(seg->width == 4) {
+        for(uint32_t i = 0; i < seg->len / 4; i++)
+            ((uint32_t *)seg->dst)[i] = *(const uint32_t *)seg->src;
+    } else if(seg->width == 2) {
+        for(uint32_t i = 0; i < seg->len / 2; i++)
+            ((uint16_t *)seg->dst)[i] = *(const uint16_t *)seg->src;
+    } else {
+        memset(seg->dst, *seg->src, seg->len);
+    }
+}
+
+static void lcd_m2m_lock(lcd_m2m* m2m)
+{
+    if(m2m->ops && m2m->ops->lock)
+        m2m->ops->lock(m2m->ctx);
+}
+
+static void lcd_m2m_unlock(lcd_m2m* m2m)
+{
+    if(m2m->ops && m2m->ops->unlock)
+        m2m->ops->unlock(m2m->ctx);
+}
+
+/* 拆分队首请求, 直到启动一段传输或队列为空; 短段和启动失败的段由 CPU 完成 */
+static void lcd_m2m_run(lcd_m2m* m2m)
+{
+    for(;;) {
+        lcd_m2m_req* req;
+
+        lcd_m2m_lock(m2m);
+        if(!m2m->count) {
+            m2m->busy = false;
+            lcd_m2m_unlock(m2m);
+            if(m2m->ops && m2m->ops->notify)
+                m2m->ops->notify(m2m->ctx);
+            return;
+        }
+        req = &m2m->queue[m2m->head];
+        lcd_m2m_unlock(m2m);
+
+        if(!lcd_m2m_plan(req, &m2m->seg)) {
+            lcd_m2m_done done = req->done;
+            void* arg = req->arg;
+
+            lcd_m2m_lock(m2m);
+            m2m->head = (m2m->head + 1) % LCD_M2M_QUEUE;
+            m2m->count--;
+            m2m->complete++;
+            lcd_m2m_unlock(m2m);
+            if(done)
+                done(arg);
+            continue;
+        }
+
+        if(m2m->seg.len >= LCD_M2M_MIN_LEN && m2m->ops && m2m->ops->start) {
+            if(m2m->ops->start(m2m->ctx, &m2m->seg))
+                return;
+            m2m->fallback++;
+        }
+        lcd_m2m_cpu(&m2m->seg);
+    }
+}
+
+static void lcd_m2m_submit(lcd_m2m* m2m, const lcd_m2m_req* req)
+{
+    lcd_m2m_req* slot;
+    bool start;
+
+    // 队列满时等待, 完成中断会继续出队
+    while(m2m->count >= LCD_M2M_QUEUE) {
+        if(m2m->ops && m2m->ops->wait)
+            m2m->ops->wait(m2m->ctx);
+    }
+
+    lcd_m2m_lock(m2m);
+    slot = &m2m->queue[(m2m->head + m2m->count) % LCD_M2M_QUEUE];
+    *slot = *req;
+    if(slot->fill)
+        slot->src = (const uint8_t *)&slot->pattern;
+    slot->y = 0;
+    slot->offset = 0;
+    m2m->count++;
+    start = !m2m->busy;
+    m2m->busy = true;
+    lcd_m2m_unlock(m2m);
+
+    if(start)
+        lcd_m2m_run(m2m);
+}
+
+void lcd_m2m_copy(lcd_m2m* m2m, void* dst, uint32_t dst_stride, const void* src, uint32_t src_stride,
+                  uint32_t row, uint16_t rows, lcd_m2m_done done, void* arg)
+{
+    lcd_m2m_req req = {
+        .dst = dst, .dst_stride = dst_stride,
+        .src = src, .src_stride = src_stride,
+        .row = row, .rows = rows,
+        .unit = 1, .fill = false,
+        .done = done, .arg = arg,
+    };
+
+    // 各行首尾相接时合并为一行
+    if(rows > 1 && row == dst_stride && row == src_stride) {
+        req.row  = row * rows;
+        req.rows = 1;
+    }
+    lcd_m2m_submit(m2m, &req);
+}
+
+void lcd_m2m_fill(lcd_m2m* m2m, void* dst, uint32_t dst_stride, uint32_t row, uint16_t rows,
+                  uint16_t value, uint8_t unit, lcd_m2m_done done, void* arg)
+{
+    lcd_m2m_req req = {
+        .dst = dst, .dst_stride = dst_stride,
+        .row = row, .rows = rows,
+        .unit = unit, .fill = true,
+        .pattern = unit == 1 ? (value & 0xFFU) * 0x01010101U : value | ((uint32_t)value << 16),
+        .done = done, .arg = arg,
+    };
+
+    if(rows > 1 && row == dst_stride) {
+        req.row  = row * rows;
+        req.rows = 1;
+    }
+    lcd_m2m_submit(m2m, &req);
+}
+
+bool lcd_m2m_fill_rect(lcd_m2m* m2m, const lcd_surface* surf, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, uint16_t value, lcd_m2m_done done, void* arg)
+{
+    lcd_rect r = { x, y, x + width - 1, y + height - 1 };
+    uint16_t rows;
+    uint8_t* row;
+
+    if(!width || !height || !surf->pixels || !lcd_surface_clip(surf, &r))
+        return false;
+    rows = r.y2 - r.y1 + 1;
+    row  = surf->pixels + (uint32_t)r.y1 * surf->stride;
+
+    if(surf->bpp != 4) {
+        uint8_t bytes = surf->bpp / 8;
+
+        lcd_m2m_fill(m2m, row + r.x1 * bytes, surf->stride, (uint32_t)(r.x2 - r.x1 + 1) * bytes, rows,
+                     value, bytes, done, arg);
+        return true;
+    }
+
+    // 4 位: 左右不满一字节的像素由 CPU 写, 先等之前的请求写完这些字节
+    value &= 0x0F;
+    if((r.x1 & 1) || !(r.x2 & 1)) {
+        lcd_m2m_wait(m2m);
+        for(uint16_t i = 0; i < rows; i++) {
+            uint8_t* line = row + (uint32_t)i * surf->stride;
+
+            if(r.x1 & 1)
+                line[r.x1 >> 1] = (line[r.x1 >> 1] & 0x0F) | (value << 4);
+            if(!(r.x2 & 1))
+                line[r.x2 >> 1] = (line[r.x2 >> 1] & 0xF0) | value;
+        }
+        if(r.x1 & 1) r.x1++;
+        if(!(r.x2 & 1)) r.x2--;
+    }
+    if(r.x1 > r.x2) {
+        if(done)
+            done(arg);
+        return true;
+    }
+    lcd_m2m_fill(m2m, row + r.x1 / 2, surf->stride, (r.x2 - r.x1 + 1) / 2, rows,
+                 value | (value << 4), 1, done, arg);
+    return true;
+}
+
+bool lcd_m2m_copy_rect(lcd_m2m* m2m, const lcd_surface* surf, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, const void* src, uint32_t src_stride,
+                       lcd_m2m_done done, void* arg)
+{
+    lcd_rect r = { x, y, x + width - 1, y + height - 1 };
+    const uint8_t* from = src;
+    int16_t dx, dy;
+
+    if(!width || !height || !surf->pixels || !lcd_surface_clip(surf, &r))
+        return false;
+
+    // 被裁掉的行/列在源中跳过
+    dx = r.x1 - surf->x - x;
+    dy = r.y1 - surf->y - y;
+    if(surf->bpp == 4 && ((r.x1 | (r.x2 + 1) | dx) & 1))
+        return false;
+    from += (uint32_t)dy * src_stride + (uint32_t)dx * surf->bpp / 8;
+
+    lcd_m2m_copy(m2m, surf->pixels + (uint32_t)r.y1 * surf->stride + (uint32_t)r.x1 * surf->bpp / 8,
+                 surf->stride, from, src_stride, (uint32_t)(r.x2 - r.x1 + 1) * surf->bpp / 8,
+                 r.y2 - r.y1 + 1, done, arg);
+    return true;
+}
+
+bool lcd_m2m_clear(lcd_m2m* m2m, const lcd_surface* surf, uint16_t value)
+{
+    return lcd_m2m_fill_rect(m2m, surf, 0, 0, surf->width, surf->height, value, 0, 0);
+}
+
+/* 一段传输完成 (ok 为 false 表示出错, 该段改由 CPU 重做) 时在中断中调用 */
+void lcd_m2m_isr(lcd_m2m* m2m, bool ok)
+{
+    if(!m2m->busy)
+        return;
+
+    if(!ok) {
+        m2m->fallback++;
+        lcd_m2m_cpu(&m2m->seg);
+    }
+    lcd_m2m_run(m2m);
+}
+
+/* 等待队列中的请求全部完成; 通知可能残留, 所以要循环检查状态 */
+void lcd_m2m_wait(lcd_m2m* m2m)
+{
+    while(m2m->busy) {
+        if(m2m->ops && m2m->ops->wait)
+            m2m->ops->wait(m2m->ctx);
+    }
+}
+
+bool lcd_m2m_busy(lcd_m2m* m2m)
+{
+    return m2m->busy;
+}
@@ -0,0 +1,105 @@
+/*
+ * @Describe: 存储器到存储器传输: 显存清屏/矩形填充/矩形复制
+ *            请求排队后按行/跨距/单段长度拆成连续段交给后端 (DMA2), 没有后端时由 CPU 完成
+ */
+#ifndef __LCD_M2M_H
+#define __LCD_M2M_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_surface.h"
+
+#define LCD_M2M_QUEUE       4       // 最多排队的请求数
+#define LCD_M2M_MAX_ITEMS   0xffff  // 单段最多数据项 (NDTR 16 位)
+#define LCD_M2M_MIN_LEN     32      // 短于该字节数的段 (行首/行尾对齐用的零头) 由 CPU 完成
+
+/* 请求完成, 在完成中断中调用; CPU 完成时在提交者上下文中调用 */
+typedef void (*lcd_m2m_done)(void* arg);
+
+/* 一段连续传输: len 字节, 每项 width 字节 (1/2/4), dst/src 按 width 对齐;
+   fixed 时源地址不递增, 重复写 src 处的一项 */
+typedef struct __lcd_m2m_seg {
+    uint8_t* dst;
+    const uint8_t* src;
+    uint32_t len;
+    uint8_t width;
+    bool fixed;
+} lcd_m2m_seg;
+
+/* 一个矩形请求: rows 行, 每行 row 字节; 各行连续时合并为一行 */
+typedef struct __lcd_m2m_req {
+    uint8_t* dst;
+    uint32_t dst_stride;
+    const uint8_t* src;             // 复制的源, 填充时指向 pattern
+    uint32_t src_stride;
+    uint32_t row;
+    uint16_t rows;
+    uint8_t unit;                   // 填充图样的最小单位 (1/2 字节), 复制为 1
+    bool fill;
+    uint32_t pattern;               // 填充图样, 按字重复
+    lcd_m2m_done done;
+    void* arg;
+
+    uint16_t y;                     // 当前行
+    uint32_t offset;                // 当前行已拆出的字节数
+} lcd_m2m_req;
+
+/* 传输后端
+ * start : 启动一段异步传输, 返回 false 时该段由 CPU 完成
+ * wait  : 阻塞等待一次完成通知 (任务上下文)
+ * notify: 队列全部完成, 唤醒等待者 (中断上下文)
+ * lock/unlock: 屏蔽/恢复完成中断, 任务与中断中都会调用
+ */
+typedef struct __lcd_m2m_ops {
+    bool (*start)(void* ctx, const lcd_m2m_seg* seg);
+    void (*wait)(void* ctx);
+    void (*notify)(void* ctx);
+    void (*lock)(void* ctx);
+    void (*unlock)(void* ctx);
+} lcd_m2m_ops;
+
+typedef struct __lcd_m2m {
+    const lcd_m2m_ops* ops;         // NULL 时全部由 CPU 完成
+    void* ctx;
+
+    lcd_m2m_req queue[LCD_M2M_QUEUE];
+    volatile uint8_t head;
+    volatile uint8_t count;
+    volatile bool busy;             // 有段正在传输或正在拆分
+    lcd_m2m_seg seg;                // 正在传输的段
+
+    volatile uint32_t complete;     // 已完成的请求数
+    volatile uint32_t fallback;     // 启动失败/出错后由 CPU 完成的段数
+} lcd_m2m;
+
+void lcd_m2m_init(lcd_m2m* m2m, const lcd_m2m_ops* ops, void* ctx);
+/* 拆出请求的下一段, 没有剩余时返回 false */
+bool lcd_m2m_plan(lcd_m2m_req* req, lcd_m2m_seg* seg);
+
+/* 字节级接口, 队列满时先等待; 返回后 dst 可能仍在写入, 用 lcd_m2m_wait 或 done 确认 */
+void lcd_m2m_copy(lcd_m2m* m2m, void* dst, uint32_t dst_stride, const void* src, uint32_t src_stride,
+                  uint32_t row, uint16_t rows, lcd_m2m_done done, void* arg);
+/* 用 value 填充, unit 为 value 的字节数 (1/2) */
+void lcd_m2m_fill(lcd_m2m* m2m, void* dst, uint32_t dst_stride, uint32_t row, uint16_t rows,
+                  uint16_t value, uint8_t unit, lcd_m2m_done done, void* arg);
+
+/* 表面接口: 坐标相对于表面, 裁剪到表面; value 为显存中的值 (LCD_PIXEL 格式或调色板索引)
+   4 位表面: 填充时左右不满一字节的像素由 CPU 写; 复制要求裁剪后的 x 与宽度为偶数 */
+bool lcd_m2m_fill_rect(lcd_m2m* m2m, const lcd_surface* surf, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, uint16_t value, lcd_m2m_done done, void* arg);
+bool lcd_m2m_copy_rect(lcd_m2m* m2m, const lcd_surface* surf, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, const void* src, uint32_t src_stride,
+                       lcd_m2m_done done, void* arg);
+bool lcd_m2m_clear(lcd_m2m* m2m, const lcd_surface* surf, uint16_t value);
+
+void lcd_m2m_isr(lcd_m2m* m2m, bool ok);
+void lcd_m2m_wait(lcd_m2m* m2m);
+bool lcd_m2m_busy(lcd_m2m* m2m);
+
+/* DMA2 Stream0 后端, 只有 DMA2 支持存储器到存储器; 完成中断中调用 lcd_m2m_dma2_irq
+   (lcd_m2m_port.c 实现, LCD_M2M_DMA 为 1 时) */
+extern lcd_m2m lcd_m2m_dma2;
+void lcd_m2m_dma2_init(void);
+void lcd_m2m_dma2_irq(void);
+
+#endif
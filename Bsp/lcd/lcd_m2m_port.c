@@ -0,0 +1,107 @@
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lcd_port.h"
+#include "lcd_m2m.h"
+
+#if LCD_M2M_DMA
+/* DMA2 Stream0 通道 0, 优先级低于 SPI1 TX (Stream3), 不影响刷屏 */
+#define LCD_M2M_STREAM      DMA2_Stream0
+#define LCD_M2M_IRQ         DMA2_Stream0_IRQn
+#define LCD_M2M_TIMEOUT     100
+#define LCD_M2M_FLAGS       (DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | \
+                             DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0)
+
+lcd_m2m lcd_m2m_dma2;
+static void* lcd_m2m_waiter;    // 等待队列完成的任务
+
+static bool lcd_m2m_dma_start(void* ctx, const lcd_m2m_seg* seg)
+{
+    DMA_Stream_TypeDef* stream = LCD_M2M_STREAM;
+    uint32_t size = seg->width == 4 ? 2U : seg->width == 2 ? 1U : 0U;
+
+    (void)ctx;
+    if(stream->CR & DMA_SxCR_EN)
+        return false;
+
+    /* 存储器到存储器: 外设端口为源, 必须使用 FIFO; 源固定时即为填充 */
+    DMA2->LIFCR  = LCD_M2M_FLAGS;
+    stream->PAR  = (uint32_t)(uintptr_t)seg->src;
+    stream->M0AR = (uint32_t)(uintptr_t)seg->dst;
+    stream->NDTR = seg->len / seg->width;
+    stream->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+    stream->CR   = DMA_SxCR_DIR_1 | DMA_SxCR_MINC | (seg->fixed ? 0 : DMA_SxCR_PINC) |
+                   (size << DMA_SxCR_PSIZE_Pos) | (size << DMA_SxCR_MSIZE_Pos) |
+                   DMA_SxCR_PL_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    stream->CR  |= DMA_SxCR_EN;
+    return true;
+}
+
+static void lcd_m2m_dma_wait(void* ctx)
+{
+    /* 先登记再检查, 完成中断不会漏掉通知; 调度器未运行时只能轮询 */
+    if(xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        return;
+    lcd_m2m_waiter = xTaskGetCurrentTaskHandle();
+    if(lcd_m2m_busy(ctx))
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LCD_M2M_TIMEOUT));
+    lcd_m2m_waiter = NULL;
+}
+
+static void lcd_m2m_dma_notify(void* ctx)
+{
+    BaseType_t woken = pdFALSE;
+
+    (void)ctx;
+    if(!lcd_m2m_waiter)
+        return;
+    if(!__get_IPSR()) {
+        xTaskNotifyGive(lcd_m2m_waiter);
+        return;
+    }
+    vTaskNotifyGiveFromISR(lcd_m2m_waiter, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/* 只屏蔽本数据流的中断, 任务与中断中都可调用 */
+static void lcd_m2m_dma_lock(void* ctx)
+{
+    (void)ctx;
+    NVIC_DisableIRQ(LCD_M2M_IRQ);
+    __DSB();
+    __ISB();
+}
+
+static void lcd_m2m_dma_unlock(void* ctx)
+{
+    (void)ctx;
+    NVIC_EnableIRQ(LCD_M2M_IRQ);
+}
+
+static const lcd_m2m_ops lcd_m2m_dma_ops = {
+    .start  = lcd_m2m_dma_start,
+    .wait   = lcd_m2m_dma_wait,
+    .notify = lcd_m2m_dma_notify,
+    .lock   = lcd_m2m_dma_lock,
+    .unlock = lcd_m2m_dma_unlock,
+};
+
+void lcd_m2m_dma2_init(void)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    LCD_M2M_STREAM->CR = 0;
+    lcd_m2m_init(&lcd_m2m_dma2, &lcd_m2m_dma_ops, &lcd_m2m_dma2);
+
+    HAL_NVIC_SetPriority(LCD_M2M_IRQ, 5, 0);
+    HAL_NVIC_EnableIRQ(LCD_M2M_IRQ);
+}
+
+void lcd_m2m_dma2_irq(void)
+{
+    uint32_t flags = DMA2->LISR;
+
+    DMA2->LIFCR = LCD_M2M_FLAGS;
+    if(flags & (DMA_LISR_TCIF0 | DMA_LISR_TEIF0))
+        lcd_m2m_isr(&lcd_m2m_dma2, !(flags & DMA_LISR_TEIF0));
+}
+#endif
@@ -0,0 +1,179 @@
+#include "lcd_overlay.h"
+#include <string.h>
+
+static void lcd_overlay_union(lcd_rect* r, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if(r->x1 > r->x2) {
+        r->x1 = x1; r->y1 = y1;
+        r->x2 = x2; r->y2 = y2;
+        return;
+    }
+    if(x1 < r->x1) r->x1 = x1;
+    if(y1 < r->y1) r->y1 = y1;
+    if(x2 > r->x2) r->x2 = x2;
+    if(y2 > r->y2) r->y2 = y2;
+}
+
+static void lcd_overlay_empty(lcd_rect* r)
+{
+    r->x1 = r->y1 = 0;
+    r->x2 = r->y2 = -1;
+}
+
+bool lcd_overlay_init(lcd_overlay* ov, uint32_t* bits, uint32_t size,
+                      uint16_t width, uint16_t height, uint16_t color)
+{
+    ov->bits   = bits;
+    ov->alias  = 0;
+    ov->words  = LCD_OVERLAY_WORDS(width);
+    ov->width  = width;
+    ov->height = height;
+    ov->color  = color;
+    lcd_overlay_empty(&ov->ink);
+    lcd_overlay_empty(&ov->dirty);
+
+    if((uint32_t)ov->words * 4 * height > size)
+        return false;
+    memset(bits, 0, (uint32_t)ov->words * 4 * height);
+    return true;
+}
+
+void lcd_overlay_clear(lcd_overlay* ov)
+{
+    if(ov->ink.x1 > ov->ink.x2)
+        return;
+    lcd_overlay_union(&ov->dirty, ov->ink.x1, ov->ink.y1, ov->ink.x2, ov->ink.y2);
+    memset(ov->bits, 0, (uint32_t)ov->words * 4 * ov->height);
+    lcd_overlay_empty(&ov->ink);
+}
+
+void lcd_overlay_color(lcd_overlay* ov, uint16_t color)
+{
+    ov->color = color;
+    if(ov->ink.x1 <= ov->ink.x2)
+        lcd_overlay_union(&ov->dirty, ov->ink.x1, ov->ink.y1, ov->ink.x2, ov->ink.y2);
+}
+
+/* 不检查范围, 不记录改变 */
+static inline void lcd_overlay_put(lcd_overlay* ov, uint16_t x, uint16_t y, bool on)
+{
+    uint32_t bit = (uint32_t)y * ov->words * 32 + x;
+
+    if(ov->alias)
+        ov->alias[bit] = on;
+    else if(on)
+        ov->bits[bit >> 5] |= 1U << (bit & 31);
+    else
+        ov->bits[bit >> 5] &= ~(1U << (bit & 31));
+}
+
+/* 裁剪到覆盖层, 记录改变; 为空时返回 false */
+static bool lcd_overlay_touch(lcd_overlay* ov, int16_t* x1, int16_t* y1, int16_t* x2, int16_t* y2, bool on)
+{
+    if(*x1 < 0) *x1 = 0;
+    if(*y1 < 0) *y1 = 0;
+    if(*x2 >= ov->width)  *x2 = ov->width - 1;
+    if(*y2 >= ov->height) *y2 = ov->height - 1;
+    if(*x1 > *x2 || *y1 > *y2)
+        return false;
+
+    lcd_overlay_union(&ov->dirty, *x1, *y1, *x2, *y2);
+    if(on)
+        lcd_overlay_union(&ov->ink, *x1, *y1, *x2, *y2);
+    return true;
+}
+
+void lcd_overlay_pixel(lcd_overlay* ov, int16_t x, int16_t y, bool on)
+{
+    int16_t x2 = x, y2 = y;
+
+    if(lcd_overlay_touch(ov, &x, &y, &x2, &y2, on))
+        lcd_overlay_put(ov, x, y, on);
+}
+
+void lcd_overlay_fill(lcd_overlay* ov, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool on)
+{
+    if(x1 > x2) { int16_t t = x1; x1 = x2; x2 = t; }
+    if(y1 > y2) { int16_t t = y1; y1 = y2; y2 = t; }
+    if(!lcd_overlay_touch(ov, &x1, &y1, &x2, &y2, on))
+        return;
+
+    for(int16_t y = y1; y <= y2; y++)
+        for(int16_t x = x1; x <= x2; x++)
+            lcd_overlay_put(ov, x, y, on);
+}
+
+void lcd_overlay_char(lcd_overlay* ov, uint16_t x, uint16_t y, const lcd_font* font, uint16_t chr)
+{
+    const uint8_t* glyph;
+    uint16_t stride = (font->width + 7) / 8;
+    int16_t x1 = x, y1 = y, x2 = x + font->width - 1, y2 = y + font->height - 1;
+
+    if(x >= ov->width || y >= ov->height)
+        return;
+    // 置位的像素只在字模范围内, 整个字符框计入 ink
+    lcd_overlay_touch(ov, &x1, &y1, &x2, &y2, true);
+
+    glyph = &font->addr[(chr - ' ') * font->bytes];
+    for(int16_t r = 0; r <= y2 - y1; r++) {
+        const uint8_t* bits = &glyph[r * stride];
+
+        for(int16_t c = 0; c <= x2 - x1; c++)
+            lcd_overlay_put(ov, x1 + c, y1 + r, (bits[c >> 3] >> (c & 7)) & 0x01);
+    }
+}
+
+void lcd_overlay_string(lcd_overlay* ov, uint16_t x, uint16_t y, const lcd_font* font, const char* p)
+{
+    while(*p != '\0') {
+        if(x > ov->width - font->width) {
+            x = 0;
+            y += font->height;
+        }
+        lcd_overlay_char(ov, x, y, font, *p++);
+        x += font->width;
+    }
+}
+
+bool lcd_overlay_take_dirty(lcd_overlay* ov, lcd_rect* rect)
+{
+    if(ov->dirty.x1 > ov->dirty.x2)
+        return false;
+    *rect = ov->dirty;
+    lcd_overlay_empty(&ov->dirty);
+    return true;
+}
+
+bool lcd_overlay_hit(const lcd_overlay* ov, const lcd_rect* rect)
+{
+    return ov->ink.x1 <= ov->ink.x2 &&
+           ov->ink.x1 <= rect->x2 && rect->x1 <= ov->ink.x2 &&
+           ov->ink.y1 <= rect->y2 && rect->y1 <= ov->ink.y2;
+}
+
+/* 按字读取, 全 0 的字直接跳过 */
+void lcd_overlay_blend(const lcd_overlay* ov, uint16_t x, uint16_t y, uint16_t* line,
+                       uint16_t count, uint16_t pixel)
+{
+    const uint32_t* row;
+
+    if(y >= ov->height || x >= ov->width)
+        return;
+    if(x + count > ov->width)
+        count = ov->width - x;
+    row = &ov->bits[(uint32_t)y * ov->words];
+
+    for(uint16_t i = 0; i < count; ) {
+        uint16_t px = x + i;
+        uint32_t word = row[px >> 5] >> (px & 31);
+        uint16_t n = 32 - (px & 31);
+
+        if(n > count - i)
+            n = count - i;
+        for(uint16_t j = 0; word && j < n; j++, word >>= 1) {
+            if(word & 1)
+                line[i + j] = pixel;
+        }
+        i += n;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * @Describe: 1 位覆盖层, 单色 HUD 独立于显存绘制, 刷新时合成到发送的每一行
+ *            设置了位带别名时每个像素一次写入, 否则读改写所在的字
+ */
+#ifndef __LCD_OVERLAY_H
+#define __LCD_OVERLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_dirty.h"
+#include "lcd_font.h"
+
+/* 每行 32 位字数, 低位在左 */
+#define LCD_OVERLAY_WORDS(width)    (((uint32_t)(width) + 31) / 32)
+
+typedef struct __lcd_overlay {
+    uint32_t* bits;
+    volatile uint32_t* alias;   // bits 的位带别名 (每位一个字), NULL 时读改写
+    uint16_t words;             // 每行字数
+    uint16_t width, height;
+    uint16_t color;             // 置位像素的颜色 (RGB565)
+
+    lcd_rect ink;               // 可能有置位像素的范围, lcd_overlay_clear 时清空
+    lcd_rect dirty;             // 上次取走后改变的范围
+} lcd_overlay;
+
+/* size 为 bits 的字节数, 不够 height 行时返回 false */
+bool lcd_overlay_init(lcd_overlay* ov, uint32_t* bits, uint32_t size,
+                      uint16_t width, uint16_t height, uint16_t color);
+void lcd_overlay_clear(lcd_overlay* ov);
+void lcd_overlay_color(lcd_overlay* ov, uint16_t color);
+void lcd_overlay_pixel(lcd_overlay* ov, int16_t x, int16_t y, bool on);
+void lcd_overlay_fill(lcd_overlay* ov, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool on);
+/* 字模为 1 的像素置位, 为 0 的清除 (覆盖旧内容), 与 lcd_show_string_ram 相同的换行规则 */
+void lcd_overlay_char(lcd_overlay* ov, uint16_t x, uint16_t y, const lcd_font* font, uint16_t chr);
+void lcd_overlay_string(lcd_overlay* ov, uint16_t x, uint16_t y, const lcd_font* font, const char* p);
+
+/* 取走改变的范围 (无改变时返回 false) */
+bool lcd_overlay_take_dirty(lcd_overlay* ov, lcd_rect* rect);
+/* 行 y 的 [x, x + count) 中置位的像素改为 pixel (显存中的格式) */
+void lcd_overlay_blend(const lcd_overlay* ov, uint16_t x, uint16_t y, uint16_t* line,
+                       uint16_t count, uint16_t pixel);
+/* 矩形是否与 ink 相交, 不相交时发送可以跳过合成 */
+bool lcd_overlay_hit(const lcd_overlay* ov, const lcd_rect* rect);
+
+/* 使用 SRAM 位带别名, 每个像素一次写入; bits 不在位带区时返回 false, 仍读改写 (lcd_overlay_port.c 实现) */
+bool lcd_overlay_use_bitband(lcd_overlay* ov);
+
+#endif
@@ -0,0 +1,18 @@
+#include "lcd_overlay.h"
+
+/* SRAM 位带区 0x20000000 - 0x200FFFFF, 别名区从 0x22000000 开始, 每位对应一个字 */
+#define LCD_BITBAND_SRAM    0x20000000U
+#define LCD_BITBAND_SIZE    0x00100000U
+#define LCD_BITBAND_ALIAS   0x22000000U
+
+bool lcd_overlay_use_bitband(lcd_overlay* ov)
+{
+    uint32_t addr = (uint32_t)(uintptr_t)ov->bits;
+    uint32_t size = (uint32_t)ov->words * 4 * ov->height;
+
+    ov->alias = 0;
+    if(addr < LCD_BITBAND_SRAM || addr + size > LCD_BITBAND_SRAM + LCD_BITBAND_SIZE)
+        return false;
+    ov->alias = (volatile uint32_t *)(uintptr_t)(LCD_BITBAND_ALIAS + (addr - LCD_BITBAND_SRAM) * 32);
+    return true;
+}
@@ -0,0 +1,86 @@
+#include "lcd_pacer.h"
+
+void lcd_pacer_init(lcd_pacer* pacer, uint32_t period, uint8_t max_level, uint32_t now)
+{
+    pacer->period    = period ? period : 1;
+    pacer->wake      = now;
+    pacer->start     = now;
+    pacer->steps     = 1;
+    pacer->level     = 0;
+    pacer->max_level = max_level < LCD_PACE_LEVELS ? max_level : LCD_PACE_LEVELS;
+    pacer->hold      = 0;
+    pacer->calm      = 0;
+    pacer->load      = 0;
+    pacer->frames    = 0;
+    pacer->overruns  = 0;
+    pacer->skipped   = 0;
+    pacer->peak      = 0;
+}
+
+void lcd_pacer_set_period(lcd_pacer* pacer, uint32_t period)
+{
+    pacer->period = period ? period : 1;
+    pacer->hold   = LCD_PACER_SETTLE;
+    pacer->calm   = 0;
+}
+
+uint32_t lcd_pacer_begin(lcd_pacer* pacer, uint32_t now)
+{
+    pacer->start = now;
+    return pacer->steps;
+}
+
+/* 超时或平均负载过高时降档, 持续低负载时升档; 换档后等待 LCD_PACER_SETTLE 帧 */
+static void lcd_pacer_govern(lcd_pacer* pacer, uint32_t work, bool overrun)
+{
+    uint32_t load = work >= pacer->period * 4 ? 1024 : work * 256 / pacer->period;
+
+    pacer->load = (uint16_t)((pacer->load * 3 + load) / 4);
+
+    if(pacer->hold) {
+        pacer->hold--;
+        return;
+    }
+    if(overrun || pacer->load > LCD_PACER_HIGH) {
+        pacer->calm = 0;
+        if(pacer->level < pacer->max_level) {
+            pacer->level++;
+            pacer->hold = LCD_PACER_SETTLE;
+        }
+    } else if(pacer->load < LCD_PACER_LOW && pacer->level) {
+        if(++pacer->calm >= LCD_PACER_CALM) {
+            pacer->level--;
+            pacer->calm = 0;
+            pacer->hold = LCD_PACER_SETTLE;
+        }
+    } else {
+        pacer->calm = 0;
+    }
+}
+
+uint32_t lcd_pacer_end(lcd_pacer* pacer, uint32_t now)
+{
+    uint32_t work = now - pacer->start;
+    uint32_t late = (now - pacer->wake) / pacer->period;   // 已经过去的整周期数
+
+    pacer->frames++;
+    if(work > pacer->peak)
+        pacer->peak = work;
+    if(late) {
+        pacer->overruns++;
+        pacer->skipped += late;
+    }
+    lcd_pacer_govern(pacer, work, late != 0);
+
+    pacer->steps = late + 1;
+    return pacer->period * pacer->steps;
+}
+
+bool lcd_pacer_drop(const lcd_pacer* pacer, lcd_pace_lever lever)
+{
+    if(pacer->level <= lever)
+        return false;
+    if(lever == LCD_PACE_HUD)
+        return true;
+    return pacer->frames & 1;
+}
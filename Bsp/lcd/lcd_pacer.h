@@ -0,0 +1,53 @@
+/*
+ * @Describe: 帧节拍与质量调节: 固定帧周期, 记录超时, 超出预算时逐级关闭质量项
+ *            时间单位由调用者决定 (FreeRTOS tick); wake 与 vTaskDelayUntil 的 pxPreviousWakeTime 相同
+ */
+#ifndef __LCD_PACER_H
+#define __LCD_PACER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 负载 = 帧耗时 / 帧周期 * 256, 取滑动平均 */
+#define LCD_PACER_HIGH      230     // 平均负载高于 90% 时降一档
+#define LCD_PACER_LOW       154     // 平均负载连续 LCD_PACER_CALM 帧低于 60% 时升一档
+#define LCD_PACER_CALM      60
+#define LCD_PACER_SETTLE    8       // 换档后等待平均值跟上的帧数
+
+/* 质量项, 按档位依次关闭: 档位 > 项的值时生效 */
+typedef enum {
+    LCD_PACE_HUD = 0,               // 不更新 HUD
+    LCD_PACE_HALF_RATE,             // 次要对象隔帧更新
+    LCD_PACE_FLUSH,                 // 隔帧发送, 改变的区域留到下一次合并发送
+    LCD_PACE_LEVELS,                // 档位数
+} lcd_pace_lever;
+
+typedef struct __lcd_pacer {
+    uint32_t period;                // 帧周期
+    uint32_t wake;                  // 本帧计划开始的时刻, 由 vTaskDelayUntil 推进
+    uint32_t start;                 // 本帧实际开始的时刻
+    uint32_t steps;                 // 本帧距上一帧经过的周期数
+
+    uint8_t level;                  // 质量档位, 0 为全部开启
+    uint8_t max_level;
+    uint8_t hold;                   // 换档后剩余的等待帧数
+    uint8_t calm;                   // 连续低负载的帧数
+    uint16_t load;                  // 平均负载
+
+    uint32_t frames;
+    uint32_t overruns;              // 超出周期的帧数
+    uint32_t skipped;               // 因超时跳过的周期数
+    uint32_t peak;                  // 最长帧耗时
+} lcd_pacer;
+
+void lcd_pacer_init(lcd_pacer* pacer, uint32_t period, uint8_t max_level, uint32_t now);
+void lcd_pacer_set_period(lcd_pacer* pacer, uint32_t period);
+/* 帧开始, 返回距上一帧经过的周期数, 动画按此推进以保持速度与帧率无关 */
+uint32_t lcd_pacer_begin(lcd_pacer* pacer, uint32_t now);
+/* 帧结束, 更新统计与档位, 返回 vTaskDelayUntil(&pacer->wake, ...) 的增量;
+   超时后跳到下一个未过去的周期, 不追赶 */
+uint32_t lcd_pacer_end(lcd_pacer* pacer, uint32_t now);
+/* 本帧是否省略该质量项对应的工作 (隔帧项只在奇数帧省略) */
+bool lcd_pacer_drop(const lcd_pacer* pacer, lcd_pace_lever lever);
+
+#endif
@@ -0,0 +1,113 @@
+#include "lcd_palette.h"
+
+static uint16_t lcd_palette_pixel(const lcd_palette* pal, uint16_t rgb)
+{
+    return pal->swap ? (uint16_t)((rgb << 8) | (rgb >> 8)) : rgb;
+}
+
+static void lcd_palette_set(lcd_palette* pal, uint8_t index, uint16_t rgb)
+{
+    pal->rgb[index] = rgb;
+    pal->lut[index] = lcd_palette_pixel(pal, rgb);
+
+    if(pal->bpp != 4)
+        return;
+    for(uint16_t b = 0; b < 256; b++) {
+        if((b & 0x0F) == index || (b >> 4) == index)
+            pal->pair[b] = pal->lut[b & 0x0F] | ((uint32_t)pal->lut[b >> 4] << 16);
+    }
+}
+
+void lcd_palette_init(lcd_palette* pal, uint8_t bpp, bool swap)
+{
+    pal->bpp  = bpp;
+    pal->swap = swap;
+
+    for(uint16_t i = 0; i < 256; i++) {
+        pal->rgb[i]  = 0;
+        pal->lut[i]  = 0;
+        pal->pair[i] = 0;
+    }
+    pal->count = 1;
+    pal->last_rgb = 0;
+    pal->last_index = 0;
+}
+
+/* RGB565 各分量差的平方和 (绿色 6 位, 先对齐到 5 位) */
+static uint32_t lcd_palette_dist(uint16_t a, uint16_t b)
+{
+    int dr = (a >> 11) - (b >> 11);
+    int dg = ((a >> 5) & 0x3F) / 2 - ((b >> 5) & 0x3F) / 2;
+    int db = (a & 0x1F) - (b & 0x1F);
+
+    return dr * dr + dg * dg + db * db;
+}
+
+uint8_t lcd_palette_index(lcd_palette* pal, uint16_t rgb)
+{
+    uint16_t size = 1 << pal->bpp;
+    uint8_t best = 0;
+    uint32_t best_dist = UINT32_MAX;
+
+    if(rgb == pal->last_rgb)
+        return pal->last_index;
+
+    for(uint16_t i = 0; i < pal->count; i++) {
+        uint32_t d = lcd_palette_dist(rgb, pal->rgb[i]);
+
+        if(pal->rgb[i] == rgb) {
+            best = i;
+            best_dist = 0;
+            break;
+        }
+        if(d < best_dist) {
+            best = i;
+            best_dist = d;
+        }
+    }
+
+    if(best_dist && pal->count < size) {
+        best = pal->count++;
+        lcd_palette_set(pal, best, rgb);
+    }
+
+    pal->last_rgb = rgb;
+    pal->last_index = best;
+    return best;
+}
+
+void lcd_palette_expand8(const lcd_palette* pal, const uint8_t* src, uint16_t x, uint16_t* dst, uint32_t count)
+{
+    const uint16_t* lut = pal->lut;
+
+    src += x;
+    for(; count >= 4; count -= 4) {
+        dst[0] = lut[src[0]];
+        dst[1] = lut[src[1]];
+        dst[2] = lut[src[2]];
+        dst[3] = lut[src[3]];
+        src += 4;
+        dst += 4;
+    }
+    while(count--)
+        *dst++ = lut[*src++];
+}
+
+/* 每个字节查一次 pair 表得到两个像素; 起点或终点落在半个字节时单独处理 */
+void lcd_palette_expand4(const lcd_palette* pal, const uint8_t* src, uint16_t x, uint16_t* dst, uint32_t count)
+{
+    src += x >> 1;
+    if((x & 1) && count) {
+        *dst++ = pal->lut[*src++ >> 4];
+        count--;
+    }
+    for(; count >= 2; count -= 2) {
+        uint32_t two = pal->pair[*src++];
+
+        dst[0] = (uint16_t)two;
+        dst[1] = (uint16_t)(two >> 16);
+        dst += 2;
+    }
+    if(count)
+        *dst = pal->lut[*src & 0x0F];
+}
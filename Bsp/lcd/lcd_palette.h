@@ -0,0 +1,30 @@
+/*
+ * @Describe: 调色板索引像素 (8bpp/4bpp) 展开为像素缓冲格式
+ */
+#ifndef __LCD_PALETTE_H
+#define __LCD_PALETTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 索引 0 固定为黑色, memset 0 即清屏;
+ * 4bpp 时偶数像素在低半字节 */
+typedef struct __lcd_palette {
+    uint8_t bpp;                // 8 或 4
+    bool swap;                  // 展开结果交换字节序 (8 位 SPI 帧)
+    uint16_t count;             // 已分配的颜色数
+    uint16_t last_rgb;          // 上一次查找的颜色, 连续画同色时免去搜索
+    uint8_t last_index;
+    uint16_t rgb[256];          // RGB565
+    uint16_t lut[256];          // 展开后的像素
+    uint32_t pair[256];         // 4bpp: 一个字节的两个像素, 低半字为左边像素
+} lcd_palette;
+
+void lcd_palette_init(lcd_palette* pal, uint8_t bpp, bool swap);
+/* 返回颜色的索引, 新颜色在有空位时加入, 调色板满时取最接近的颜色 */
+uint8_t lcd_palette_index(lcd_palette* pal, uint16_t rgb);
+/* src 从一行的第 0 个像素开始, x 为起始像素; 展开 count 个像素到 dst */
+void lcd_palette_expand8(const lcd_palette* pal, const uint8_t* src, uint16_t x, uint16_t* dst, uint32_t count);
+void lcd_palette_expand4(const lcd_palette* pal, const uint8_t* src, uint16_t x, uint16_t* dst, uint32_t count);
+
+#endif
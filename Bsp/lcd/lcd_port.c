@@ -6,8 +6,32 @@
  * @Description: LCD屏幕底层接口实现
  */
 #include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "lcd.h"
 #include "lcd_port.h"
+#include "lcd_spi_ll.h"
+
+/* 小于该长度的数据直接阻塞发送, DMA 启动开销不划算 */
+#define LCD_DMA_MIN_LEN     64
+#define LCD_DMA_TIMEOUT     100
+
+#define LCD_DC_UNKNOWN      0xff
+
+/* SPI1/4/5 (APB2) 最高 50MHz, SPI2/3 (APB1) 最高 25MHz */
+#define LCD_SPI_APB2_MAX    50000000U
+#define LCD_SPI_APB1_MAX    25000000U
+
+/* TE 边沿后 (消隐期) 允许开始刷新的时长; 消隐期长度 (0xB2 前后沿各 12 行, 60Hz 时 344 行中的 24 行);
+   等不到 TE 时的超时 */
+#define LCD_VSYNC_GUARD_US  500
+#define LCD_VSYNC_BLANK_US  1160
+#define LCD_VSYNC_TIMEOUT   50
+
+/* 当前占用 DMA 的设备, 供完成回调查找 */
+static lcd_io* lcd_dma_owner;
+/* 打开了 TE 中断的设备 */
+static lcd_io* lcd_te_owner;
 
 /************ Hardware Port ************/
 void lcd_delay(uint32_t delay)
@@ -15,23 +39,258 @@ void lcd_delay(uint32_t delay)
     HAL_Delay(delay);
 }
 
+static bool lcd_dma_start(void* ctx, const uint8_t* data, uint32_t len)
+{
+    lcd_io* lcdio = ctx;
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+
+    /* 16 位帧模式下 HAL 以半字计数 */
+    if(hspi->Init.DataSize == SPI_DATASIZE_16BIT)
+        len /= 2;
+
+    lcd_dma_owner = lcdio;
+    return HAL_SPI_Transmit_DMA(hspi, (uint8_t *)data, len) == HAL_OK;
+}
+
+static void lcd_dma_wait(void* ctx)
+{
+    lcd_io* lcdio = ctx;
+
+    /* 调度器未运行时只能轮询 */
+    if(lcdio->waiter && lcdio->waiter == xTaskGetCurrentTaskHandle())
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LCD_DMA_TIMEOUT));
+}
+
+static lcd_bus_dev* lcd_io_finish(lcd_io* lcdio);
+
+static void lcd_dma_notify(void* ctx)
+{
+    lcd_io* lcdio = ctx;
+    BaseType_t woken = pdFALSE;
+
+    /* 事务已在任务中结束, 传输完成后才释放总线 */
+    if(lcdio->bus_pending) {
+        lcd_bus_dev* next;
+
+        lcdio->bus_pending = false;
+        next = lcd_io_finish(lcdio);
+        if(next && next->task)
+            vTaskNotifyGiveFromISR(next->task, &woken);
+    }
+
+    if(lcdio->vsync_track) {
+        lcdio->vsync_track = false;
+        lcd_vsync_done(&lcdio->vsync, DWT->CYCCNT);
+    }
+
+    if(lcdio->waiter)
+        vTaskNotifyGiveFromISR(lcdio->waiter, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static const lcd_xfer_ops lcd_dma_ops = {
+    .start  = lcd_dma_start,
+    .wait   = lcd_dma_wait,
+    .notify = lcd_dma_notify,
+};
+
+/* 单次 DMA 最多 0xffff 帧, 更长的数据由 lcd_xfer 在完成中断中分段接续 */
+static bool lcd_dma_submit(lcd_io* lcdio, const uint8_t* data, uint32_t len, bool fixed)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+
+    if(len < LCD_DMA_MIN_LEN || !hspi || !hspi->hdmatx)
+        return false;
+
+    lcdio->xfer.seg_max = LCD_DMA_MAX_LEN;
+    if(hspi->Init.DataSize == SPI_DATASIZE_16BIT)
+        lcdio->xfer.seg_max *= 2;
+
+    /* 完成中断中接续下一段时不能再取当前任务, 所以在提交时记录 */
+    lcdio->waiter = NULL;
+    if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+        lcdio->waiter = xTaskGetCurrentTaskHandle();
+
+    if(fixed)
+        return lcd_xfer_repeat(&lcdio->xfer, data, len);
+    return lcd_xfer_submit(&lcdio->xfer, data, len);
+}
+
+/* 存储器地址递增开关, 只能在 DMA 流空闲时修改 */
+static void lcd_dma_meminc(lcd_io* lcdio, bool inc)
+{
+    DMA_HandleTypeDef* hdma = ((SPI_HandleTypeDef *)lcdio->spi)->hdmatx;
+
+    hdma->Init.MemInc = inc ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    MODIFY_REG(hdma->Instance->CR, DMA_SxCR_MINC, hdma->Init.MemInc);
+}
+
+bool lcd_io_has_dma(lcd_io* lcdio)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+
+    return hspi && hspi->hdmatx;
+}
+
+/* 由 SystemCoreClock 与 SPI 所在 APB 的分频系数计算各阶段分频 */
+static void lcd_io_clock_setup(lcd_io* lcdio)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+    lcd_clock_cfg cfg = {
+        .hz = {
+            [LCD_CLK_INIT]  = LCD_CLK_INIT_HZ,
+            [LCD_CLK_CMD]   = LCD_CLK_CMD_HZ,
+            [LCD_CLK_PIXEL] = LCD_CLK_PIXEL_HZ,
+            [LCD_CLK_READ]  = LCD_CLK_READ_HZ,
+        },
+    };
+    uint32_t ppre;
+
+    if(!hspi)
+        return;
+
+    if(lcdio->clock_cfg) {
+        for(int i = 0; i < LCD_CLK_PHASES; i++)
+            cfg.hz[i] = lcdio->clock_cfg->hz[i];
+    }
+
+    if(hspi->Instance == SPI1 || hspi->Instance == SPI4 || hspi->Instance == SPI5) {
+        ppre = (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos;
+        cfg.spi_max = LCD_SPI_APB2_MAX;
+    } else {
+        ppre = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+        cfg.spi_max = LCD_SPI_APB1_MAX;
+    }
+
+    lcd_clock_profile_make(&lcdio->clock,
+                           lcd_clock_pclk(SystemCoreClock, 1U << APBPrescTable[ppre]), &cfg);
+}
+
+void lcd_io_init(lcd_io* lcdio)
+{
+    lcd_xfer_init(&lcdio->xfer, &lcd_dma_ops, lcdio);
+    lcdio->dc_level = LCD_DC_UNKNOWN;
+    lcdio->bus_depth = 0;
+    lcdio->bus_pending = false;
+    lcdio->vsync_track = false;
+    lcd_io_clock_setup(lcdio);
+}
+
+/* 复位与初始化序列期间使用保守时钟, 结束后按命令/像素数据分档 */
+void lcd_io_clock_init(lcd_io* lcdio, bool flag)
+{
+    lcdio->clock_init = flag;
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+    if(lcd_dma_owner && lcd_dma_owner->spi == hspi)
+        lcd_xfer_isr(&lcd_dma_owner->xfer);
+}
+
+/* 错误 (DMA 传输错误/SPI 模式错误等) 不是完成: 中止传输, 等待者通过 xfer.error 得知 */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
+{
+    if(lcd_dma_owner && lcd_dma_owner->spi == hspi)
+        lcd_xfer_abort(&lcd_dma_owner->xfer);
+}
+
 static void lcd_io_ctrl(gpio_io* io, bool flag)
 {
-    if(io && io->port)
+    if(io && io->port) {
+#if LCD_PORT_LL
+        lcd_ll_pin(io->port, io->pin, flag ^ io->invert);
+#else
         HAL_GPIO_WritePin(io->port, io->pin, flag ^ io->invert);
+#endif
+    }
+}
+
+/* 切换 SPI 帧宽度, DFF 只能在 SPI 关闭时修改 (HAL 发送时会重新使能) */
+static void lcd_spi_frame(lcd_io* lcdio, bool wide)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+    uint32_t size = wide ? SPI_DATASIZE_16BIT : SPI_DATASIZE_8BIT;
+
+    if(!hspi || hspi->Init.DataSize == size)
+        return;
+
+    __HAL_SPI_DISABLE(hspi);
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_DFF, size);
+    hspi->Init.DataSize = size;
+
+    if(hspi->hdmatx) {
+        DMA_HandleTypeDef* hdma = hspi->hdmatx;
+
+        hdma->Init.PeriphDataAlignment = wide ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE;
+        hdma->Init.MemDataAlignment    = wide ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+        MODIFY_REG(hdma->Instance->CR, DMA_SxCR_PSIZE | DMA_SxCR_MSIZE,
+                   hdma->Init.PeriphDataAlignment | hdma->Init.MemDataAlignment);
+    }
 }
 
-static void lcd_spi_transmit(void* spi, uint8_t* data, uint32_t len)
+/* 切换 SCK 分频, BR 同样只能在 SPI 关闭时修改 */
+static void lcd_spi_clock(lcd_io* lcdio, lcd_clk_phase phase)
 {
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+    uint32_t prescaler;
+
+    if(lcdio->clock_init)
+        phase = LCD_CLK_INIT;
+    prescaler = (uint32_t)lcdio->clock.br[phase] << SPI_CR1_BR_Pos;
+
+    if(!hspi || hspi->Init.BaudRatePrescaler == prescaler)
+        return;
+
+    __HAL_SPI_DISABLE(hspi);
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, prescaler);
+    hspi->Init.BaudRatePrescaler = prescaler;
+}
+
+/* 应用本设备的 CPOL/CPHA, 同一总线上的设备可以使用不同模式 */
+static void lcd_spi_mode(lcd_io* lcdio)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+    uint32_t mode = lcdio->spi_mode & (SPI_CR1_CPOL | SPI_CR1_CPHA);
+
+    if(!hspi || lcdio->spi_mode == LCD_SPI_MODE_INIT)
+        return;
+    if(READ_BIT(hspi->Instance->CR1, SPI_CR1_CPOL | SPI_CR1_CPHA) == mode)
+        return;
+
+    __HAL_SPI_DISABLE(hspi);
+    MODIFY_REG(hspi->Instance->CR1, SPI_CR1_CPOL | SPI_CR1_CPHA, mode);
+    hspi->Init.CLKPolarity = mode & SPI_CR1_CPOL;
+    hspi->Init.CLKPhase    = mode & SPI_CR1_CPHA;
+}
+
+/* len 为字节数 */
+static void lcd_spi_transmit(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    SPI_HandleTypeDef* spi = lcdio->spi;
+
+    lcd_xfer_wait(&lcdio->xfer);
+#if LCD_PORT_LL
+    if(spi)
+        lcd_ll_write((lcd_ll_spi *)spi->Instance, data, len);
+#else
+    uint32_t width = 1;
+
+    if(spi && spi->Init.DataSize == SPI_DATASIZE_16BIT)
+        width = 2;
+    len /= width;
+
     while(spi && len) {
         if(len > 0xffff) {
             len -= 0xffff;
             HAL_SPI_Transmit(spi, data, 0xffff, 0xffff);
+            data += 0xffff * width;
         } else {
             HAL_SPI_Transmit(spi, data, len, 0xffff);
             break;
         }
     }
+#endif
 }
 
 /************ GPIO ************/
@@ -50,34 +309,341 @@ void lcd_io_cs(lcd_io* lcdio, bool flag)
     lcd_io_ctrl(&lcdio->cs, flag);
 }
 
+/* 连续数据写入时跳过重复的 DC 翻转 */
 void lcd_io_dc(lcd_io* lcdio, bool flag)
 {
+    if(lcdio->dc_level == flag)
+        return;
+
     lcd_io_ctrl(&lcdio->dc, flag);
+    lcdio->dc_level = flag;
+}
+
+/************ 总线事务 ************/
+/* 完成中断中也会调用, 中断里只能改引脚和链表 */
+static uint32_t lcd_bus_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    return primask;
+}
+
+static void lcd_bus_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/* 拉高 CS 并把总线交给下一个等待者, 返回它 */
+static lcd_bus_dev* lcd_io_finish(lcd_io* lcdio)
+{
+    lcd_io_cs(lcdio, 1);
+    if(lcdio->bus)
+        return lcd_bus_release(lcdio->bus, &lcdio->bus_dev);
+    return NULL;
+}
+
+/* 同一个 lcd_io 只能由一个任务使用; 总线被占用时阻塞到被移交 */
+void lcd_io_begin(lcd_io* lcdio)
+{
+    uint32_t primask;
+
+    if(lcdio->bus_depth++)
+        return;
+
+    /* 上一个事务的 DMA 结束后总线才会释放 */
+    lcd_xfer_wait(&lcdio->xfer);
+
+    if(lcdio->bus) {
+        lcdio->bus_dev.task = NULL;
+        if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+            lcdio->bus_dev.task = xTaskGetCurrentTaskHandle();
+
+        primask = lcd_bus_lock();
+        lcd_bus_acquire(lcdio->bus, &lcdio->bus_dev);
+        lcd_bus_unlock(primask);
+
+        /* 通知可能残留, 以所有权为准 */
+        while(!lcd_bus_owned(lcdio->bus, &lcdio->bus_dev)) {
+            if(lcdio->bus_dev.task)
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+
+    /* 其他设备可能改过 SPI 模式或共用 DC 线 */
+    lcd_spi_mode(lcdio);
+    lcdio->dc_level = LCD_DC_UNKNOWN;
+    lcd_io_cs(lcdio, 0);
+}
+
+/* 异步传输未完成时立即返回, 由完成中断拉高 CS 并移交总线 */
+void lcd_io_end(lcd_io* lcdio)
+{
+    lcd_bus_dev* next = NULL;
+    uint32_t primask;
+
+    if(!lcdio->bus_depth || --lcdio->bus_depth)
+        return;
+
+    primask = lcd_bus_lock();
+    if(lcd_xfer_busy(&lcdio->xfer))
+        lcdio->bus_pending = true;
+    else
+        next = lcd_io_finish(lcdio);
+    lcd_bus_unlock(primask);
+
+    if(next && next->task)
+        xTaskNotifyGive(next->task);
+}
+
+/************ TE 同步 ************/
+static IRQn_Type lcd_te_irq(uint16_t pin)
+{
+    if(pin >= GPIO_PIN_10)
+        return EXTI15_10_IRQn;
+    if(pin >= GPIO_PIN_5)
+        return EXTI9_5_IRQn;
+
+    /* EXTI0 ~ EXTI4 中断号连续 */
+    for(int i = 1; i < 5; i++) {
+        if(pin == (1U << i))
+            return (IRQn_Type)(EXTI0_IRQn + i);
+    }
+    return EXTI0_IRQn;
+}
+
+/* TE 引脚配置为外部中断, 时间戳使用 DWT 周期计数 */
+void lcd_io_te(lcd_io* lcdio, bool on)
+{
+    GPIO_InitTypeDef init = { 0 };
+    IRQn_Type irq;
+
+    if(!lcdio->te.port)
+        return;
+    irq = lcd_te_irq(lcdio->te.pin);
+
+    if(!on) {
+        HAL_NVIC_DisableIRQ(irq);
+        HAL_GPIO_DeInit(lcdio->te.port, lcdio->te.pin);
+        lcdio->vsync_on = false;
+        lcd_te_owner = NULL;
+        return;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    lcd_vsync_init(&lcdio->vsync, LCD_VSYNC_GUARD_US * (SystemCoreClock / 1000000U),
+                   LCD_VSYNC_BLANK_US * (SystemCoreClock / 1000000U));
+
+    init.Pin  = lcdio->te.pin;
+    init.Mode = lcdio->te.invert ? GPIO_MODE_IT_FALLING : GPIO_MODE_IT_RISING;
+    init.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(lcdio->te.port, &init);
+
+    lcd_te_owner = lcdio;
+    lcdio->vsync_on = true;
+    HAL_NVIC_SetPriority(irq, 5, 0);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t pin)
+{
+    lcd_io* lcdio = lcd_te_owner;
+    BaseType_t woken = pdFALSE;
+
+    if(!lcdio || lcdio->te.pin != pin)
+        return;
+
+    if(lcd_vsync_edge(&lcdio->vsync, DWT->CYCCNT) && lcdio->vsync_waiter) {
+        vTaskNotifyGiveFromISR(lcdio->vsync_waiter, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+/* 阻塞到刷新窗口; 未打开 TE 时直接返回 */
+void lcd_io_vsync_begin(lcd_io* lcdio)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(LCD_VSYNC_TIMEOUT);
+    uint32_t primask;
+    bool start;
+
+    if(!lcdio->vsync_on || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        return;
+
+    lcdio->vsync_waiter = xTaskGetCurrentTaskHandle();
+    primask = lcd_bus_lock();
+    start = lcd_vsync_request(&lcdio->vsync, DWT->CYCCNT);
+    lcd_bus_unlock(primask);
+
+    /* 通知可能残留, 以 pending 是否被 TE 中断清除为准 */
+    while(!start) {
+        TickType_t now = xTaskGetTickCount();
+
+        if((int32_t)(deadline - now) > 0)
+            ulTaskNotifyTake(pdTRUE, deadline - now);
+
+        primask = lcd_bus_lock();
+        if(!lcdio->vsync.pending) {
+            start = true;
+        } else if((int32_t)(deadline - xTaskGetTickCount()) <= 0) {
+            lcd_vsync_force(&lcdio->vsync, DWT->CYCCNT);
+            start = true;
+        }
+        lcd_bus_unlock(primask);
+    }
+
+    /* 刷新慢于扫描时等扫描离开消隐期, 最多一个消隐期 */
+    while((int32_t)(DWT->CYCCNT - lcdio->vsync.start) < 0);
+}
+
+/* 刷新已提交: DMA 仍在进行时由完成中断记录耗时 */
+void lcd_io_vsync_end(lcd_io* lcdio)
+{
+    uint32_t primask;
+
+    if(!lcdio->vsync_on)
+        return;
+
+    primask = lcd_bus_lock();
+    if(lcd_xfer_busy(&lcdio->xfer))
+        lcdio->vsync_track = true;
+    else
+        lcd_vsync_done(&lcdio->vsync, DWT->CYCCNT);
+    lcd_bus_unlock(primask);
 }
 
 /************ SPI ************/
 void lcd_write_byte(lcd_io* lcdio, uint8_t data)
 {
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, false);
+    lcd_spi_clock(lcdio, LCD_CLK_CMD);
     lcd_io_dc(lcdio, 1);
-    lcd_spi_transmit(lcdio->spi, &data, 0x01);
+    lcd_spi_transmit(lcdio, &data, 0x01);
 }
 
 void lcd_write_halfword(lcd_io* lcdio, uint16_t data)
 {
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, LCD_SPI_16BIT);
+    lcd_spi_clock(lcdio, LCD_CLK_CMD);
     lcd_io_dc(lcdio, 1);
-    /* note: 使用HAL库一次发送两个字节顺序与屏幕定义顺序相反 */
-    data = (data << 8) | (data >> 8);
-    lcd_spi_transmit(lcdio->spi, (uint8_t *)&data, 0x02);
+    /* note: 8 位帧一次发送两个字节时顺序与屏幕定义顺序相反, 16 位帧高字节先发 */
+    data = LCD_PIXEL(data);
+    lcd_spi_transmit(lcdio, (uint8_t *)&data, 0x02);
 }
 
 void lcd_write_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len)
 {
-    lcd_io_dc(lcdio, 1);
-    lcd_spi_transmit(lcdio->spi, (uint8_t *)data, len);
+    lcd_write_bulk_async(lcdio, data, len);
+    lcd_write_wait(lcdio);
 }
 
 void lcd_write_reg(lcd_io* lcdio, uint8_t data)	 
 {	
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, false);
+    lcd_spi_clock(lcdio, LCD_CLK_CMD);
     lcd_io_dc(lcdio, 0);
-    lcd_spi_transmit(lcdio->spi, &data, 0x01);
-}
\ No newline at end of file
+    lcd_spi_transmit(lcdio, &data, 0x01);
+}
+
+static void lcd_cmd_send(void* ctx, bool dc, const uint8_t* data, uint32_t len)
+{
+    lcd_io* lcdio = ctx;
+
+    lcd_io_dc(lcdio, dc);
+    lcd_spi_transmit(lcdio, (uint8_t *)data, len);
+}
+
+/* 批量发送命令包, 每包只切换一次 DC */
+void lcd_write_cmds(lcd_io* lcdio, lcd_cmd_queue* queue)
+{
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, false);
+    lcd_spi_clock(lcdio, LCD_CLK_CMD);
+    lcd_cmd_flush(queue, lcd_cmd_send, lcdio);
+}
+
+/* 启动后立即返回, data 在传输完成前不可修改 */
+void lcd_write_bulk_async(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, false);
+    lcd_spi_clock(lcdio, LCD_CLK_PIXEL);
+    lcd_io_dc(lcdio, 1);
+
+    if(!lcd_dma_submit(lcdio, data, len, false))
+        lcd_spi_transmit(lcdio, data, len);
+}
+
+/* 发送 LCD_PIXEL 格式的像素, count 为像素个数 */
+void lcd_write_pixels(lcd_io* lcdio, const uint16_t* data, uint32_t count)
+{
+    lcd_write_pixels_async(lcdio, data, count);
+    lcd_write_wait(lcdio);
+}
+
+void lcd_write_pixels_async(lcd_io* lcdio, const uint16_t* data, uint32_t count)
+{
+    uint32_t len = count * 2;
+
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, LCD_SPI_16BIT);
+    lcd_spi_clock(lcdio, LCD_CLK_PIXEL);
+    lcd_io_dc(lcdio, 1);
+
+    if(!lcd_dma_submit(lcdio, (const uint8_t *)data, len, false))
+        lcd_spi_transmit(lcdio, (uint8_t *)data, len);
+}
+
+/* DMA 源地址不递增, 重复发送同一像素 count 次, CPU 不参与;
+   需要 16 位帧 (8 位帧只能重复单个字节), 不可用时返回 false */
+bool lcd_write_repeat(lcd_io* lcdio, uint16_t pixel, uint32_t count)
+{
+    uint32_t error;
+    bool ok;
+
+    if(!LCD_SPI_16BIT || !lcd_io_has_dma(lcdio))
+        return false;
+
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, true);
+    lcd_spi_clock(lcdio, LCD_CLK_PIXEL);
+    lcd_io_dc(lcdio, 1);
+
+    lcdio->fill_pixel = pixel;
+    lcd_dma_meminc(lcdio, false);
+    error = lcdio->xfer.error;
+    ok = lcd_dma_submit(lcdio, (const uint8_t *)&lcdio->fill_pixel, count * 2, true);
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_dma_meminc(lcdio, true);
+
+    /* 后续分段接续失败时只发送了一部分, 同样返回 false 由调用者整块重发 */
+    return ok && lcdio->xfer.error == error;
+}
+
+void lcd_write_wait(lcd_io* lcdio)
+{
+    lcd_xfer_wait(&lcdio->xfer);
+}
+
+/* 1LINE 模式下切换为接收, 主机在 SPE 使能期间持续输出时钟;
+   HAL 接收结束时关闭 SPI, 多出的时钟在 CS 拉高后无影响, 发送时会切回 BIDIOE */
+void lcd_read_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    SPI_HandleTypeDef* hspi = lcdio->spi;
+
+    lcd_xfer_wait(&lcdio->xfer);
+    lcd_spi_frame(lcdio, false);
+    lcd_spi_clock(lcdio, LCD_CLK_READ);
+    lcd_io_dc(lcdio, 1);
+
+    while(hspi && len) {
+        uint16_t n = len > 0xffff ? 0xffff : len;
+
+        HAL_SPI_Receive(hspi, data, n, 0xffff);
+        data += n;
+        len  -= n;
+    }
+}
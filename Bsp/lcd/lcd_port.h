@@ -11,6 +11,47 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "lcd_xfer.h"
+#include "lcd_cmd.h"
+#include "lcd_clock.h"
+#include "lcd_bus.h"
+#include "lcd_vsync.h"
+
+/* 像素数据使用 16 位 SPI 帧发送, 像素缓冲保存本机字节序 RGB565;
+   为 0 时使用 8 位帧, 像素缓冲保存交换过字节序的 RGB565 */
+#ifndef LCD_SPI_16BIT
+#define LCD_SPI_16BIT   1
+#endif
+
+/* 阻塞发送与 DC/CS 控制直接操作寄存器; 为 0 时使用 HAL_SPI_Transmit/HAL_GPIO_WritePin */
+#ifndef LCD_PORT_LL
+#define LCD_PORT_LL     1
+#endif
+
+/* 分块哈希使用片上 CRC 单元 (lcd_tile_hash_crc); 为 0 时使用软件 CRC */
+#ifndef LCD_TILE_HW_CRC
+#define LCD_TILE_HW_CRC 1
+#endif
+
+/* 显存清屏/填充/复制使用 DMA2 存储器到存储器传输 (lcd_m2m_dma2, Stream0); 为 0 时不编译 */
+#ifndef LCD_M2M_DMA
+#define LCD_M2M_DMA     1
+#endif
+
+/* 单次 DMA 最多发送的帧数 (NDTR 16 位) */
+#define LCD_DMA_MAX_LEN 0xffff
+
+/* SPI 模式 (CPOL/CPHA), 每个事务开始时应用; LCD_SPI_MODE_INIT 沿用 MX_SPIx_Init 的配置 */
+#define LCD_SPI_MODE_INIT           0
+#define LCD_SPI_MODE(cpol, cpha)    (0x80 | ((cpol) << 1) | (cpha))
+
+/* RGB565 颜色 -> 像素缓冲中的存储格式 */
+#if LCD_SPI_16BIT
+#define LCD_PIXEL(c)    ((uint16_t)(c))
+#else
+#define LCD_PIXEL(c)    ((uint16_t)(((c) << 8) | ((uint16_t)(c) >> 8)))
+#endif
+
 typedef struct __gpio_io {
     void* port;
     uint16_t pin;
@@ -24,17 +65,56 @@ typedef struct __lcd_io {
     gpio_io cs;
     gpio_io dc;
     gpio_io te;
+
+    lcd_xfer xfer;      // 异步批量传输 (SPI TX DMA)
+    void* waiter;       // 等待传输完成的任务
+    uint8_t dc_level;   // DC 当前电平缓存, LCD_DC_UNKNOWN 表示未知
+    uint16_t fill_pixel;    // DMA 重复发送的像素
+    lcd_clock_profile clock;    // 各阶段 SCK 分频
+    bool clock_init;        // 初始化阶段, 所有传输使用 LCD_CLK_INIT 档
+    const lcd_clock_cfg* clock_cfg; // 本设备各阶段目标 SCK, NULL 使用默认值
+    uint8_t spi_mode;       // LCD_SPI_MODE(cpol, cpha)
+
+    lcd_bus* bus;           // 共享总线, NULL 表示独占 (CS 仍按事务控制)
+    lcd_bus_dev bus_dev;    // 总线排队节点, bus_dev.priority 由用户设置
+    uint8_t bus_depth;      // 事务嵌套深度
+    volatile bool bus_pending;  // DMA 未完成, 由完成中断结束事务
+
+    lcd_vsync vsync;        // TE 同步刷新调度, 时间单位为 DWT 周期
+    bool vsync_on;          // 已打开 TE 中断
+    volatile bool vsync_track;  // 刷新 DMA 未完成, 由完成中断记录耗时
+    void* vsync_waiter;     // 等待 TE 的任务
 } lcd_io;
 
 void lcd_delay(uint32_t delay);
+void lcd_io_init(lcd_io* lcdio);
 void lcd_io_rst(lcd_io* lcdio, bool flag);
 void lcd_io_bl(lcd_io* lcdio, bool flag);
 void lcd_io_cs(lcd_io* lcdio, bool flag);
 void lcd_io_dc(lcd_io* lcdio, bool flag);
+void lcd_io_clock_init(lcd_io* lcdio, bool flag);
+/****** 总线事务: 占用总线并拉低 CS, 可嵌套 ******/
+void lcd_io_begin(lcd_io* lcdio);
+void lcd_io_end(lcd_io* lcdio);
+/****** TE 同步: 面板需先打开 TE 输出 (0x35) ******/
+void lcd_io_te(lcd_io* lcdio, bool on);
+void lcd_io_vsync_begin(lcd_io* lcdio);
+void lcd_io_vsync_end(lcd_io* lcdio);
 /****** 底层接口 SPI  ******/
 void lcd_write_byte(lcd_io* lcdio, uint8_t data);
 void lcd_write_halfword(lcd_io* lcdio, uint16_t data);
 void lcd_write_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len);
 void lcd_write_reg(lcd_io* lcdio, uint8_t data);
+void lcd_write_cmds(lcd_io* lcdio, lcd_cmd_queue* queue);
+/****** 异步批量发送, 完成后通过任务通知唤醒调用者 ******/
+void lcd_write_bulk_async(lcd_io* lcdio, uint8_t* data, uint32_t len);
+void lcd_write_wait(lcd_io* lcdio);
+/****** 读取面板数据 (半双工, 使用 LCD_CLK_READ 档) ******/
+void lcd_read_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len);
+/****** 像素数据 (LCD_PIXEL 格式), count 为像素个数 ******/
+void lcd_write_pixels(lcd_io* lcdio, const uint16_t* data, uint32_t count);
+void lcd_write_pixels_async(lcd_io* lcdio, const uint16_t* data, uint32_t count);
+bool lcd_write_repeat(lcd_io* lcdio, uint16_t pixel, uint32_t count);
+bool lcd_io_has_dma(lcd_io* lcdio);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "lcd_rmw.h"
+
+/* size 字节的暂存区一次可以读回的像素数 */
+uint32_t lcd_rmw_capacity(uint32_t size)
+{
+    if(size <= LCD_RAMRD_DUMMY)
+        return 0;
+    return (size - LCD_RAMRD_DUMMY) / LCD_RAMRD_BPP;
+}
+
+/* RGB666 (3 字节) -> RGB565; out 可以与 rgb 所在缓冲重叠 (写入位置始终落后于读取位置) */
+void lcd_rmw_unpack(const uint8_t* rgb, uint16_t* out, uint32_t count)
+{
+    for(uint32_t i = 0; i < count; i++) {
+        uint8_t r = rgb[0], g = rgb[1], b = rgb[2];
+
+        out[i] = (uint16_t)(((r & 0xf8) << 8) | ((g & 0xfc) << 3) | (b >> 3));
+        rgb += LCD_RAMRD_BPP;
+    }
+}
+
+/* fg 以 alpha/255 的比例叠加到 bg 上 */
+uint16_t lcd_rmw_blend(uint16_t fg, uint16_t bg, uint8_t alpha)
+{
+    uint32_t a = alpha, na = 255 - alpha;
+    uint32_t r = (((fg >> 11) & 0x1f) * a + ((bg >> 11) & 0x1f) * na) / 255;
+    uint32_t g = (((fg >> 5) & 0x3f) * a + ((bg >> 5) & 0x3f) * na) / 255;
+    uint32_t b = ((fg & 0x1f) * a + (bg & 0x1f) * na) / 255;
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+/* 区域按暂存区大小切块, 每块依次: 窗口+RAMRD, 读回, 修改, RAMWR, 写回;
+   scratch 需按 2 字节对齐; 暂存区放不下一个像素时返回 false */
+bool lcd_rmw_region(const lcd_rmw_ops* ops, void* ctx,
+                    uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                    uint8_t* scratch, uint32_t size, lcd_rmw_fn fn, void* arg)
+{
+    uint32_t cap = lcd_rmw_capacity(size);
+    uint16_t tile_w, tile_h;
+    uint16_t* pixels = (uint16_t *)scratch;
+
+    if(!cap || !w || !h)
+        return false;
+
+    tile_w = w < cap ? w : (uint16_t)cap;
+    tile_h = cap / tile_w < h ? (uint16_t)(cap / tile_w) : h;
+
+    for(uint16_t ty = 0; ty < h; ty += tile_h) {
+        uint16_t th = h - ty < tile_h ? h - ty : tile_h;
+
+        for(uint16_t tx = 0; tx < w; tx += tile_w) {
+            uint16_t tw = w - tx < tile_w ? w - tx : tile_w;
+            uint32_t count = (uint32_t)tw * th;
+            uint16_t x1 = x + tx, y1 = y + ty;
+
+            ops->address(ctx, x1, y1, x1 + tw - 1, y1 + th - 1, true);
+            ops->read(ctx, scratch, LCD_RAMRD_DUMMY + count * LCD_RAMRD_BPP);
+            lcd_rmw_unpack(scratch + LCD_RAMRD_DUMMY, pixels, count);
+
+            fn(arg, x1, y1, tw, th, pixels);
+
+            ops->address(ctx, x1, y1, x1 + tw - 1, y1 + th - 1, false);
+            ops->write(ctx, pixels, count);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,34 @@
+/*
+ * @Describe: 面板 GRAM 读-改-写 (RAMRD 0x2E) 的分块与时序
+ */
+#ifndef __LCD_RMW_H
+#define __LCD_RMW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 串口读 RAMRD 时先输出一个无效字节, 之后每像素 3 字节 (R/G/B 各 6 位, 高位对齐) */
+#define LCD_RAMRD_DUMMY     1
+#define LCD_RAMRD_BPP       3
+
+/* 修改回调: pixels 为 w*h 个 RGB565 (本机字节序), 原地修改 */
+typedef void (*lcd_rmw_fn)(void* arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                           uint16_t* pixels);
+
+typedef struct __lcd_rmw_ops {
+    /* 设置窗口并发送 RAMRD (read) 或 RAMWR */
+    void (*address)(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, bool read);
+    /* 读取 RAMRD 之后的 len 个字节 (含无效字节) */
+    void (*read)(void* ctx, uint8_t* data, uint32_t len);
+    /* 写入 RGB565 像素, 可原地转换格式 */
+    void (*write)(void* ctx, uint16_t* pixels, uint32_t count);
+} lcd_rmw_ops;
+
+uint32_t lcd_rmw_capacity(uint32_t size);
+void lcd_rmw_unpack(const uint8_t* rgb, uint16_t* out, uint32_t count);
+uint16_t lcd_rmw_blend(uint16_t fg, uint16_t bg, uint8_t alpha);
+bool lcd_rmw_region(const lcd_rmw_ops* ops, void* ctx,
+                    uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                    uint8_t* scratch, uint32_t size, lcd_rmw_fn fn, void* arg);
+
+#endif
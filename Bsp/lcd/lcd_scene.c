@@ -0,0 +1,150 @@
+#include "lcd_scene.h"
+
+void lcd_scene_init(lcd_scene* scene, lcd_prim* prim, uint16_t max, uint16_t width, uint16_t height)
+{
+    scene->prim   = prim;
+    scene->max    = max;
+    scene->width  = width;
+    scene->height = height;
+    scene->clear  = 0;
+    lcd_scene_clip(scene, 0, 0, width - 1, height - 1);
+    lcd_scene_reset(scene);
+}
+
+void lcd_scene_clip(lcd_scene* scene, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    scene->cx1 = x1 > 0 ? x1 : 0;
+    scene->cy1 = y1 > 0 ? y1 : 0;
+    scene->cx2 = x2 < scene->width  ? x2 : scene->width - 1;
+    scene->cy2 = y2 < scene->height ? y2 : scene->height - 1;
+}
+
+void lcd_scene_reset(lcd_scene* scene)
+{
+    scene->count = 0;
+}
+
+static lcd_prim* lcd_scene_add(lcd_scene* scene, uint8_t type)
+{
+    lcd_prim* prim;
+
+    if(scene->count >= scene->max)
+        return 0;
+    prim = &scene->prim[scene->count++];
+    prim->type = type;
+    prim->cx1 = scene->cx1;
+    prim->cy1 = scene->cy1;
+    prim->cx2 = scene->cx2;
+    prim->cy2 = scene->cy2;
+    return prim;
+}
+
+bool lcd_scene_line(lcd_scene* scene, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    lcd_prim* prim = lcd_scene_add(scene, LCD_PRIM_LINE);
+
+    if(!prim)
+        return false;
+    prim->x1 = x1;
+    prim->y1 = y1;
+    prim->x2 = x2;
+    prim->y2 = y2;
+    prim->color = color;
+    return true;
+}
+
+bool lcd_scene_char(lcd_scene* scene, uint16_t x, uint16_t y, const uint8_t* glyph,
+                    uint16_t w, uint16_t h, uint16_t color, uint16_t back)
+{
+    lcd_prim* prim;
+
+    // 起点在屏幕外的字符整个不画
+    if(x >= scene->width || y >= scene->height)
+        return true;
+    prim = lcd_scene_add(scene, LCD_PRIM_CHAR);
+    if(!prim)
+        return false;
+    prim->x1 = x;
+    prim->y1 = y;
+    prim->x2 = w;
+    prim->y2 = h;
+    prim->color = color;
+    prim->back  = back;
+    prim->glyph = glyph;
+    return true;
+}
+
+/* Bresenham, 与 lcd_anim 的整帧画线相同: 终点之后多走一步 */
+static void lcd_raster_line(const lcd_scene* scene, const lcd_prim* prim,
+                            int16_t y, int16_t y_end, uint16_t* buf)
+{
+    int xerr = 0, yerr = 0;
+    int delta_x = prim->x2 - prim->x1, delta_y = prim->y2 - prim->y1;
+    int distance, incx, incy, row, col;
+    int lo = prim->y1 < prim->y2 ? prim->y1 : prim->y2;
+    int hi = prim->y1 > prim->y2 ? prim->y1 : prim->y2;
+    int top = y > prim->cy1 ? y : prim->cy1;
+    int bottom = y_end < prim->cy2 + 1 ? y_end : prim->cy2 + 1;
+
+    // 多走的一步最多超出终点 1 行
+    if(top >= bottom || hi + 1 < top || lo - 1 >= bottom)
+        return;
+
+    if(delta_x > 0) incx = 1;
+    else if(delta_x == 0) incx = 0;
+    else { incx = -1; delta_x = -delta_x; }
+
+    if(delta_y > 0) incy = 1;
+    else if(delta_y == 0) incy = 0;
+    else { incy = -1; delta_y = -delta_y; }
+
+    row = prim->x1;
+    col = prim->y1;
+    distance = delta_x > delta_y ? delta_x : delta_y;
+
+    for(int t = 0; t <= distance + 1; t++) {
+        if(row >= prim->cx1 && row <= prim->cx2 && col >= top && col < bottom)
+            buf[(col - y) * scene->width + row] = prim->color;
+        xerr += delta_x;
+        yerr += delta_y;
+        if(xerr > distance) { xerr -= distance; row += incx; }
+        if(yerr > distance) { yerr -= distance; col += incy; }
+    }
+}
+
+static void lcd_raster_char(const lcd_scene* scene, const lcd_prim* prim,
+                            int16_t y, int16_t y_end, uint16_t* buf)
+{
+    uint16_t stride = (prim->x2 + 7) / 8;
+    int16_t top = y > prim->cy1 ? y : prim->cy1;
+    int16_t bottom = y_end < prim->cy2 + 1 ? y_end : prim->cy2 + 1;
+    int16_t r0 = prim->y1 > top ? 0 : top - prim->y1;
+    int16_t r1 = prim->y1 + prim->y2 < bottom ? prim->y2 : bottom - prim->y1;
+    int16_t c0 = prim->x1 > prim->cx1 ? 0 : prim->cx1 - prim->x1;
+    int16_t c1 = prim->x1 + prim->x2 <= prim->cx2 ? prim->x2 : prim->cx2 + 1 - prim->x1;
+
+    for(int16_t r = r0; r < r1; r++) {
+        const uint8_t* bits = &prim->glyph[r * stride];
+        uint16_t* line = &buf[(prim->y1 + r - y) * scene->width];
+
+        for(int16_t c = c0; c < c1; c++)
+            line[prim->x1 + c] = (bits[c >> 3] >> (c & 7)) & 0x01 ? prim->color : prim->back;
+    }
+}
+
+void lcd_scene_raster(const lcd_scene* scene, uint16_t y, uint16_t rows, uint16_t* buf)
+{
+    int16_t y_end = y + rows < scene->height ? y + rows : scene->height;
+
+    for(uint32_t i = 0; i < (uint32_t)scene->width * rows; i++)
+        buf[i] = scene->clear;
+
+    for(uint16_t i = 0; i < scene->count; i++) {
+        const lcd_prim* prim = &scene->prim[i];
+
+        if(prim->type == LCD_PRIM_LINE)
+            lcd_raster_line(scene, prim, y, y_end, buf);
+        else
+            lcd_raster_char(scene, prim, y, y_end, buf);
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * @Describe: 图元列表, 按水平条带光栅化
+ *            结果与直接画到整帧显存逐像素相同
+ */
+#ifndef __LCD_SCENE_H
+#define __LCD_SCENE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LCD_PRIM_LINE = 0,
+    LCD_PRIM_CHAR,
+} lcd_prim_type;
+
+/* 颜色为像素缓冲格式 (LCD_PIXEL) */
+typedef struct __lcd_prim {
+    uint8_t type;
+    int16_t x1, y1;             // 线段起点 / 字符左上角
+    int16_t x2, y2;             // 线段终点 / 字符宽高
+    uint16_t color;
+    uint16_t back;              // 字符背景色
+    const uint8_t* glyph;       // 字模, 每行 (宽+7)/8 字节, 低位在左
+    int16_t cx1, cy1, cx2, cy2; // 裁剪范围 (加入时的 lcd_scene_clip)
+} lcd_prim;
+
+typedef struct __lcd_scene {
+    lcd_prim* prim;             // 调用者提供
+    uint16_t count, max;
+    uint16_t width, height;
+    uint16_t clear;             // 背景色
+    int16_t cx1, cy1, cx2, cy2; // 之后加入的图元的裁剪范围
+} lcd_scene;
+
+void lcd_scene_init(lcd_scene* scene, lcd_prim* prim, uint16_t max, uint16_t width, uint16_t height);
+void lcd_scene_reset(lcd_scene* scene);
+/* 设置之后加入的图元的裁剪范围 (闭区间), 默认为整个场景 */
+void lcd_scene_clip(lcd_scene* scene, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+/* 列表已满时返回 false, 图元被丢弃 */
+bool lcd_scene_line(lcd_scene* scene, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+bool lcd_scene_char(lcd_scene* scene, uint16_t x, uint16_t y, const uint8_t* glyph,
+                    uint16_t w, uint16_t h, uint16_t color, uint16_t back);
+/* 按加入的顺序画出 [y, y+rows) 行到 buf (每行 width 个像素) */
+void lcd_scene_raster(const lcd_scene* scene, uint16_t y, uint16_t rows, uint16_t* buf);
+
+#endif
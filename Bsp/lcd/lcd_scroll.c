@@ -0,0 +1,64 @@
+#include "lcd_scroll.h"
+
+/* offset: 可见区域在帧存储器中的起始行; height: 可见区域行数;
+   不足一个文本行的余数并入底部固定区 */
+bool lcd_scroll_init(lcd_scroll* sc, uint16_t offset, uint16_t height, uint16_t line_h)
+{
+    if(!line_h || height < line_h)
+        return false;
+
+    sc->line_h = line_h;
+    sc->lines  = height / line_h;
+    sc->tfa    = offset;
+    sc->vsa    = sc->lines * line_h;
+    if(sc->tfa + sc->vsa > LCD_FRAME_LINES)
+        return false;
+    sc->bfa    = LCD_FRAME_LINES - sc->tfa - sc->vsa;
+    sc->top    = 0;
+    sc->count  = 1;
+
+    return true;
+}
+
+static void lcd_scroll_start(const lcd_scroll* sc, lcd_cmd_queue* queue)
+{
+    /* Vertical Scroll Start Address */
+    lcd_cmd_begin(queue, 0x37);
+    lcd_cmd_param16(queue, sc->tfa + sc->top * sc->line_h);
+}
+
+/* 滚动区定义 (0x33) 与当前起始行 (0x37) */
+void lcd_scroll_define(const lcd_scroll* sc, lcd_cmd_queue* queue)
+{
+    lcd_cmd_begin(queue, 0x33);
+    lcd_cmd_param16(queue, sc->tfa);
+    lcd_cmd_param16(queue, sc->vsa);
+    lcd_cmd_param16(queue, sc->bfa);
+    lcd_scroll_start(sc, queue);
+}
+
+/* 屏幕第 row 个文本行在显存中的 y 坐标 (逻辑坐标, 不含偏移) */
+uint16_t lcd_scroll_y(const lcd_scroll* sc, uint16_t row)
+{
+    return ((sc->top + row) % sc->lines) * sc->line_h;
+}
+
+/* 当前输出行 (最后一个已使用的文本行) */
+uint16_t lcd_scroll_cursor_y(const lcd_scroll* sc)
+{
+    return lcd_scroll_y(sc, sc->count - 1);
+}
+
+/* 换行: 屏幕未满时只移动光标, 已满时滚动一行并把 0x37 放入 queue;
+   返回新行的 y 坐标, 调用者只需清除并重绘这一行 */
+uint16_t lcd_scroll_newline(lcd_scroll* sc, lcd_cmd_queue* queue)
+{
+    if(sc->count < sc->lines) {
+        sc->count++;
+    } else {
+        sc->top = (sc->top + 1) % sc->lines;
+        lcd_scroll_start(sc, queue);
+    }
+
+    return lcd_scroll_cursor_y(sc);
+}
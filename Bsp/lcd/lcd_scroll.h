@@ -0,0 +1,32 @@
+/*
+ * @Describe: 硬件垂直滚动的文本行映射
+ *            滚动区按文本行划分为环形槽位, 换行只需发送 0x37 改变显示起始行
+ */
+#ifndef __LCD_SCROLL_H
+#define __LCD_SCROLL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lcd_cmd.h"
+
+/* ST7789 帧存储器行数 */
+#define LCD_FRAME_LINES     320
+
+typedef struct __lcd_scroll {
+    uint16_t tfa;       // 顶部固定区行数 (面板偏移)
+    uint16_t vsa;       // 滚动区行数, 为行高的整数倍
+    uint16_t bfa;       // 底部固定区行数
+    uint16_t line_h;    // 文本行高
+    uint16_t lines;     // 屏幕可容纳的文本行数
+    uint16_t top;       // 屏幕第一行对应的槽位
+    uint16_t count;     // 已使用的文本行数
+} lcd_scroll;
+
+bool lcd_scroll_init(lcd_scroll* sc, uint16_t offset, uint16_t height, uint16_t line_h);
+void lcd_scroll_define(const lcd_scroll* sc, lcd_cmd_queue* queue);
+uint16_t lcd_scroll_y(const lcd_scroll* sc, uint16_t row);
+uint16_t lcd_scroll_cursor_y(const lcd_scroll* sc);
+uint16_t lcd_scroll_newline(lcd_scroll* sc, lcd_cmd_queue* queue);
+
+#endif
@@ -0,0 +1,323 @@
+#include "lcd_server.h"
+#include <string.h>
+
+typedef enum {
+    LCD_MERGE_NONE = 0,
+    LCD_MERGE_INTO,                 // 新命令并入已排队的命令
+    LCD_MERGE_REPLACE,              // 新命令覆盖已排队的命令, 取代它的位置
+} lcd_merge;
+
+void lcd_server_init(lcd_server* srv, const lcd_server_ops* ops, void* ctx)
+{
+    memset(srv, 0, sizeof(*srv));
+    srv->ops = ops;
+    srv->ctx = ctx;
+}
+
+void lcd_server_size(lcd_server* srv, uint16_t width, uint16_t height)
+{
+    srv->ops->lock(srv->ctx);
+    srv->width  = width;
+    srv->height = height;
+    srv->ops->unlock(srv->ctx);
+}
+
+static void lcd_server_union(lcd_draw_cmd* cmd, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if(cmd->x1 > cmd->x2) {
+        cmd->x1 = x1; cmd->y1 = y1;
+        cmd->x2 = x2; cmd->y2 = y2;
+        return;
+    }
+    if(x1 < cmd->x1) cmd->x1 = x1;
+    if(y1 < cmd->y1) cmd->y1 = y1;
+    if(x2 > cmd->x2) cmd->x2 = x2;
+    if(y2 > cmd->y2) cmd->y2 = y2;
+}
+
+/* 按 lcd_show_string 的换行与越界规则计算画到的字符框 */
+static void lcd_server_text_rect(const lcd_server* srv, lcd_draw_cmd* cmd)
+{
+    const lcd_font* font = &lcd_fonts[cmd->font];
+    int x = (uint16_t)cmd->x, y = (uint16_t)cmd->y;
+
+    cmd->x1 = cmd->y1 = 0;
+    cmd->x2 = cmd->y2 = -1;
+    if(!srv->width) {
+        // 换行位置未知, 从起始行到右下角都可能画到
+        cmd->y1 = y;
+        cmd->x2 = cmd->y2 = INT16_MAX;
+        return;
+    }
+
+    for(const char* p = cmd->text; *p != '\0'; p++) {
+        if(x > srv->width - font->width) {
+            x = 0;
+            y += font->height;
+        }
+        if(x <= srv->width - font->width && y <= srv->height - font->height)
+            lcd_server_union(cmd, x, y, x + font->width - 1, y + font->height - 1);
+        x += font->width;
+    }
+}
+
+static void lcd_server_rect(const lcd_server* srv, lcd_draw_cmd* cmd)
+{
+    switch(cmd->type) {
+    case LCD_DRAW_TEXT:
+        lcd_server_text_rect(srv, cmd);
+        break;
+    case LCD_DRAW_FLUSH:
+        cmd->x1 = cmd->y1 = 0;
+        cmd->x2 = cmd->y2 = INT16_MAX;
+        break;
+    default:
+        cmd->x1 = cmd->x;
+        cmd->y1 = cmd->y;
+        cmd->x2 = cmd->x + cmd->width - 1;
+        cmd->y2 = cmd->y + cmd->height - 1;
+        break;
+    }
+
+    // 填充裁剪到面板
+    if(cmd->type == LCD_DRAW_FILL && srv->width) {
+        if(cmd->x2 >= srv->width)  cmd->x2 = srv->width - 1;
+        if(cmd->y2 >= srv->height) cmd->y2 = srv->height - 1;
+        if(cmd->x1 <= cmd->x2 && cmd->y1 <= cmd->y2) {
+            cmd->width  = cmd->x2 - cmd->x1 + 1;
+            cmd->height = cmd->y2 - cmd->y1 + 1;
+        }
+    }
+}
+
+static bool lcd_server_overlap(const lcd_draw_cmd* a, const lcd_draw_cmd* b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+static bool lcd_server_contains(const lcd_draw_cmd* a, const lcd_draw_cmd* b)
+{
+    return a->x1 <= b->x1 && a->x2 >= b->x2 && a->y1 <= b->y1 && a->y2 >= b->y2;
+}
+
+/* 两个矩形的并集仍是矩形 (同行相邻/重叠, 同列相邻/重叠, 或包含) */
+static bool lcd_server_joinable(const lcd_draw_cmd* a, const lcd_draw_cmd* b)
+{
+    if(a->y1 == b->y1 && a->y2 == b->y2)
+        return b->x1 <= a->x2 + 1 && a->x1 <= b->x2 + 1;
+    if(a->x1 == b->x1 && a->x2 == b->x2)
+        return b->y1 <= a->y2 + 1 && a->y1 <= b->y2 + 1;
+    return lcd_server_contains(a, b) || lcd_server_contains(b, a);
+}
+
+/* 先执行 old 再执行 cmd 的效果能否由一条命令得到 */
+static lcd_merge lcd_server_merge(lcd_draw_cmd* old, const lcd_draw_cmd* cmd)
+{
+    if(cmd->type == LCD_DRAW_FILL && lcd_server_contains(cmd, old))
+        return LCD_MERGE_REPLACE;
+    if(cmd->type != old->type)
+        return LCD_MERGE_NONE;
+
+    switch(cmd->type) {
+    case LCD_DRAW_FILL:
+        if(cmd->done || old->color != cmd->color || !lcd_server_joinable(old, cmd))
+            return LCD_MERGE_NONE;
+        lcd_server_union(old, cmd->x1, cmd->y1, cmd->x2, cmd->y2);
+        old->x = old->x1;
+        old->y = old->y1;
+        old->width  = old->x2 - old->x1 + 1;
+        old->height = old->y2 - old->y1 + 1;
+        return LCD_MERGE_INTO;
+
+    case LCD_DRAW_TEXT:
+        // 同一位置的文本: 字符位置相同, 新文本之后仍显示旧文本的剩余部分
+        if(cmd->done || old->x != cmd->x || old->y != cmd->y || old->font != cmd->font ||
+           old->color != cmd->color || old->back != cmd->back)
+            return LCD_MERGE_NONE;
+        for(uint8_t i = 0; cmd->text[i] != '\0'; i++) {
+            if(old->text[i] == '\0')
+                old->text[i + 1] = '\0';
+            old->text[i] = cmd->text[i];
+        }
+        lcd_server_union(old, cmd->x1, cmd->y1, cmd->x2, cmd->y2);
+        return LCD_MERGE_INTO;
+
+    case LCD_DRAW_PICTURE:
+        if(old->x != cmd->x || old->y != cmd->y || old->width != cmd->width || old->height != cmd->height)
+            return LCD_MERGE_NONE;
+        return LCD_MERGE_REPLACE;
+
+    default:
+        return LCD_MERGE_NONE;
+    }
+}
+
+/* 从插入位置向前找同优先级的命令合并; 只越过与 cmd 不相交的命令, 刷新命令是屏障.
+   返回 true 表示已合并, 被覆盖的命令存入 drop */
+static bool lcd_server_coalesce(lcd_server* srv, uint8_t pos, const lcd_draw_cmd* cmd, lcd_draw_cmd* drop)
+{
+    if(cmd->type == LCD_DRAW_FLUSH)
+        return false;
+
+    for(uint8_t i = pos; i-- > 0; ) {
+        lcd_draw_cmd* old = &srv->slot[srv->order[i]];
+
+        if(old->priority != cmd->priority || old->type == LCD_DRAW_FLUSH)
+            return false;
+
+        switch(lcd_server_merge(old, cmd)) {
+        case LCD_MERGE_INTO:
+            srv->merged++;
+            return true;
+        case LCD_MERGE_REPLACE:
+            *drop = *old;
+            *old  = *cmd;
+            srv->dropped++;
+            return true;
+        default:
+            break;
+        }
+        if(lcd_server_overlap(old, cmd))
+            return false;
+    }
+    return false;
+}
+
+bool lcd_server_submit(lcd_server* srv, const lcd_draw_cmd* cmd, bool block)
+{
+    lcd_draw_cmd req = *cmd;
+    lcd_draw_cmd drop = { .done = 0 };
+    uint8_t pos, slot;
+    bool space;
+
+    for(;;) {
+        srv->ops->lock(srv->ctx);
+        // 范围取决于面板尺寸, 尺寸可能在等待期间设置
+        lcd_server_rect(srv, &req);
+
+        // 不画任何像素的命令直接完成
+        if(req.x1 > req.x2 || req.y1 > req.y2) {
+            srv->ops->unlock(srv->ctx);
+            if(req.done)
+                req.done(req.arg);
+            return true;
+        }
+
+        pos = 0;
+        while(pos < srv->count && srv->slot[srv->order[pos]].priority >= req.priority)
+            pos++;
+
+        if(lcd_server_coalesce(srv, pos, &req, &drop)) {
+            srv->submitted++;
+            srv->ops->unlock(srv->ctx);
+            if(drop.done)
+                drop.done(drop.arg);
+            return true;
+        }
+        if(srv->count < LCD_SERVER_QUEUE)
+            break;
+
+        srv->ops->unlock(srv->ctx);
+        if(!block)
+            return false;
+        srv->ops->wait(srv->ctx, LCD_SERVER_EV_SPACE);
+    }
+
+    for(slot = 0; srv->used & (1U << slot); slot++)
+        ;
+    srv->used |= 1U << slot;
+    srv->slot[slot] = req;
+    memmove(&srv->order[pos + 1], &srv->order[pos], srv->count - pos);
+    srv->order[pos] = slot;
+    srv->count++;
+    srv->submitted++;
+    space = srv->count < LCD_SERVER_QUEUE;
+    srv->ops->unlock(srv->ctx);
+
+    srv->ops->post(srv->ctx, LCD_SERVER_EV_CMD);
+    // 多个空位只有一次事件通知, 接力唤醒其他等待的提交者
+    if(space)
+        srv->ops->post(srv->ctx, LCD_SERVER_EV_SPACE);
+    return true;
+}
+
+bool lcd_server_fill(lcd_server* srv, uint8_t priority, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    lcd_draw_cmd cmd = { .type = LCD_DRAW_FILL, .priority = priority, .color = color };
+
+    if(x1 > x2) { int16_t t = x1; x1 = x2; x2 = t; }
+    if(y1 > y2) { int16_t t = y1; y1 = y2; y2 = t; }
+    if(x1 < 0) x1 = 0;
+    if(y1 < 0) y1 = 0;
+    if(x1 > x2 || y1 > y2)
+        return true;
+
+    cmd.x = x1;
+    cmd.y = y1;
+    cmd.width  = x2 - x1 + 1;
+    cmd.height = y2 - y1 + 1;
+    return lcd_server_submit(srv, &cmd, true);
+}
+
+bool lcd_server_text(lcd_server* srv, uint8_t priority, uint16_t x, uint16_t y, font_type font,
+                     uint16_t front, uint16_t back, const char* str)
+{
+    lcd_draw_cmd cmd = {
+        .type = LCD_DRAW_TEXT, .priority = priority, .font = font,
+        .x = x, .y = y, .color = front, .back = back,
+    };
+
+    strncpy(cmd.text, str, LCD_DRAW_TEXT_MAX - 1);
+    return lcd_server_submit(srv, &cmd, true);
+}
+
+bool lcd_server_picture(lcd_server* srv, uint8_t priority, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                        const void* pixels, lcd_draw_done done, void* arg)
+{
+    lcd_draw_cmd cmd = {
+        .type = LCD_DRAW_PICTURE, .priority = priority,
+        .x = x, .y = y, .width = width, .height = height,
+        .data = pixels, .done = done, .arg = arg,
+    };
+
+    return lcd_server_submit(srv, &cmd, true);
+}
+
+bool lcd_server_flush(lcd_server* srv, uint8_t priority, const void* surf, lcd_draw_done done, void* arg)
+{
+    lcd_draw_cmd cmd = {
+        .type = LCD_DRAW_FLUSH, .priority = priority,
+        .data = surf, .done = done, .arg = arg,
+    };
+
+    return lcd_server_submit(srv, &cmd, true);
+}
+
+bool lcd_server_take(lcd_server* srv, lcd_draw_cmd* cmd, bool block)
+{
+    for(;;) {
+        srv->ops->lock(srv->ctx);
+        if(srv->count)
+            break;
+        srv->ops->unlock(srv->ctx);
+        if(!block)
+            return false;
+        srv->ops->wait(srv->ctx, LCD_SERVER_EV_CMD);
+    }
+
+    *cmd = srv->slot[srv->order[0]];
+    srv->used &= ~(1U << srv->order[0]);
+    srv->count--;
+    memmove(&srv->order[0], &srv->order[1], srv->count);
+    srv->ops->unlock(srv->ctx);
+
+    srv->ops->post(srv->ctx, LCD_SERVER_EV_SPACE);
+    return true;
+}
+
+void lcd_server_finish(lcd_server* srv, const lcd_draw_cmd* cmd)
+{
+    (void)srv;
+    if(cmd->done)
+        cmd->done(cmd->arg);
+}
@@ -0,0 +1,103 @@
+/*
+ * @Describe: 显示服务: 一个任务独占面板, 其他任务提交绘制命令
+ *            命令按优先级排队, 提交时与排在前面的命令合并; 图片只传引用
+ */
+#ifndef __LCD_SERVER_H
+#define __LCD_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_font.h"
+
+#define LCD_SERVER_QUEUE    16      // 最多排队的命令数 (不超过 32)
+#define LCD_DRAW_TEXT_MAX   24      // 文本命令的最大字符数 (含结尾 0)
+
+typedef enum {
+    LCD_DRAW_FILL = 0,
+    LCD_DRAW_TEXT,
+    LCD_DRAW_PICTURE,
+    LCD_DRAW_FLUSH,                 // 发送 lcd_anim 显存 (data 为表面, 可为 NULL); 不与前后命令合并
+} lcd_draw_type;
+
+/* 等待的事件 */
+typedef enum {
+    LCD_SERVER_EV_CMD = 0,          // 队列中有命令 (服务任务等待)
+    LCD_SERVER_EV_SPACE,            // 队列有空位 (提交者等待)
+} lcd_server_event;
+
+/* 命令执行完成, 或被后来的命令覆盖而丢弃时调用; 图片缓冲在此之后才可释放 */
+typedef void (*lcd_draw_done)(void* arg);
+
+typedef struct __lcd_draw_cmd {
+    uint8_t type;                   // lcd_draw_type
+    uint8_t priority;               // 数值越大越先执行, 同优先级按提交顺序
+    uint8_t font;                   // 文本: font_type
+    int16_t x, y;                   // 起点
+    uint16_t width, height;         // 填充/图片的尺寸
+    uint16_t color, back;           // 填充色; 文本前景/背景色
+    const void* data;               // 图片像素 (屏幕字节序) / 刷新的表面, 只传引用
+    lcd_draw_done done;
+    void* arg;
+    char text[LCD_DRAW_TEXT_MAX];
+
+    int16_t x1, y1, x2, y2;         // 影响的矩形, 提交时计算
+} lcd_draw_cmd;
+
+/* 同步原语
+ * lock/unlock: 保护队列, 只在任务中调用
+ * wait       : 阻塞等待一次事件 (在锁外调用, 醒来后重新检查)
+ * post       : 发出事件; 事件在等待前发出时不能丢失 (二值信号量语义)
+ */
+typedef struct __lcd_server_ops {
+    void (*lock)(void* ctx);
+    void (*unlock)(void* ctx);
+    void (*wait)(void* ctx, lcd_server_event ev);
+    void (*post)(void* ctx, lcd_server_event ev);
+} lcd_server_ops;
+
+typedef struct __lcd_server {
+    const lcd_server_ops* ops;
+    void* ctx;
+    uint16_t width, height;         // 面板尺寸, 为 0 时文本换行未知, 按到右下角估计
+
+    lcd_draw_cmd slot[LCD_SERVER_QUEUE];
+    uint8_t order[LCD_SERVER_QUEUE];    // 执行顺序, 存放 slot 下标
+    uint8_t count;
+    uint32_t used;                  // 占用的 slot
+
+    uint32_t submitted;             // 提交的命令数
+    uint32_t merged;                // 合并到已排队命令中的命令数
+    uint32_t dropped;               // 被覆盖而不再执行的命令数
+} lcd_server;
+
+void lcd_server_init(lcd_server* srv, const lcd_server_ops* ops, void* ctx);
+void lcd_server_size(lcd_server* srv, uint16_t width, uint16_t height);
+
+/* 提交一条命令; 队列满且不能合并时 block 为 true 则等待, 否则返回 false
+   以下封装都会等待; 填充裁剪到面板, 文本超过 LCD_DRAW_TEXT_MAX - 1 个字符时截断 */
+bool lcd_server_submit(lcd_server* srv, const lcd_draw_cmd* cmd, bool block);
+bool lcd_server_fill(lcd_server* srv, uint8_t priority, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+bool lcd_server_text(lcd_server* srv, uint8_t priority, uint16_t x, uint16_t y, font_type font,
+                     uint16_t front, uint16_t back, const char* str);
+bool lcd_server_picture(lcd_server* srv, uint8_t priority, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                        const void* pixels, lcd_draw_done done, void* arg);
+bool lcd_server_flush(lcd_server* srv, uint8_t priority, const void* surf, lcd_draw_done done, void* arg);
+
+/* 服务任务: 取出下一条命令, 队列空时 block 为 true 则等待, 否则返回 false;
+   执行后调用 lcd_server_finish */
+bool lcd_server_take(lcd_server* srv, lcd_draw_cmd* cmd, bool block);
+void lcd_server_finish(lcd_server* srv, const lcd_draw_cmd* cmd);
+
+/* 在面板上执行一条命令 (lcd_server_exec.c, 依赖 lcd.h)
+   填充/文本/图片直接写到面板, 不写入 lcd_anim 显存, 也不与覆盖层合成;
+   之后刷新的改变区域与其重叠时会被显存内容覆盖, 应画在动画区域之外 */
+struct __lcd;
+void lcd_server_exec(struct __lcd* plcd, const lcd_draw_cmd* cmd);
+/* 执行队列中的全部命令, 返回执行的条数 */
+uint16_t lcd_server_poll(lcd_server* srv, struct __lcd* plcd);
+
+/* FreeRTOS 同步: 互斥量保护队列, 每个事件一个二值信号量; 提交前先调用 lcd_server_rtos_init (lcd_server_port.c 实现) */
+extern lcd_server lcd_server_rtos;
+void lcd_server_rtos_init(void);
+
+#endif
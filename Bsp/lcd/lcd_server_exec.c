@@ -0,0 +1,44 @@
+#include "lcd_server.h"
+#include "lcd.h"
+#include "lcd_anim.h"
+
+void lcd_server_exec(lcd* plcd, const lcd_draw_cmd* cmd)
+{
+    lcd_font font;
+
+    switch(cmd->type) {
+    case LCD_DRAW_FILL:
+        lcd_fill(plcd, cmd->x, cmd->y, cmd->x + cmd->width - 1, cmd->y + cmd->height - 1, cmd->color);
+        break;
+    case LCD_DRAW_TEXT:
+        // 命令自带字体与颜色, 不改变 lcd_anim 等其他绘制使用的字体
+        font = plcd->font;
+        lcd_set_font(plcd, cmd->font, cmd->color, cmd->back);
+        lcd_show_string(plcd, cmd->x, cmd->y, (const uint8_t *)cmd->text);
+        plcd->font = font;
+        break;
+    case LCD_DRAW_PICTURE:
+        lcd_show_picture(plcd, cmd->x, cmd->y, cmd->width, cmd->height, (uint8_t *)cmd->data);
+        break;
+    case LCD_DRAW_FLUSH:
+        // 发送是异步的, 等发送完成后命令才算执行完 (之后调用 done, 显存可以改写)
+        if(cmd->data) {
+            lcd_anim_flush(cmd->data);
+            lcd_anim_flush_wait(cmd->data);
+        }
+        break;
+    }
+}
+
+uint16_t lcd_server_poll(lcd_server* srv, lcd* plcd)
+{
+    lcd_draw_cmd cmd;
+    uint16_t count = 0;
+
+    while(lcd_server_take(srv, &cmd, false)) {
+        lcd_server_exec(plcd, &cmd);
+        lcd_server_finish(srv, &cmd);
+        count++;
+    }
+    return count;
+}
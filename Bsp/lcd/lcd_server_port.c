@@ -0,0 +1,47 @@
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "lcd_server.h"
+
+lcd_server lcd_server_rtos;
+static StaticSemaphore_t lcd_server_sem[3];
+static SemaphoreHandle_t lcd_server_mutex;
+static SemaphoreHandle_t lcd_server_sems[2];   // 按 lcd_server_event 索引
+
+static void lcd_server_rtos_lock(void* ctx)
+{
+    (void)ctx;
+    xSemaphoreTake(lcd_server_mutex, portMAX_DELAY);
+}
+
+static void lcd_server_rtos_unlock(void* ctx)
+{
+    (void)ctx;
+    xSemaphoreGive(lcd_server_mutex);
+}
+
+static void lcd_server_rtos_wait(void* ctx, lcd_server_event ev)
+{
+    (void)ctx;
+    xSemaphoreTake(lcd_server_sems[ev], portMAX_DELAY);
+}
+
+static void lcd_server_rtos_post(void* ctx, lcd_server_event ev)
+{
+    (void)ctx;
+    xSemaphoreGive(lcd_server_sems[ev]);
+}
+
+static const lcd_server_ops lcd_server_rtos_ops = {
+    .lock   = lcd_server_rtos_lock,
+    .unlock = lcd_server_rtos_unlock,
+    .wait   = lcd_server_rtos_wait,
+    .post   = lcd_server_rtos_post,
+};
+
+void lcd_server_rtos_init(void)
+{
+    lcd_server_mutex = xSemaphoreCreateMutexStatic(&lcd_server_sem[0]);
+    lcd_server_sems[LCD_SERVER_EV_CMD]   = xSemaphoreCreateBinaryStatic(&lcd_server_sem[1]);
+    lcd_server_sems[LCD_SERVER_EV_SPACE] = xSemaphoreCreateBinaryStatic(&lcd_server_sem[2]);
+    lcd_server_init(&lcd_server_rtos, &lcd_server_rtos_ops, NULL);
+}
@@ -0,0 +1,103 @@
+#include "lcd_span.h"
+
+void lcd_spans_init(lcd_spans* spans, lcd_span (*row)[LCD_SPAN_MAX], uint8_t* count,
+                    uint16_t width, uint16_t height)
+{
+    spans->row    = row;
+    spans->count  = count;
+    spans->width  = width;
+    spans->height = height;
+
+    for(uint16_t y = 0; y < height; y++)
+        count[y] = 0;
+    spans->y1 = height;
+    spans->y2 = -1;
+}
+
+void lcd_spans_reset(lcd_spans* spans)
+{
+    for(int16_t y = spans->y1; y <= spans->y2; y++)
+        spans->count[y] = 0;
+    spans->y1 = spans->height;
+    spans->y2 = -1;
+}
+
+/* 两段之间的空隙, 相交或相邻时 <= 0 */
+static int16_t lcd_span_gap(const lcd_span* s, int16_t x1, int16_t x2)
+{
+    return s->x1 > x2 ? s->x1 - x2 - 1 : x1 - s->x2 - 1;
+}
+
+void lcd_spans_add(lcd_spans* spans, int16_t y, int16_t x1, int16_t x2)
+{
+    lcd_span* row;
+    uint8_t n;
+
+    if(y < 0 || y >= spans->height)
+        return;
+    if(x1 < 0) x1 = 0;
+    if(x2 >= spans->width) x2 = spans->width - 1;
+    if(x1 > x2)
+        return;
+
+    row = spans->row[y];
+    n = spans->count[y];
+
+    for(;;) {
+        uint8_t i = 0, near = 0;
+        int16_t near_gap = INT16_MAX;
+
+        // 吸收足够近的段; 吸收后范围变大, 从头再查
+        while(i < n) {
+            int16_t gap = lcd_span_gap(&row[i], x1, x2);
+
+            if(gap <= LCD_SPAN_GAP) {
+                if(row[i].x1 < x1) x1 = row[i].x1;
+                if(row[i].x2 > x2) x2 = row[i].x2;
+                row[i] = row[--n];
+                i = 0;
+                near_gap = INT16_MAX;
+                continue;
+            }
+            if(gap < near_gap) {
+                near = i;
+                near_gap = gap;
+            }
+            i++;
+        }
+        if(n < LCD_SPAN_MAX)
+            break;
+
+        // 已满: 与最近的段合并
+        if(row[near].x1 < x1) x1 = row[near].x1;
+        if(row[near].x2 > x2) x2 = row[near].x2;
+        row[near] = row[--n];
+    }
+
+    row[n].x1 = x1;
+    row[n].x2 = x2;
+    spans->count[y] = n + 1;
+
+    if(y < spans->y1) spans->y1 = y;
+    if(y > spans->y2) spans->y2 = y;
+}
+
+void lcd_spans_add_rect(lcd_spans* spans, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if(y1 < 0) y1 = 0;
+    if(y2 >= spans->height) y2 = spans->height - 1;
+
+    for(int16_t y = y1; y <= y2; y++)
+        lcd_spans_add(spans, y, x1, x2);
+}
+
+uint32_t lcd_spans_area(const lcd_spans* spans)
+{
+    uint32_t area = 0;
+
+    for(int16_t y = spans->y1; y <= spans->y2; y++) {
+        for(uint8_t i = 0; i < spans->count[y]; i++)
+            area += spans->row[y][i].x2 - spans->row[y][i].x1 + 1;
+    }
+    return area;
+}
@@ -0,0 +1,31 @@
+/*
+ * @Describe: 按行记录画过的水平段, 用于只擦除上一帧画过的像素
+ */
+#ifndef __LCD_SPAN_H
+#define __LCD_SPAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LCD_SPAN_MAX    4       // 每行最多段数, 超出时与最近的段合并
+#define LCD_SPAN_GAP    8       // 间隔不超过此值的段直接合并 (多一次 memset 的开销折算为像素)
+
+typedef struct __lcd_span {
+    int16_t x1, x2;             // 闭区间
+} lcd_span;
+
+typedef struct __lcd_spans {
+    lcd_span (*row)[LCD_SPAN_MAX];  // height 行, 调用者提供
+    uint8_t* count;                 // 每行的段数, 调用者提供
+    uint16_t width, height;         // 裁剪范围
+    int16_t y1, y2;                 // 有段的行范围, y1 > y2 时为空
+} lcd_spans;
+
+void lcd_spans_init(lcd_spans* spans, lcd_span (*row)[LCD_SPAN_MAX], uint8_t* count,
+                    uint16_t width, uint16_t height);
+void lcd_spans_reset(lcd_spans* spans);
+void lcd_spans_add(lcd_spans* spans, int16_t y, int16_t x1, int16_t x2);
+void lcd_spans_add_rect(lcd_spans* spans, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+uint32_t lcd_spans_area(const lcd_spans* spans);
+
+#endif
@@ -0,0 +1,35 @@
+#include "lcd_spi_ll.h"
+
+/* BSRR 低 16 位置位, 高 16 位复位, 单次写入无需读改写 */
+void lcd_ll_pin(lcd_ll_gpio* port, uint16_t pin, bool level)
+{
+    LCD_LL_WRITE(port->BSRR, level ? (uint32_t)pin : (uint32_t)pin << 16);
+}
+
+/* 阻塞发送, len 为字节数; 帧宽度由 CR1.DFF 决定, 16 位帧时按半字写 DR */
+void lcd_ll_write(lcd_ll_spi* spi, const uint8_t* data, uint32_t len)
+{
+    uint32_t cr1 = LCD_LL_READ(spi->CR1);
+
+    /* 单线双向模式: 确保处于发送方向且已使能 */
+    if((cr1 & (LCD_LL_CR1_BIDIOE | LCD_LL_CR1_SPE)) != (LCD_LL_CR1_BIDIOE | LCD_LL_CR1_SPE))
+        LCD_LL_WRITE(spi->CR1, cr1 | LCD_LL_CR1_BIDIOE | LCD_LL_CR1_SPE);
+
+    if(cr1 & LCD_LL_CR1_DFF) {
+        const uint16_t* half = (const uint16_t *)data;
+
+        for(uint32_t i = 0; i < len / 2; i++) {
+            while(!(LCD_LL_READ(spi->SR) & LCD_LL_SR_TXE));
+            LCD_LL_WRITE(spi->DR, half[i]);
+        }
+    } else {
+        for(uint32_t i = 0; i < len; i++) {
+            while(!(LCD_LL_READ(spi->SR) & LCD_LL_SR_TXE));
+            LCD_LL_WRITE(spi->DR, data[i]);
+        }
+    }
+
+    /* 等待最后一帧移出, 之后才能切换 DC */
+    while(!(LCD_LL_READ(spi->SR) & LCD_LL_SR_TXE));
+    while(LCD_LL_READ(spi->SR) & LCD_LL_SR_BSY);
+}
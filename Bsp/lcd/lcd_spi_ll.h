@@ -0,0 +1,45 @@
+/*
+ * @Describe: 寄存器级 SPI/GPIO 快速通道 (不依赖 HAL, 主机上可替换寄存器访问)
+ */
+#ifndef __LCD_SPI_LL_H
+#define __LCD_SPI_LL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 与 SPI_TypeDef / GPIO_TypeDef 起始布局一致的最小寄存器定义 */
+typedef struct __lcd_ll_spi {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+} lcd_ll_spi;
+
+typedef struct __lcd_ll_gpio {
+    volatile uint32_t MODER;
+    volatile uint32_t OTYPER;
+    volatile uint32_t OSPEEDR;
+    volatile uint32_t PUPDR;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+} lcd_ll_gpio;
+
+#define LCD_LL_CR1_SPE      (1u << 6)
+#define LCD_LL_CR1_DFF      (1u << 11)
+#define LCD_LL_CR1_BIDIOE   (1u << 14)
+#define LCD_LL_SR_TXE       (1u << 1)
+#define LCD_LL_SR_BSY       (1u << 7)
+
+/* 寄存器访问, 主机测试时可重定义到模拟外设 */
+#ifndef LCD_LL_WRITE
+#define LCD_LL_WRITE(reg, val)  ((reg) = (val))
+#endif
+#ifndef LCD_LL_READ
+#define LCD_LL_READ(reg)        (reg)
+#endif
+
+void lcd_ll_pin(lcd_ll_gpio* port, uint16_t pin, bool level);
+void lcd_ll_write(lcd_ll_spi* spi, const uint8_t* data, uint32_t len);
+
+#endif
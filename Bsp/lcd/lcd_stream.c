@@ -0,0 +1,41 @@
+#include "lcd_stream.h"
+
+/* 一个缓冲在发送的同时生成另一个缓冲:
+ * 写 buf[n] 时会先等 buf[n^1] 发完, 所以下一次生成到 buf[n^1] 是安全的 */
+void lcd_stream_lines(lcd_stream* stream, uint16_t width, uint16_t height,
+                      lcd_line_gen gen, void* arg)
+{
+    int pingpong = stream->buf[1] != 0;
+
+    for(uint16_t row = 0; row < height; row++) {
+        uint16_t* line = stream->buf[pingpong ? (row & 1) : 0];
+
+        gen(arg, row, line, width);
+        stream->write(stream->ctx, (uint8_t *)line, width * 2);
+
+        if(!pingpong)
+            stream->wait(stream->ctx);
+    }
+
+    stream->wait(stream->ctx);
+}
+
+void lcd_stream_bands(lcd_stream* stream, uint16_t width, uint16_t height, uint16_t band,
+                      lcd_band_gen gen, void* arg)
+{
+    int pingpong = stream->buf[1] != 0;
+    uint16_t n = 0;
+
+    for(uint16_t row = 0; row < height; row += band, n++) {
+        uint16_t rows = height - row < band ? height - row : band;
+        uint16_t* buf = stream->buf[pingpong ? (n & 1) : 0];
+
+        gen(arg, row, rows, buf, width);
+        stream->write(stream->ctx, (uint8_t *)buf, (uint32_t)width * rows * 2);
+
+        if(!pingpong)
+            stream->wait(stream->ctx);
+    }
+
+    stream->wait(stream->ctx);
+}
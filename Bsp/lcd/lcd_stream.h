@@ -0,0 +1,33 @@
+/*
+ * @Describe: 乒乓行缓冲流式发送
+ */
+#ifndef __LCD_STREAM_H
+#define __LCD_STREAM_H
+
+#include <stdint.h>
+
+/* 行生成回调: 把第 row 行的 width 个像素写入 line */
+typedef void (*lcd_line_gen)(void* arg, uint16_t row, uint16_t* line, uint16_t width);
+
+/* 条带生成回调: 把从第 row 行开始的 rows 行 (每行 width 个像素) 连续写入 buf */
+typedef void (*lcd_band_gen)(void* arg, uint16_t row, uint16_t rows, uint16_t* buf, uint16_t width);
+
+/* 行缓冲流
+ * buf  : 两个行缓冲, buf[1] 为 NULL 时退化为单缓冲 (每行发送完才生成下一行)
+ * write: 异步写, 启动前须等待上一次写完成
+ * wait : 等待最后一次写完成
+ */
+typedef struct __lcd_stream {
+    uint16_t* buf[2];
+    void* ctx;
+    void (*write)(void* ctx, uint8_t* data, uint32_t len);
+    void (*wait)(void* ctx);
+} lcd_stream;
+
+void lcd_stream_lines(lcd_stream* stream, uint16_t width, uint16_t height,
+                      lcd_line_gen gen, void* arg);
+/* 每个缓冲可容纳 band 行, 最后一条可能不足 band 行 */
+void lcd_stream_bands(lcd_stream* stream, uint16_t width, uint16_t height, uint16_t band,
+                      lcd_band_gen gen, void* arg);
+
+#endif
@@ -0,0 +1,58 @@
+#include "lcd_surface.h"
+
+bool lcd_surface_init(lcd_surface* surf, struct __lcd* plcd, uint8_t* pixels, uint32_t size,
+                      uint16_t width, uint16_t height, uint8_t bpp)
+{
+    surf->plcd   = plcd;
+    surf->pixels = pixels;
+    surf->stride = LCD_SURFACE_STRIDE(width, bpp);
+    surf->bpp    = bpp;
+    surf->width  = width;
+    surf->height = height;
+    surf->x = 0;
+    surf->y = 0;
+
+    return !pixels || (uint32_t)surf->stride * height <= size;
+}
+
+void lcd_surface_rect(const lcd_surface* surf, lcd_rect* rect)
+{
+    rect->x1 = surf->x;
+    rect->y1 = surf->y;
+    rect->x2 = surf->x + surf->width - 1;
+    rect->y2 = surf->y + surf->height - 1;
+}
+
+bool lcd_surface_clip(const lcd_surface* surf, lcd_rect* rect)
+{
+    if(rect->x1 < 0) rect->x1 = 0;
+    if(rect->y1 < 0) rect->y1 = 0;
+    if(rect->x2 >= surf->width)  rect->x2 = surf->width - 1;
+    if(rect->y2 >= surf->height) rect->y2 = surf->height - 1;
+    if(rect->x1 > rect->x2 || rect->y1 > rect->y2)
+        return false;
+
+    rect->x1 += surf->x;
+    rect->x2 += surf->x;
+    rect->y1 += surf->y;
+    rect->y2 += surf->y;
+    return true;
+}
+
+bool lcd_surface_view(lcd_surface* view, const lcd_surface* parent,
+                      int16_t x, int16_t y, uint16_t width, uint16_t height)
+{
+    lcd_rect r = { x, y, x + width - 1, y + height - 1 };
+
+    *view = *parent;
+    if(!width || !height || !lcd_surface_clip(parent, &r)) {
+        view->width = view->height = 0;
+        return false;
+    }
+
+    view->x = r.x1;
+    view->y = r.y1;
+    view->width  = r.x2 - r.x1 + 1;
+    view->height = r.y2 - r.y1 + 1;
+    return true;
+}
@@ -0,0 +1,38 @@
+/*
+ * @Describe: 显存表面与子视图
+ *            视图与父表面共享像素, 只记录在根表面中的位置, 不复制
+ */
+#ifndef __LCD_SURFACE_H
+#define __LCD_SURFACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd_dirty.h"
+
+struct __lcd;
+
+typedef struct __lcd_surface {
+    struct __lcd* plcd;         // 所属面板: 字体与刷新目标
+    uint8_t* pixels;            // 根表面像素, 可为 NULL (条带渲染)
+    uint16_t stride;            // 根表面每行字节数 (偶数)
+    uint8_t bpp;                // 16/8/4
+    uint16_t width, height;     // 本表面大小
+    int16_t x, y;               // 本表面左上角在根表面中的位置
+} lcd_surface;
+
+/* 每行字节数, 向上取整到偶数 */
+#define LCD_SURFACE_STRIDE(width, bpp)  (((((uint32_t)(width) * (bpp) + 7) / 8) + 1) & ~1U)
+
+/* size 为 pixels 的字节数, 不够 height 行时返回 false */
+bool lcd_surface_init(lcd_surface* surf, struct __lcd* plcd, uint8_t* pixels, uint32_t size,
+                      uint16_t width, uint16_t height, uint8_t bpp);
+/* 父表面中 (x, y) 起 width x height 的视图; 超出父表面的部分被裁掉, 视图原点随之移到裁剪后的左上角;
+   完全在外时返回 false */
+bool lcd_surface_view(lcd_surface* view, const lcd_surface* parent,
+                      int16_t x, int16_t y, uint16_t width, uint16_t height);
+/* 表面坐标的矩形与表面求交并换算为根表面坐标, 为空时返回 false */
+bool lcd_surface_clip(const lcd_surface* surf, lcd_rect* rect);
+/* 表面在根表面中的范围 */
+void lcd_surface_rect(const lcd_surface* surf, lcd_rect* rect);
+
+#endif
@@ -0,0 +1,118 @@
+#include "lcd_tile.h"
+
+#define LCD_CRC_POLY    0x04C11DB7U
+
+/* 每次处理 4 位的查找表 */
+static const uint32_t lcd_crc_nibble[16] = {
+    0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9,
+    0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+    0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
+    0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
+};
+
+static void lcd_soft_reset(void* ctx)
+{
+    *(uint32_t *)ctx = 0xFFFFFFFFU;
+}
+
+/* 两个像素组成一个字, 低地址像素在低半字 (与 CRC->DR 按字写入一致) */
+static void lcd_soft_feed(void* ctx, const uint16_t* pixels, uint32_t count)
+{
+    uint32_t crc = *(uint32_t *)ctx;
+
+    for(uint32_t i = 0; i + 1 < count; i += 2) {
+        crc ^= (uint32_t)pixels[i] | ((uint32_t)pixels[i + 1] << 16);
+        for(int n = 0; n < 8; n++)
+            crc = (crc << 4) ^ lcd_crc_nibble[crc >> 28];
+    }
+    *(uint32_t *)ctx = crc;
+}
+
+static uint32_t lcd_soft_result(void* ctx)
+{
+    return *(uint32_t *)ctx;
+}
+
+const lcd_tile_hash_ops lcd_tile_hash_soft = {
+    .reset  = lcd_soft_reset,
+    .feed   = lcd_soft_feed,
+    .result = lcd_soft_result,
+};
+
+void lcd_tiles_init(lcd_tiles* tiles, uint16_t width, uint16_t height, uint32_t* hash)
+{
+    tiles->width  = width;
+    tiles->height = height;
+    tiles->cols   = LCD_TILE_COLS(width);
+    tiles->rows   = LCD_TILE_ROWS(height);
+    tiles->hash   = hash;
+    tiles->valid  = false;
+}
+
+/* 面板内容未知时调用, 下次扫描所有块都视为改变 */
+void lcd_tiles_invalidate(lcd_tiles* tiles)
+{
+    tiles->valid = false;
+}
+
+static uint32_t lcd_tile_hash(const lcd_tiles* tiles, const uint16_t* fb,
+                              const lcd_tile_hash_ops* ops, void* hash_ctx,
+                              uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    uint16_t count = x2 - x1 + 1;
+
+    ops->reset(hash_ctx);
+    for(uint16_t y = y1; y <= y2; y++) {
+        const uint16_t* row = &fb[(uint32_t)y * tiles->width + x1];
+
+        ops->feed(hash_ctx, row, count & ~1U);
+        // 哈希按 32 位字计算, 奇数宽度的最后一个像素补 0 成字
+        if(count & 1) {
+            uint16_t pair[2] = { row[count - 1], 0 };
+            ops->feed(hash_ctx, pair, 2);
+        }
+    }
+    return ops->result(hash_ctx);
+}
+
+/* 计算每块哈希并与上一帧比较, 返回改变的块数 */
+uint32_t lcd_tiles_scan(lcd_tiles* tiles, const uint16_t* fb,
+                        const lcd_tile_hash_ops* ops, void* hash_ctx,
+                        lcd_tile_emit emit, void* ctx)
+{
+    uint32_t changed = 0;
+
+    for(uint16_t r = 0; r < tiles->rows; r++) {
+        uint16_t y1 = r * LCD_TILE_H;
+        uint16_t y2 = y1 + LCD_TILE_H - 1 < tiles->height ? y1 + LCD_TILE_H - 1 : tiles->height - 1;
+        int32_t run = -1;       // 当前连续改变段的起始块列
+
+        for(uint16_t c = 0; c <= tiles->cols; c++) {
+            bool diff = false;
+
+            if(c < tiles->cols) {
+                uint16_t x1 = c * LCD_TILE_W;
+                uint16_t x2 = x1 + LCD_TILE_W - 1 < tiles->width ? x1 + LCD_TILE_W - 1 : tiles->width - 1;
+                uint32_t* slot = &tiles->hash[(uint32_t)r * tiles->cols + c];
+                uint32_t hash = lcd_tile_hash(tiles, fb, ops, hash_ctx, x1, y1, x2, y2);
+
+                diff = !tiles->valid || hash != *slot;
+                *slot = hash;
+            }
+
+            if(diff) {
+                changed++;
+                if(run < 0)
+                    run = c;
+            } else if(run >= 0) {
+                uint16_t x2 = c * LCD_TILE_W - 1;
+
+                emit(ctx, run * LCD_TILE_W, y1, x2 < tiles->width ? x2 : tiles->width - 1, y2);
+                run = -1;
+            }
+        }
+    }
+
+    tiles->valid = true;
+    return changed;
+}
@@ -0,0 +1,47 @@
+/*
+ * @Describe: 分块哈希比较, 只找出内容改变的块
+ *            只保存上一帧每块的哈希, 不需要上一帧的显存副本
+ */
+#ifndef __LCD_TILE_H
+#define __LCD_TILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 块大小 (像素), 宽度需为偶数 (按 32 位字计算哈希) */
+#define LCD_TILE_W      16
+#define LCD_TILE_H      16
+
+#define LCD_TILE_COLS(w)    (((w) + LCD_TILE_W - 1) / LCD_TILE_W)
+#define LCD_TILE_ROWS(h)    (((h) + LCD_TILE_H - 1) / LCD_TILE_H)
+
+/* 哈希后端: 每块 reset 一次, 逐行 feed, 最后取 result */
+typedef struct __lcd_tile_hash_ops {
+    void (*reset)(void* ctx);
+    void (*feed)(void* ctx, const uint16_t* pixels, uint32_t count);
+    uint32_t (*result)(void* ctx);
+} lcd_tile_hash_ops;
+
+/* 软件 CRC-32, 与 STM32 CRC 单元结果一致 (多项式 0x04C11DB7, 初值 0xFFFFFFFF, 按字输入);
+   ctx 指向一个 uint32_t */
+extern const lcd_tile_hash_ops lcd_tile_hash_soft;
+/* 片上 CRC 单元, 与 lcd_tile_hash_soft 结果相同, ctx 不使用 (lcd_tile_port.c 实现, LCD_TILE_HW_CRC 为 1 时) */
+extern const lcd_tile_hash_ops lcd_tile_hash_crc;
+
+typedef struct __lcd_tiles {
+    uint16_t width, height;     // 显存尺寸
+    uint16_t cols, rows;
+    uint32_t* hash;             // cols*rows 个, 调用者提供
+    bool valid;                 // hash 中是否为上一帧的值
+} lcd_tiles;
+
+/* 改变的区域回调: 同一行中相邻的改变块合并为一段 */
+typedef void (*lcd_tile_emit)(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+
+void lcd_tiles_init(lcd_tiles* tiles, uint16_t width, uint16_t height, uint32_t* hash);
+void lcd_tiles_invalidate(lcd_tiles* tiles);
+uint32_t lcd_tiles_scan(lcd_tiles* tiles, const uint16_t* fb,
+                        const lcd_tile_hash_ops* ops, void* hash_ctx,
+                        lcd_tile_emit emit, void* ctx);
+
+#endif
@@ -0,0 +1,33 @@
+#include "main.h"
+#include "lcd_port.h"
+#include "lcd_tile.h"
+
+#if LCD_TILE_HW_CRC
+/* CRC 单元只在这里使用, 时钟在第一次 reset 时打开; 多个任务同时计算时需自行加锁 */
+static void lcd_crc_reset(void* ctx)
+{
+    (void)ctx;
+    if(!(RCC->AHB1ENR & RCC_AHB1ENR_CRCEN))
+        __HAL_RCC_CRC_CLK_ENABLE();
+    CRC->CR = CRC_CR_RESET;
+}
+
+static void lcd_crc_feed(void* ctx, const uint16_t* pixels, uint32_t count)
+{
+    (void)ctx;
+    for(uint32_t i = 0; i + 1 < count; i += 2)
+        CRC->DR = (uint32_t)pixels[i] | ((uint32_t)pixels[i + 1] << 16);
+}
+
+static uint32_t lcd_crc_result(void* ctx)
+{
+    (void)ctx;
+    return CRC->DR;
+}
+
+const lcd_tile_hash_ops lcd_tile_hash_crc = {
+    .reset  = lcd_crc_reset,
+    .feed   = lcd_crc_feed,
+    .result = lcd_crc_result,
+};
+#endif
@@ -0,0 +1,104 @@
+#include "lcd_vsync.h"
+
+void lcd_vsync_init(lcd_vsync* vs, uint32_t guard, uint32_t blank)
+{
+    vs->guard      = guard;
+    vs->blank      = blank;
+    vs->period     = 0;
+    vs->flush_time = 0;
+    vs->edge       = 0;
+    vs->start      = 0;
+    vs->seen       = false;
+    vs->pending    = false;
+    vs->busy       = false;
+    vs->flushes    = 0;
+    vs->missed     = 0;
+}
+
+/* TE 边沿后最早可以开始的时刻:
+   刷新慢于扫描时若在消隐期内开始, 写入会先领先扫描, 之后被追上;
+   要等扫描离开消隐期, 从后面追赶扫描 */
+uint32_t lcd_vsync_delay(const lcd_vsync* vs)
+{
+    if(vs->period && vs->flush_time > vs->period)
+        return vs->blank;
+    return 0;
+}
+
+/* TE 边沿后最晚可以开始的时刻:
+   刷新耗时 F 不超过周期 T 时写入快于扫描, 在消隐期内开始且 F 加上起点不超过 T 就一直领先扫描;
+   T < F <= 2T 时在扫描之后开始, 要在下一帧扫描到达前写完, 最晚为 2T - F;
+   F > 2T 时不存在不撕裂的起点, 只能尽早开始 */
+uint32_t lcd_vsync_window(const lcd_vsync* vs)
+{
+    uint32_t t = vs->period;
+    uint32_t f = vs->flush_time;
+
+    if(!t || !f)
+        return vs->guard;
+    if(f <= t)
+        return t - f < vs->guard ? t - f : vs->guard;
+    if(f <= 2 * t)
+        return 2 * t - f;
+    return 0;
+}
+
+static void lcd_vsync_start(lcd_vsync* vs, uint32_t at)
+{
+    vs->pending = false;
+    vs->busy    = true;
+    vs->start   = at;
+    vs->flushes++;
+}
+
+/* 一帧已准备好: 窗口还没过去时返回 true, 在 vs->start 开始; 否则挂起等下一个 TE */
+bool lcd_vsync_request(lcd_vsync* vs, uint32_t now)
+{
+    uint32_t since = now - vs->edge;
+    uint32_t delay = lcd_vsync_delay(vs);
+
+    if(!vs->busy && vs->seen && since <= lcd_vsync_window(vs)) {
+        lcd_vsync_start(vs, since < delay ? vs->edge + delay : now);
+        return true;
+    }
+
+    vs->pending = true;
+    return false;
+}
+
+/* TE 中断中调用, 返回 true 表示挂起的帧应在 vs->start 开始 */
+bool lcd_vsync_edge(lcd_vsync* vs, uint32_t now)
+{
+    if(vs->seen)
+        vs->period = now - vs->edge;
+    vs->edge = now;
+    vs->seen = true;
+
+    if(!vs->pending)
+        return false;
+
+    /* 上一帧还没发完 */
+    if(vs->busy) {
+        vs->missed++;
+        return false;
+    }
+
+    lcd_vsync_start(vs, now + lcd_vsync_delay(vs));
+    return true;
+}
+
+/* 等不到 TE (未接线或面板未输出) 时不再等待, 直接开始 */
+void lcd_vsync_force(lcd_vsync* vs, uint32_t now)
+{
+    vs->missed++;
+    lcd_vsync_start(vs, now);
+}
+
+void lcd_vsync_done(lcd_vsync* vs, uint32_t now)
+{
+    if(!vs->busy)
+        return;
+
+    vs->busy       = false;
+    vs->flush_time = now - vs->start;
+}
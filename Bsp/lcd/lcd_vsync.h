@@ -0,0 +1,35 @@
+/*
+ * @Describe: TE 同步刷新调度
+ *            时间单位由调用者决定 (移植层使用 DWT 周期计数), 回绕按无符号差处理
+ */
+#ifndef __LCD_VSYNC_H
+#define __LCD_VSYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct __lcd_vsync {
+    uint32_t guard;         // 刷新快于扫描时, TE 边沿 (消隐期开始) 后允许开始的时长
+    uint32_t blank;         // 消隐期长度, 刷新慢于扫描时等扫描离开消隐期再开始
+    uint32_t period;        // 测得的 TE 周期, 0 表示未知
+    uint32_t flush_time;    // 上一次刷新的耗时, 0 表示未知
+    uint32_t edge;          // 最近一次 TE 边沿
+    uint32_t start;         // 当前刷新的开始时间, 可能晚于开始的决定 (调用者等到该时刻再发送)
+
+    bool seen;              // 已收到过 TE
+    bool pending;           // 一帧已准备好, 等下一个 TE
+    bool busy;              // 刷新进行中
+
+    uint32_t flushes;       // 已开始的刷新次数
+    uint32_t missed;        // 准备好的帧没能赶上的 TE 次数 (含等待超时)
+} lcd_vsync;
+
+void lcd_vsync_init(lcd_vsync* vs, uint32_t guard, uint32_t blank);
+uint32_t lcd_vsync_delay(const lcd_vsync* vs);
+uint32_t lcd_vsync_window(const lcd_vsync* vs);
+bool lcd_vsync_request(lcd_vsync* vs, uint32_t now);
+bool lcd_vsync_edge(lcd_vsync* vs, uint32_t now);
+void lcd_vsync_force(lcd_vsync* vs, uint32_t now);
+void lcd_vsync_done(lcd_vsync* vs, uint32_t now);
+
+#endif
@@ -0,0 +1,47 @@
+#include "lcd_window.h"
+
+void lcd_window_reset(lcd_window* win)
+{
+    win->valid = false;
+    win->pos   = 0;
+}
+
+/* 返回需要发送的命令 (LCD_WIN_xxx), 并更新缓存 */
+uint8_t lcd_window_set(lcd_window* win, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    uint8_t cmds = LCD_WIN_RAMWR;
+
+    /* 同列宽、同结束行, 且写指针恰好停在新起始行行首: 直接续写 */
+    if(win->valid && x1 == win->x1 && x2 == win->x2 && y2 == win->y2 && y1 > win->y1) {
+        uint16_t width = x2 - x1 + 1;
+
+        if(win->pos % width == 0 && y1 == win->y1 + win->pos / width)
+            return LCD_WIN_RAMWRC;
+    }
+
+    if(!win->valid || x1 != win->x1 || x2 != win->x2)
+        cmds |= LCD_WIN_CASET;
+    if(!win->valid || y1 != win->y1 || y2 != win->y2)
+        cmds |= LCD_WIN_RASET;
+
+    win->x1    = x1;
+    win->y1    = y1;
+    win->x2    = x2;
+    win->y2    = y2;
+    win->pos   = 0;
+    win->valid = true;
+
+    return cmds;
+}
+
+/* 记录写入的像素数, 写满窗口后面板写指针回到起点 */
+void lcd_window_advance(lcd_window* win, uint32_t pixels)
+{
+    uint32_t area;
+
+    if(!win->valid)
+        return;
+
+    area = (uint32_t)(win->x2 - win->x1 + 1) * (win->y2 - win->y1 + 1);
+    win->pos = (win->pos + pixels) % area;
+}
@@ -0,0 +1,26 @@
+/*
+ * @Describe: 面板 CASET/RASET 窗口状态缓存
+ */
+#ifndef __LCD_WINDOW_H
+#define __LCD_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LCD_WIN_CASET   0x01    // 需要发送列地址
+#define LCD_WIN_RASET   0x02    // 需要发送行地址
+#define LCD_WIN_RAMWR   0x04    // 从窗口起点开始写
+#define LCD_WIN_RAMWRC  0x08    // 从上次写入位置继续写 (0x3C)
+
+/* 面板当前窗口 (逻辑坐标, 不含偏移) 及写指针 */
+typedef struct __lcd_window {
+    uint16_t x1, y1, x2, y2;
+    uint32_t pos;       // RAMWR 之后已写入的像素数 (按窗口面积回绕)
+    bool valid;
+} lcd_window;
+
+void lcd_window_reset(lcd_window* win);
+uint8_t lcd_window_set(lcd_window* win, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+void lcd_window_advance(lcd_window* win, uint32_t pixels);
+
+#endif
@@ -0,0 +1,110 @@
+#include "lcd_xfer.h"
+
+void lcd_xfer_init(lcd_xfer* xfer, const lcd_xfer_ops* ops, void* ctx)
+{
+    xfer->ops      = ops;
+    xfer->ctx      = ctx;
+    xfer->state    = LCD_XFER_IDLE;
+    xfer->complete = 0;
+    xfer->error    = 0;
+    xfer->seg_max  = 0;
+    xfer->fixed    = false;
+    xfer->data     = 0;
+    xfer->seg_len  = 0;
+    xfer->remain   = 0;
+}
+
+/* 启动下一段 */
+static bool lcd_xfer_next(lcd_xfer* xfer)
+{
+    uint32_t len = xfer->remain;
+
+    if(xfer->seg_max && len > xfer->seg_max)
+        len = xfer->seg_max;
+
+    xfer->seg_len = len;
+    return xfer->ops->start(xfer->ctx, xfer->data, len);
+}
+
+static void lcd_xfer_done(lcd_xfer* xfer)
+{
+    xfer->state = LCD_XFER_IDLE;
+    xfer->complete++;
+
+    if(xfer->ops->notify)
+        xfer->ops->notify(xfer->ctx);
+}
+
+static bool lcd_xfer_start(lcd_xfer* xfer, const uint8_t* data, uint32_t len, bool fixed)
+{
+    if(!xfer->ops || !xfer->ops->start || !len)
+        return false;
+
+    lcd_xfer_wait(xfer);
+
+    xfer->fixed  = fixed;
+    xfer->data   = data;
+    xfer->remain = len;
+    xfer->state  = LCD_XFER_BUSY;
+    if(!lcd_xfer_next(xfer)) {
+        xfer->state = LCD_XFER_IDLE;
+        return false;
+    }
+    return true;
+}
+
+/* 启动一次异步传输, 上一次传输未完成时先等待 */
+bool lcd_xfer_submit(lcd_xfer* xfer, const uint8_t* data, uint32_t len)
+{
+    return lcd_xfer_start(xfer, data, len, false);
+}
+
+/* 源地址固定的传输, 后端需关闭存储器地址递增; 分段时不移动 unit */
+bool lcd_xfer_repeat(lcd_xfer* xfer, const uint8_t* unit, uint32_t len)
+{
+    return lcd_xfer_start(xfer, unit, len, true);
+}
+
+/* 传输完成中断中调用: 还有剩余则接续下一段, 全部完成才通知一次 */
+void lcd_xfer_isr(lcd_xfer* xfer)
+{
+    if(xfer->state != LCD_XFER_BUSY)
+        return;
+
+    if(!xfer->fixed)
+        xfer->data += xfer->seg_len;
+    xfer->remain -= xfer->seg_len;
+
+    if(xfer->remain) {
+        if(lcd_xfer_next(xfer))
+            return;
+        xfer->error++;
+    }
+
+    lcd_xfer_done(xfer);
+}
+
+/* 错误中断中调用: 当前段已失败, 剩余部分不再发送, 记为错误并唤醒等待者 */
+void lcd_xfer_abort(lcd_xfer* xfer)
+{
+    if(xfer->state != LCD_XFER_BUSY)
+        return;
+
+    xfer->error++;
+    xfer->remain = 0;
+    lcd_xfer_done(xfer);
+}
+
+/* 通知可能残留 (上一次未被取走), 所以要循环检查状态 */
+void lcd_xfer_wait(lcd_xfer* xfer)
+{
+    while(xfer->state == LCD_XFER_BUSY) {
+        if(xfer->ops->wait)
+            xfer->ops->wait(xfer->ctx);
+    }
+}
+
+bool lcd_xfer_busy(lcd_xfer* xfer)
+{
+    return xfer->state == LCD_XFER_BUSY;
+}
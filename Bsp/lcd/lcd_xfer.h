@@ -0,0 +1,51 @@
+/*
+ * @Describe: LCD 批量传输状态机
+ */
+#ifndef __LCD_XFER_H
+#define __LCD_XFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LCD_XFER_IDLE = 0,
+    LCD_XFER_BUSY,
+} lcd_xfer_state;
+
+/* 传输后端
+ * start : 启动一段异步发送, 返回 false 表示后端不可用 (由调用者回退到阻塞发送)
+ *         分段传输时会在完成中断中调用
+ * wait  : 阻塞等待一次完成通知 (任务上下文)
+ * notify: 唤醒等待者 (中断上下文)
+ */
+typedef struct __lcd_xfer_ops {
+    bool (*start)(void* ctx, const uint8_t* data, uint32_t len);
+    void (*wait)(void* ctx);
+    void (*notify)(void* ctx);
+} lcd_xfer_ops;
+
+typedef struct __lcd_xfer {
+    const lcd_xfer_ops* ops;
+    void* ctx;
+
+    volatile lcd_xfer_state state;
+    volatile uint32_t complete;     // 已完成的传输次数
+    volatile uint32_t error;        // 中途启动失败或出错中止的传输次数
+
+    /* 分段: 超过 seg_max 字节的传输拆成多段, 在完成中断中接续 */
+    uint32_t seg_max;               // 单段最大字节数, 0 为不限
+    bool fixed;                     // 源地址不递增 (重复发送同一数据)
+    const uint8_t* data;            // 当前段起始地址
+    uint32_t seg_len;               // 当前段字节数
+    uint32_t remain;                // 含当前段在内的剩余字节数
+} lcd_xfer;
+
+void lcd_xfer_init(lcd_xfer* xfer, const lcd_xfer_ops* ops, void* ctx);
+bool lcd_xfer_submit(lcd_xfer* xfer, const uint8_t* data, uint32_t len);
+bool lcd_xfer_repeat(lcd_xfer* xfer, const uint8_t* unit, uint32_t len);
+void lcd_xfer_isr(lcd_xfer* xfer);
+void lcd_xfer_abort(lcd_xfer* xfer);
+void lcd_xfer_wait(lcd_xfer* xfer);
+bool lcd_xfer_busy(lcd_xfer* xfer);
+
+#endif
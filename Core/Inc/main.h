@@ -75,6 +75,15 @@ void Error_Handler(void);
 #define LCD_PWR_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
+/* LCD 所在 SPI: 默认 0 使用 .ioc 中配置的 SPI3 (APB1, SCK 最高 25MHz);
+   定义为 1 (如 -DLCD_BUS_SPI1=1) 改用 SPI1 (APB2, PB3/PB5 AF5, 最高 50MHz), 启动时释放 SPI3 的引脚 */
+#ifndef LCD_BUS_SPI1
+#define LCD_BUS_SPI1    0
+#endif
+
+/* LCD TE (tearing effect) 输入, EXTI9_5 */
+#define LCD_TE_Pin GPIO_PIN_8
+#define LCD_TE_GPIO_Port GPIOB
 
 /* USER CODE END Private defines */
 
@@ -34,6 +34,8 @@ extern "C" {
 
 extern SPI_HandleTypeDef hspi3;
 
+extern DMA_HandleTypeDef hdma_spi3_tx;
+
 /* USER CODE BEGIN Private defines */
 
 /* USER CODE END Private defines */
@@ -41,6 +43,10 @@ extern SPI_HandleTypeDef hspi3;
 void MX_SPI3_Init(void);
 
 /* USER CODE BEGIN Prototypes */
+extern SPI_HandleTypeDef hspi1;
+extern DMA_HandleTypeDef hdma_spi1_tx;
+
+void MX_SPI1_Init(void);
 
 /* USER CODE END Prototypes */
 
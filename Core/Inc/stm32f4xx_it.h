@@ -52,8 +52,11 @@ void MemManage_Handler(void);
 void BusFault_Handler(void);
 void UsageFault_Handler(void);
 void DebugMon_Handler(void);
+void DMA1_Stream5_IRQHandler(void);
 void TIM1_UP_TIM10_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA2_Stream3_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
 
 /* USER CODE END EFP */
 
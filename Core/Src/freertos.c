@@ -28,15 +28,23 @@
 #include "RGB.h"
 #include "lcd.h"
 #include "lcd_anim.h"
+#include "lcd_pacer.h"
+#include "lcd_server.h"
+#include <stdio.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
+extern SPI_HandleTypeDef hspi1;
 extern SPI_HandleTypeDef hspi3;
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+/* 面板 TE 接到 LCD_TE_Pin 时置 1, 刷新与面板扫描同步 */
+#define LCD_USE_VSYNC   0
+/* 渲染循环的目标帧率, 超出预算时由 lcd_pacer 逐级降低质量 */
+#define LCD_TARGET_FPS  30
 
 /* USER CODE END PD */
 
@@ -47,23 +55,37 @@ extern SPI_HandleTypeDef hspi3;
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-static uint16_t line_buffer[240];
+static uint16_t line_buffer[LCD_LINE_MAX];
+static uint16_t line_buffer_alt[LCD_LINE_MAX];
+
+/* LCD 所在 SPI 总线, 同一总线上的其他设备共用它排队 */
+static lcd_bus lcd_spi_bus;
 
 lcd_io lcd_io_desc = {
+#if LCD_BUS_SPI1
+    .spi = &hspi1,
+#else
     .spi = &hspi3,
+#endif
     .rst = {LCD_RST_GPIO_Port, LCD_RST_Pin, 0},
     .bl  = {LCD_PWR_GPIO_Port, LCD_PWR_Pin, 0},
     .cs  = {LCD_CS_GPIO_Port, LCD_CS_Pin, 0},
     .dc  = {LCD_DC_GPIO_Port,  LCD_DC_Pin,  0},
-    .te  = { /* TE */ }
+    .te  = {LCD_TE_GPIO_Port, LCD_TE_Pin, 0},
+    .bus = &lcd_spi_bus,
 };
 
 lcd lcd_desc = {
     .io = &lcd_io_desc,
     .line_buffer = line_buffer,
+    .line_buffer_alt = line_buffer_alt,
 };
 
 extern uint16_t g_gram[];
+
+/* HUD 覆盖层: 240 x 135 每像素 1 位, 4,320 Bytes */
+static uint32_t hud_bits[LCD_OVERLAY_WORDS(240) * 135];
+static lcd_overlay hud;
 /* USER CODE END Variables */
 /* Definitions for defaultTask */
 osThreadId_t defaultTaskHandle;
@@ -143,6 +165,7 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_SEMAPHORES */
   /* add semaphores, ... */
+  lcd_server_rtos_init(); // 其他任务通过显示服务绘制, LCDTask 独占面板
   /* USER CODE END RTOS_SEMAPHORES */
 
   /* USER CODE BEGIN RTOS_TIMERS */
@@ -201,11 +224,15 @@ void StartDefaultTask(void *argument)
 void RGB_StartTask(void *argument)
 {
   /* USER CODE BEGIN RGB_StartTask */
+  static const uint16_t swatch[7] = { RED, GREEN, BLUE, YELLOW, MAGENTA, CYAN, WHITE };
   uint8_t color_index = 0;
   /* Infinite loop */
   for(;;)
   {
     RGB_SetColor(color_index);
+    // 右边缘显示 LED 颜色, 由 LCDTask 执行; 服务命令直接画到面板, 不经过显存,
+    // 所以放在动画区域之外: cube2 中心 x=170, 尺寸 25 的投影半径不超过 60, 只到 x=230
+    lcd_server_fill(&lcd_server_rtos, 1, 232, 4, 239, 15, swatch[color_index]);
     
     color_index++;
     if(color_index >= 7) {
@@ -228,22 +255,52 @@ void LCD_StartTask(void *argument)
   /* USER CODE BEGIN LCD_StartTask */
   
   lcd_init_dev(&lcd_desc, LCD_1_14_INCH, LCD_ROTATE_90);
-  lcd_anim_init_buffer(); // 清空显存
+  lcd_set_vsync(&lcd_desc, LCD_USE_VSYNC);
+  lcd_surface* screen = lcd_anim_init_buffer(&lcd_desc); // 清空显存
+  configASSERT(screen);
+#if LCD_M2M_DMA
+  lcd_m2m_dma2_init();
+  lcd_anim_set_m2m(&lcd_m2m_dma2); // 整屏清空交给 DMA2
+#endif
+
+  // HUD: 帧率画在覆盖层上, 刷新时合成, 不触发显存重画
+  bool hud_ok = lcd_overlay_init(&hud, hud_bits, sizeof(hud_bits), screen->width, screen->height, WHITE);
+  configASSERT(hud_ok);
+  lcd_overlay_use_bitband(&hud);
+  lcd_overlay_string(&hud, 5, 5, &lcd_desc.font, "FPS:0 ");
+  lcd_anim_set_overlay(&hud);
+  lcd_server_size(&lcd_server_rtos, screen->width, screen->height);
 
   lcd_anim_cube_t cube1, cube2;
-  lcd_anim_cube_init(&cube1, &lcd_desc, 25.0f, RED, 70, 70);
-  lcd_anim_cube_init(&cube2, &lcd_desc, 25.0f, LIGHTBLUE, 170, 70);
+  lcd_anim_cube_init(&cube1, screen, 25.0f, RED, 70, 70);
+  lcd_anim_cube_init(&cube2, screen, 25.0f, LIGHTBLUE, 170, 70);
+  lcd_anim_cube_add(&cube1);
+  lcd_anim_cube_add(&cube2);
 
   uint32_t frame_count = 0;
   uint32_t last_tick = HAL_GetTick();
   uint32_t fps = 0;
+  uint32_t cube2_due = 0;   // 隔帧更新时 cube2 积累的步数
+
+  lcd_pacer pacer;
+  lcd_pacer_init(&pacer, pdMS_TO_TICKS(1000 / LCD_TARGET_FPS), LCD_PACE_LEVELS, xTaskGetTickCount());
 
   for(;;)
   {
-    memset(g_gram, 0, LCD_WIDTH * LCD_HEIGHT * 2);
-
-    lcd_anim_cube_update(&cube1);
-    lcd_anim_cube_update(&cube2);
+    // 动画按经过的帧周期推进, 速度与实际帧率无关
+    uint32_t steps = lcd_pacer_begin(&pacer, xTaskGetTickCount());
+
+    lcd_anim_flush_wait(screen);
+
+    cube2_due += steps;
+    while (steps--)
+        lcd_anim_cube_step(&cube1);
+    if (!lcd_pacer_drop(&pacer, LCD_PACE_HALF_RATE)) {
+        while (cube2_due) {
+            lcd_anim_cube_step(&cube2);
+            cube2_due--;
+        }
+    }
 
     frame_count++;
     if (HAL_GetTick() - last_tick >= 1000)
@@ -252,13 +309,22 @@ void LCD_StartTask(void *argument)
         frame_count = 0;
         last_tick = HAL_GetTick();
         
-        lcd_print_ram(&lcd_desc, 5, 5, "FPS:%d ", fps);
-    } else {
-        lcd_print_ram(&lcd_desc, 5, 5, "FPS:%d ", fps);
+        if (!lcd_pacer_drop(&pacer, LCD_PACE_HUD)) {
+            char buf[16];
+
+            snprintf(buf, sizeof(buf), "FPS:%lu Q%u ", (unsigned long)fps, pacer.level);
+            lcd_overlay_string(&hud, 5, 5, &lcd_desc.font, buf);
+        }
     }
 
-    lcd_anim_flush(&lcd_desc);
-    osDelay(1);
+    lcd_anim_update();
+    // 隔帧发送时改变的区域留在 s_damage 中, 下一次一起发送
+    if (!lcd_pacer_drop(&pacer, LCD_PACE_FLUSH))
+        lcd_anim_flush(screen);
+    // 其他任务提交的绘制在显存之上执行
+    lcd_server_poll(&lcd_server_rtos, &lcd_desc);
+
+    vTaskDelayUntil(&pacer.wake, lcd_pacer_end(&pacer, xTaskGetTickCount()));
   }
   /* USER CODE END LCD_StartTask */
 }
@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "cmsis_os.h"
+#include "dma.h"
 #include "spi.h"
 #include "gpio.h"
 
@@ -89,8 +90,14 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_SPI3_Init();
   /* USER CODE BEGIN 2 */
+#if LCD_BUS_SPI1
+  /* LCD 引脚改由 SPI1 驱动 */
+  HAL_SPI_DeInit(&hspi3);
+  MX_SPI1_Init();
+#endif
 
   /* USER CODE END 2 */
 
@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "lcd_console.h"
 
 
 /* Variables */
@@ -36,6 +37,14 @@ extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
 
 
+#if LCD_CONSOLE_STDOUT
+/* printf 输出到 lcd_console_stdout 绑定的 LCD 控制台 */
+int __io_putchar(int ch)
+{
+  return lcd_console_putchar(ch);
+}
+#endif
+
 char *__env[1] = { 0 };
 char **environ = __env;
 
@@ -0,0 +1,13 @@
+# 运行两个测试程序, 各自把输出写入文件, 检查两个程序都通过且输出完全相同
+#   cmake -DA=<程序> -DB=<程序> -DDIR=<输出目录> -P compare.cmake
+foreach(prog A B)
+    execute_process(COMMAND ${${prog}} ${DIR}/${prog}.bin RESULT_VARIABLE rc)
+    if(rc)
+        message(FATAL_ERROR "${${prog}} failed (${rc})")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${DIR}/A.bin ${DIR}/B.bin RESULT_VARIABLE rc)
+if(rc)
+    message(FATAL_ERROR "output of ${A} and ${B} differs")
+endif()
@@ -0,0 +1,416 @@
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "panel.h"
+
+/* 与 lcd_port.c 相同: 短数据阻塞发送 */
+#define PANEL_DMA_MIN_LEN   64
+
+void panel_init(panel* p)
+{
+    memset(p, 0, sizeof(*p));
+    p->xe = PANEL_GRAM_W - 1;
+    p->ye = PANEL_GRAM_H - 1;
+}
+
+void panel_clear_stats(panel* p)
+{
+    p->xfers       = 0;
+    p->pixel_xfers = 0;
+    p->commands    = 0;
+    p->cmd_bytes   = 0;
+    p->pixel_bytes = 0;
+    p->dc_toggles  = 0;
+    p->windows     = 0;
+    p->ramwr       = 0;
+    p->ramwrc      = 0;
+    p->bus_waits   = 0;
+    p->outside     = 0;
+}
+
+uint16_t panel_pixel(const panel* p, uint16_t x, uint16_t y)
+{
+    return p->gram[y][x];
+}
+
+uint16_t panel_lcd_pixel(const lcd* plcd, uint16_t x, uint16_t y)
+{
+    return panel_pixel(plcd->io->spi, x + plcd->offset[0], y + plcd->offset[2]);
+}
+
+bool panel_busy(const panel* p)
+{
+    return p->pending != NULL;
+}
+
+/* 滚动区的第一行显示帧存储器的 vsp 行, 之后在滚动区内回绕 */
+uint16_t panel_shown(const panel* p, uint16_t x, uint16_t line)
+{
+    if(p->vsa && line >= p->tfa && line < p->tfa + p->vsa)
+        line = p->tfa + (line - p->tfa + p->vsp - p->tfa) % p->vsa;
+    return p->gram[line][x];
+}
+
+/************ 面板解码 ************/
+static void panel_command(panel* p, uint8_t cmd)
+{
+    p->cmd    = cmd;
+    p->nparam = 0;
+    p->half   = false;
+    p->commands++;
+    p->cmd_bytes++;
+
+    switch(cmd) {
+    case 0x2a:
+    case 0x2b:
+        p->windows++;
+        break;
+    case 0x2c:      // RAMWR: 从窗口起点开始
+        p->x = p->xs;
+        p->y = p->ys;
+        p->ramwr++;
+        break;
+    case 0x3c:      // RAMWRC: 从上次位置继续
+        p->ramwrc++;
+        break;
+    case 0x2e:      // RAMRD: 从窗口起点读
+        p->x  = p->xs;
+        p->y  = p->ys;
+        p->rd = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+/* 写指针在窗口内前进, 写满后回到起点 */
+static void panel_advance(panel* p)
+{
+    if(++p->x > p->xe) {
+        p->x = p->xs;
+        if(++p->y > p->ye)
+            p->y = p->ys;
+    }
+}
+
+static void panel_data(panel* p, uint8_t data)
+{
+    if(p->cmd == 0x2c || p->cmd == 0x3c) {
+        p->pixel_bytes++;
+        if(!p->half) {
+            p->high = data;
+            p->half = true;
+            return;
+        }
+        p->half = false;
+        if(p->x < PANEL_GRAM_W && p->y < PANEL_GRAM_H)
+            p->gram[p->y][p->x] = (uint16_t)(p->high << 8 | data);
+        panel_advance(p);
+        return;
+    }
+
+    p->cmd_bytes++;
+    if(p->nparam < sizeof(p->param))
+        p->param[p->nparam] = data;
+    p->nparam++;
+
+    if(p->nparam == 4 && p->cmd == 0x2a) {
+        p->xs = p->param[0] << 8 | p->param[1];
+        p->xe = p->param[2] << 8 | p->param[3];
+    } else if(p->nparam == 4 && p->cmd == 0x2b) {
+        p->ys = p->param[0] << 8 | p->param[1];
+        p->ye = p->param[2] << 8 | p->param[3];
+    } else if(p->nparam == 6 && p->cmd == 0x33) {
+        p->tfa = p->param[0] << 8 | p->param[1];
+        p->vsa = p->param[2] << 8 | p->param[3];
+    } else if(p->nparam == 2 && p->cmd == 0x37) {
+        p->vsp = p->param[0] << 8 | p->param[1];
+    }
+}
+
+static void panel_byte(panel* p, lcd_io* lcdio, uint8_t data)
+{
+    bool dc = lcdio->dc_level == 1;
+
+    // 事务之外, 或共享总线此时属于其他设备
+    if(!lcdio->bus_depth || (lcdio->bus && !lcd_bus_owned(lcdio->bus, &lcdio->bus_dev)))
+        p->outside++;
+    // 共享总线时让出处理器, 使其他线程的事务有机会插进来
+    if(lcdio->bus && ++p->bus_bytes % 256 == 0)
+        sched_yield();
+    if(p->log) {
+        fputc(dc, p->log);
+        fputc(data, p->log);
+    }
+    if(dc)
+        panel_data(p, data);
+    else
+        panel_command(p, data);
+}
+
+/* 统计一次 SPI 发送 */
+static void panel_count(panel* p, lcd_io* lcdio)
+{
+    p->xfers++;
+    if(lcdio->dc_level == 1 && (p->cmd == 0x2c || p->cmd == 0x3c))
+        p->pixel_xfers++;
+}
+
+/* wide 为 16 位帧: 每个半字高字节先发 */
+static void panel_bytes(lcd_io* lcdio, const uint8_t* data, uint32_t len, bool wide)
+{
+    for(uint32_t i = 0; i < len; i++) {
+        if(wide)
+            panel_byte(lcdio->spi, lcdio, data[i ^ 1]);
+        else
+            panel_byte(lcdio->spi, lcdio, data[i]);
+    }
+}
+
+/* 一次阻塞发送 */
+static void panel_wire(lcd_io* lcdio, const uint8_t* data, uint32_t len, bool wide)
+{
+    panel_count(lcdio->spi, lcdio);
+    panel_bytes(lcdio, data, len, wide);
+}
+
+/* 完成正在进行的异步发送 (已在提交时计数), 端口函数开始时都会调用 (lcd_port.c 中的 lcd_xfer_wait) */
+static void panel_sync(lcd_io* lcdio)
+{
+    panel* p = lcdio->spi;
+    const uint8_t* data = p->pending;
+
+    if(!data)
+        return;
+    p->pending = NULL;
+    panel_bytes(lcdio, data, p->pending_len, p->pending_wide);
+}
+
+static void panel_submit(lcd_io* lcdio, const uint8_t* data, uint32_t len, bool wide)
+{
+    panel* p = lcdio->spi;
+
+    if(!p->dma || len < PANEL_DMA_MIN_LEN) {
+        panel_wire(lcdio, data, len, wide);
+        return;
+    }
+    p->pending      = data;
+    p->pending_len  = len;
+    p->pending_wide = wide;
+    panel_count(p, lcdio);
+}
+
+/************ lcd_port 接口 ************/
+void lcd_delay(uint32_t delay)
+{
+}
+
+void lcd_io_init(lcd_io* lcdio)
+{
+    lcdio->dc_level  = 0xff;
+    lcdio->bus_depth = 0;
+}
+
+void lcd_io_rst(lcd_io* lcdio, bool flag)
+{
+}
+
+void lcd_io_bl(lcd_io* lcdio, bool flag)
+{
+}
+
+void lcd_io_cs(lcd_io* lcdio, bool flag)
+{
+}
+
+void lcd_io_dc(lcd_io* lcdio, bool flag)
+{
+    if(lcdio->dc_level == flag)
+        return;
+    lcdio->dc_level = flag;
+    ((panel *)lcdio->spi)->dc_toggles++;
+}
+
+void lcd_io_clock_init(lcd_io* lcdio, bool flag)
+{
+    lcdio->clock_init = flag;
+}
+
+/* 共享总线: 各 lcd_io 可在不同线程中使用, 用互斥量代替 lcd_port.c 中的关中断 */
+static pthread_mutex_t bus_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bus_cond = PTHREAD_COND_INITIALIZER;
+
+void lcd_io_begin(lcd_io* lcdio)
+{
+    panel* p = lcdio->spi;
+
+    if(lcdio->bus_depth++)
+        return;
+    panel_sync(lcdio);
+
+    if(lcdio->bus) {
+        pthread_mutex_lock(&bus_mutex);
+        if(!lcd_bus_acquire(lcdio->bus, &lcdio->bus_dev))
+            p->bus_waits++;
+        while(!lcd_bus_owned(lcdio->bus, &lcdio->bus_dev))
+            pthread_cond_wait(&bus_cond, &bus_mutex);
+        pthread_mutex_unlock(&bus_mutex);
+    }
+    lcdio->dc_level = 0xff;
+}
+
+/* 共享总线时先完成异步发送再移交 (lcd_port.c 中由完成中断移交) */
+void lcd_io_end(lcd_io* lcdio)
+{
+    if(!lcdio->bus_depth || --lcdio->bus_depth)
+        return;
+
+    if(lcdio->bus) {
+        panel_sync(lcdio);
+        pthread_mutex_lock(&bus_mutex);
+        lcd_bus_release(lcdio->bus, &lcdio->bus_dev);
+        pthread_cond_broadcast(&bus_cond);
+        pthread_mutex_unlock(&bus_mutex);
+    }
+}
+
+void lcd_io_te(lcd_io* lcdio, bool on)
+{
+    lcdio->vsync_on = on;
+}
+
+void lcd_io_vsync_begin(lcd_io* lcdio)
+{
+}
+
+void lcd_io_vsync_end(lcd_io* lcdio)
+{
+}
+
+void lcd_write_byte(lcd_io* lcdio, uint8_t data)
+{
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 1);
+    panel_wire(lcdio, &data, 1, false);
+}
+
+void lcd_write_halfword(lcd_io* lcdio, uint16_t data)
+{
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 1);
+    data = LCD_PIXEL(data);
+    panel_wire(lcdio, (const uint8_t *)&data, 2, LCD_SPI_16BIT);
+}
+
+void lcd_write_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    lcd_write_bulk_async(lcdio, data, len);
+    lcd_write_wait(lcdio);
+}
+
+void lcd_write_reg(lcd_io* lcdio, uint8_t data)
+{
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 0);
+    panel_wire(lcdio, &data, 1, false);
+}
+
+static void panel_cmd_send(void* ctx, bool dc, const uint8_t* data, uint32_t len)
+{
+    lcd_io_dc(ctx, dc);
+    panel_wire(ctx, data, len, false);
+}
+
+void lcd_write_cmds(lcd_io* lcdio, lcd_cmd_queue* queue)
+{
+    panel_sync(lcdio);
+    lcd_cmd_flush(queue, panel_cmd_send, lcdio);
+}
+
+void lcd_write_bulk_async(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 1);
+    panel_submit(lcdio, data, len, false);
+}
+
+void lcd_write_wait(lcd_io* lcdio)
+{
+    panel_sync(lcdio);
+}
+
+/* RGB565 按 RGB666 读出, 每个分量高位对齐 */
+static uint8_t panel_read_byte(panel* p)
+{
+    uint16_t pixel;
+    uint8_t data;
+
+    if(p->rd == 0) {
+        p->rd = 1;
+        return 0;
+    }
+    pixel = p->x < PANEL_GRAM_W && p->y < PANEL_GRAM_H ? p->gram[p->y][p->x] : 0;
+    switch(p->rd) {
+    case 1:  data = (pixel >> 11) << 3; break;
+    case 2:  data = ((pixel >> 5) & 0x3f) << 2; break;
+    default: data = (pixel & 0x1f) << 3; break;
+    }
+    if(++p->rd > 3) {
+        p->rd = 1;
+        panel_advance(p);
+    }
+    return data;
+}
+
+void lcd_read_bulk(lcd_io* lcdio, uint8_t* data, uint32_t len)
+{
+    panel* p = lcdio->spi;
+
+    panel_sync(lcdio);
+    p->read_bytes += len;
+    for(uint32_t i = 0; i < len; i++)
+        data[i] = p->cmd == 0x2e ? panel_read_byte(p) : 0;
+}
+
+void lcd_write_pixels(lcd_io* lcdio, const uint16_t* data, uint32_t count)
+{
+    lcd_write_pixels_async(lcdio, data, count);
+    lcd_write_wait(lcdio);
+}
+
+void lcd_write_pixels_async(lcd_io* lcdio, const uint16_t* data, uint32_t count)
+{
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 1);
+    panel_submit(lcdio, (const uint8_t *)data, count * 2, LCD_SPI_16BIT);
+}
+
+/* 需要 16 位帧与 DMA, 与 lcd_port.c 相同 */
+bool lcd_write_repeat(lcd_io* lcdio, uint16_t pixel, uint32_t count)
+{
+    panel* p = lcdio->spi;
+    bool ok = true;
+
+    if(!LCD_SPI_16BIT || !p->dma)
+        return false;
+
+    panel_sync(lcdio);
+    lcd_io_dc(lcdio, 1);
+    panel_count(p, lcdio);
+    // 模拟后续分段启动失败: 只发出一部分
+    if(p->repeat_fail && p->repeat_fail < count) {
+        count = p->repeat_fail;
+        p->repeat_fail = 0;
+        ok = false;
+    }
+    for(uint32_t i = 0; i < count; i++) {
+        panel_byte(p, lcdio, pixel >> 8);
+        panel_byte(p, lcdio, pixel & 0xff);
+    }
+    return ok;
+}
+
+bool lcd_io_has_dma(lcd_io* lcdio)
+{
+    return ((panel *)lcdio->spi)->dma;
+}
@@ -0,0 +1,69 @@
+/*
+ * @Describe: lcd_port 的主机实现与 ST7789 面板模型
+ *            lcd_io.spi 指向一个 panel, SPI 上的字节按 DC 解码为命令/参数/像素写入模拟的 GRAM;
+ *            帧宽度按 LCD_SPI_16BIT 模拟 (16 位帧高字节先发, 8 位帧按内存顺序), 与 lcd_port.c 相同;
+ *            lcd_read_bulk 按 RAMRD 的串口格式读回 GRAM;
+ *            lcd_io.bus 非 NULL 时多个 lcd_io 可在不同线程中共用总线
+ */
+#ifndef __PANEL_H
+#define __PANEL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd.h"
+
+/* ST7789 GRAM 240 x 320, 加上各型号的偏移后放得下 320 x 172 横屏 */
+#define PANEL_GRAM_W    320
+#define PANEL_GRAM_H    320
+
+typedef struct __panel {
+    uint16_t gram[PANEL_GRAM_H][PANEL_GRAM_W];  // 面板坐标 (含地址偏移), RGB565
+    bool dma;                   // lcd_io_has_dma, 为 true 时长数据异步发送
+    uint32_t repeat_fail;       // 非 0 时 lcd_write_repeat 只发送这么多像素后返回 false (分段接续失败)
+
+    /* 解码状态 */
+    uint8_t cmd;                // 最近的命令
+    uint8_t nparam;             // 已收到的参数字节数
+    uint8_t param[16];
+    uint16_t xs, xe, ys, ye;    // CASET/RASET
+    uint16_t x, y;              // 读写指针
+    uint16_t tfa, vsa, vsp;     // 垂直滚动: VSCRDEF (0x33) 与 VSCSAD (0x37), vsa 为 0 时不滚动
+    uint8_t rd;                 // RAMRD (0x2E) 之后已读出的字节: 先是无效字节, 之后每像素 R/G/B 3 字节
+    bool half;                  // 已收到像素的高字节
+    uint8_t high;
+
+    /* 异步发送: 到下一次端口调用或 lcd_write_wait 时才从内存取数据 (模拟 DMA 读取) */
+    const uint8_t* pending;
+    uint32_t pending_len;
+    bool pending_wide;
+
+    /* 统计 */
+    uint32_t xfers;             // SPI 发送次数 (阻塞发送或一次 DMA 提交)
+    uint32_t pixel_xfers;       // 其中发送像素数据的次数
+    uint32_t commands;          // 命令个数
+    uint32_t cmd_bytes;         // 命令及参数字节数
+    uint32_t pixel_bytes;       // RAMWR/RAMWRC 之后的像素字节数
+    uint32_t read_bytes;        // RAMRD 之后读回的字节数 (含无效字节)
+    uint32_t dc_toggles;        // DC 电平切换次数
+    uint32_t windows;           // CASET + RASET 个数
+    uint32_t ramwr;             // RAMWR (0x2C) 个数
+    uint32_t ramwrc;            // RAMWRC (0x3C) 个数
+    uint32_t outside;           // 事务之外或总线属于其他设备时发送的字节数
+    uint32_t bus_waits;         // 共享总线被占用而排队的事务数
+    uint32_t bus_bytes;         // 共享总线上发送的字节数
+
+    FILE* log;                  // 非 NULL 时记录 SPI 字节流: 每字节 [DC][数据]
+} panel;
+
+void panel_init(panel* p);
+void panel_clear_stats(panel* p);
+/* 面板坐标中的像素 (已含地址偏移) */
+uint16_t panel_pixel(const panel* p, uint16_t x, uint16_t y);
+/* lcd 逻辑坐标中的像素, 按 plcd 的型号/方向换算偏移 */
+uint16_t panel_lcd_pixel(const lcd* plcd, uint16_t x, uint16_t y);
+bool panel_busy(const panel* p);
+/* 屏幕第 line 行 (面板坐标) 显示的像素, 按垂直滚动换算到帧存储器 */
+uint16_t panel_shown(const panel* p, uint16_t x, uint16_t line);
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * @Describe: 主机测试的检查宏, 失败时打印位置并继续, main 返回 test_result()
+ */
+#ifndef __TEST_H
+#define __TEST_H
+
+#include <stdio.h>
+
+static int test_failed;
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        test_failed++; \
+    } \
+} while(0)
+
+#define CHECK_EQ(a, b) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if(_a != _b) { \
+        printf("%s:%d: %s == %s failed (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+        test_failed++; \
+    } \
+} while(0)
+
+static inline int test_result(void)
+{
+    if(test_failed)
+        printf("%d check(s) failed\n", test_failed);
+    return test_failed != 0;
+}
+
+#endif
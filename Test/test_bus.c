@@ -0,0 +1,159 @@
+/*
+ * @Describe: 共享总线: lcd_bus 排队规则, 以及两块屏在两个线程中同时绘制时总线上的事务不交错
+ */
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+#include "panel.h"
+
+/* 高优先级先得, 同优先级先到先得, 总线移交给队首 */
+static void test_queue(void)
+{
+    lcd_bus bus;
+    lcd_bus_dev a = { .priority = 1 }, b = { .priority = 1 }, c = { .priority = 2 }, d = { .priority = 0 };
+
+    lcd_bus_init(&bus);
+    CHECK(lcd_bus_acquire(&bus, &a));
+    CHECK(lcd_bus_acquire(&bus, &a));           // 持有者再次获取
+    CHECK(!lcd_bus_acquire(&bus, &d));
+    CHECK(!lcd_bus_acquire(&bus, &b));
+    CHECK(!lcd_bus_acquire(&bus, &c));
+    CHECK(!lcd_bus_acquire(&bus, &b));          // 已在队列中不重复排队
+    CHECK(lcd_bus_owned(&bus, &a));
+
+    CHECK(lcd_bus_release(&bus, &b) == NULL);   // 不是持有者
+    CHECK(lcd_bus_owned(&bus, &a));
+
+    CHECK(lcd_bus_release(&bus, &a) == &c);
+    CHECK(lcd_bus_owned(&bus, &c));
+    CHECK(lcd_bus_release(&bus, &c) == &b);
+    CHECK(lcd_bus_release(&bus, &b) == &d);
+    CHECK(lcd_bus_release(&bus, &d) == NULL);
+    CHECK(bus.owner == NULL && bus.wait == NULL);
+}
+
+static lcd_bus bus;
+static panel pnl[2];
+static lcd_io io[2] = {
+    { .spi = &pnl[0], .bus = &bus },
+    { .spi = &pnl[1], .bus = &bus },
+};
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev[2] = {
+    { .io = &io[0], .line_buffer = line[0] },
+    { .io = &io[1], .line_buffer = line[1] },
+};
+
+static bool rect_is(const lcd* plcd, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+    for(uint16_t y = y1; y <= y2; y++)
+        for(uint16_t x = x1; x <= x2; x++)
+            if(panel_lcd_pixel(plcd, x, y) != color)
+                return false;
+    return true;
+}
+
+/* 同型号两块屏, 方向不同: 各自的尺寸互不覆盖, 也不修改型号模板 */
+static void test_geometry(void)
+{
+    lcd_bus_init(&bus);
+    for(int i = 0; i < 2; i++)
+        panel_init(&pnl[i]);
+    lcd_init_dev(&lcd_dev[0], LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_init_dev(&lcd_dev[1], LCD_1_14_INCH, LCD_ROTATE_0);
+
+    CHECK_EQ(lcd_dev[0].hw->width, 240);
+    CHECK_EQ(lcd_dev[0].hw->height, 135);
+    CHECK_EQ(lcd_dev[1].hw->width, 135);
+    CHECK_EQ(lcd_dev[1].hw->height, 240);
+    CHECK_EQ(lcd_hw_1_14.width, 240);
+    CHECK_EQ(lcd_hw_1_14.rotate, LCD_ROTATE_270);
+    CHECK(rect_is(&lcd_dev[0], 0, 0, 239, 134, BLACK));
+    CHECK(rect_is(&lcd_dev[1], 0, 0, 134, 239, BLACK));
+}
+
+static volatile bool fill_done;
+
+static void* fill_blocked(void* arg)
+{
+    lcd_fill(&lcd_dev[1], 0, 0, 99, 99, RED);
+    fill_done = true;
+    return NULL;
+}
+
+/* 总线被占用时另一块屏的事务排队, 释放后才开始 */
+static void test_wait(void)
+{
+    pthread_t thread;
+
+    lcd_io_begin(&io[0]);
+    pthread_create(&thread, NULL, fill_blocked, NULL);
+    while(!pnl[1].bus_waits)
+        sched_yield();
+
+    lcd_fill(&lcd_dev[0], 0, 0, 99, 99, GREEN);
+    CHECK(!fill_done);
+    CHECK(rect_is(&lcd_dev[1], 0, 0, 99, 99, BLACK));
+    lcd_io_end(&io[0]);
+
+    pthread_join(thread, NULL);
+    CHECK(fill_done);
+    CHECK(rect_is(&lcd_dev[0], 0, 0, 99, 99, GREEN));
+    CHECK(rect_is(&lcd_dev[1], 0, 0, 99, 99, RED));
+    CHECK_EQ(pnl[0].outside + pnl[1].outside, 0);
+}
+
+#define ROUNDS  40
+
+static pthread_barrier_t start;
+
+static void* draw_loop(void* arg)
+{
+    lcd* plcd = arg;
+    uint16_t w = plcd->hw->width, h = plcd->hw->height;
+
+    lcd_set_font(plcd, FONT_1608, WHITE, BLUE);
+    pthread_barrier_wait(&start);
+    for(int i = 0; i < ROUNDS; i++) {
+        lcd_fill(plcd, 0, 0, w - 1, h - 1, i & 1 ? RED : GREEN);
+        lcd_show_string(plcd, 0, 0, (const uint8_t *)"shared bus");
+        lcd_draw_line(plcd, 0, h - 1, w - 1, h - 1, YELLOW);
+    }
+    return NULL;
+}
+
+/* 两块屏同时绘制: 每个字节都在自己持有总线的事务内发出, 各屏内容完整 */
+static void test_concurrent(void)
+{
+    pthread_t thread[2];
+
+    for(int i = 0; i < 2; i++)
+        panel_clear_stats(&pnl[i]);
+    pthread_barrier_init(&start, NULL, 2);
+    for(int i = 0; i < 2; i++)
+        pthread_create(&thread[i], NULL, draw_loop, &lcd_dev[i]);
+    for(int i = 0; i < 2; i++)
+        pthread_join(thread[i], NULL);
+    pthread_barrier_destroy(&start);
+
+    printf("2 panels x %d rounds: bytes %u + %u, queued transactions %u + %u\n", ROUNDS,
+           pnl[0].cmd_bytes + pnl[0].pixel_bytes, pnl[1].cmd_bytes + pnl[1].pixel_bytes,
+           pnl[0].bus_waits, pnl[1].bus_waits);
+    for(int i = 0; i < 2; i++) {
+        uint16_t w = lcd_dev[i].hw->width, h = lcd_dev[i].hw->height;
+
+        CHECK_EQ(pnl[i].outside, 0);
+        CHECK(rect_is(&lcd_dev[i], 0, 16, w - 1, h - 2, RED));      // 最后一轮 (奇数)
+        CHECK(rect_is(&lcd_dev[i], 0, h - 1, w - 1, h - 1, YELLOW));
+    }
+    CHECK(bus.owner == NULL && bus.wait == NULL);
+}
+
+int main(void)
+{
+    test_queue();
+    test_geometry();
+    test_wait();
+    test_concurrent();
+    return test_result();
+}
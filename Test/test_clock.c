@@ -0,0 +1,82 @@
+/*
+ * @Describe: lcd_clock 分频推导: STM32F411 时钟树下 SPI3 (APB1) 与 SPI1 (APB2) 的各阶段 SCK
+ */
+#include "test.h"
+#include "lcd_clock.h"
+
+static const lcd_clock_cfg default_cfg = {
+    .hz = {
+        [LCD_CLK_INIT]  = LCD_CLK_INIT_HZ,
+        [LCD_CLK_CMD]   = LCD_CLK_CMD_HZ,
+        [LCD_CLK_PIXEL] = LCD_CLK_PIXEL_HZ,
+        [LCD_CLK_READ]  = LCD_CLK_READ_HZ,
+    },
+};
+
+static void test_br(void)
+{
+    CHECK_EQ(lcd_clock_pclk(100000000, 2), 50000000);
+    CHECK_EQ(lcd_clock_pclk(100000000, 1), 100000000);
+    CHECK_EQ(lcd_clock_pclk(100000000, 0), 100000000);
+
+    CHECK_EQ(lcd_clock_hz(100000000, 0), 50000000);
+    CHECK_EQ(lcd_clock_hz(100000000, 7), 390625);
+
+    // 恰好等于目标时取该档, 否则取不超过目标的最高档
+    CHECK_EQ(lcd_clock_br(100000000, 50000000), 0);
+    CHECK_EQ(lcd_clock_br(100000000, 49999999), 1);
+    CHECK_EQ(lcd_clock_br(100000000, 25000000), 1);
+    CHECK_EQ(lcd_clock_br(50000000, 12500000), 1);      // 原 SPI3 的 SPI_BAUDRATEPRESCALER_4
+    CHECK_EQ(lcd_clock_br(100000000, 1000000000), 0);
+    // 目标过低时取最大分频
+    CHECK_EQ(lcd_clock_br(100000000, 1000), LCD_CLK_BR_MAX);
+    CHECK_EQ(lcd_clock_br(100000000, 0), LCD_CLK_BR_MAX);
+
+    for(uint32_t target = 100000; target <= 80000000; target = target * 3 / 2) {
+        uint8_t br = lcd_clock_br(100000000, target);
+
+        if(br < LCD_CLK_BR_MAX)
+            CHECK(lcd_clock_hz(100000000, br) <= target);
+        if(br > 0)
+            CHECK(lcd_clock_hz(100000000, br - 1) > target);
+    }
+}
+
+static void check_profile(const char* name, uint32_t pclk, uint32_t spi_max, const uint8_t* expect)
+{
+    static const char* phases[] = { "init", "cmd", "pixel", "read" };
+    lcd_clock_cfg cfg = default_cfg;
+    lcd_clock_profile profile;
+
+    cfg.spi_max = spi_max;
+    lcd_clock_profile_make(&profile, pclk, &cfg);
+    printf("%s (PCLK %u MHz)\n", name, pclk / 1000000);
+    for(int i = 0; i < LCD_CLK_PHASES; i++) {
+        uint32_t hz = lcd_clock_hz(pclk, profile.br[i]);
+
+        CHECK_EQ(profile.br[i], expect[i]);
+        CHECK(hz <= cfg.hz[i] || profile.br[i] == LCD_CLK_BR_MAX);
+        CHECK(!spi_max || hz <= spi_max);
+        printf("  %-6s BR=%u  %8.3f MHz\n", phases[i], profile.br[i], hz / 1e6);
+    }
+}
+
+/* SYSCLK 100MHz, APB1 /2, APB2 /1 */
+static void test_profiles(void)
+{
+    static const uint8_t spi3[] = { 2, 0, 0, 3 };
+    static const uint8_t spi1[] = { 3, 1, 0, 4 };
+    static const uint8_t spi1_84[] = { 3, 1, 0, 3 };
+
+    check_profile("SPI3 / APB1", lcd_clock_pclk(100000000, 2), 25000000, spi3);
+    check_profile("SPI1 / APB2", lcd_clock_pclk(100000000, 1), 50000000, spi1);
+    // SYSCLK 84MHz: 各档随时钟树变化
+    check_profile("SPI1 / APB2 @84MHz", lcd_clock_pclk(84000000, 1), 50000000, spi1_84);
+}
+
+int main(void)
+{
+    test_br();
+    test_profiles();
+    return test_result();
+}
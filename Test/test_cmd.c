@@ -0,0 +1,160 @@
+/*
+ * @Describe: lcd_cmd 命令包: 打包格式与发送分段; 与逐条发送比较传输次数和 DC 切换次数
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+
+typedef struct {
+    int segments;
+    int commands;
+    uint8_t bytes[64];
+    uint32_t len;
+} fake_emit;
+
+static void emit(void* ctx, bool dc, const uint8_t* data, uint32_t len)
+{
+    fake_emit* e = ctx;
+
+    e->segments++;
+    e->commands += !dc;
+    memcpy(&e->bytes[e->len], data, len);
+    e->len += len;
+}
+
+/* 每个命令包发送两段: 命令字节 + 全部参数; 发送后队列清空 */
+static void test_queue(void)
+{
+    lcd_cmd_queue queue = { 0 };
+    fake_emit e = { 0 };
+    static const uint8_t wire[] = { 0x2a, 0x00, 0x28, 0x01, 0x17, 0x2b, 0x00, 0x35, 0x2c };
+
+    CHECK(lcd_cmd_begin(&queue, 0x2a));
+    CHECK(lcd_cmd_param16(&queue, 40));
+    CHECK(lcd_cmd_param16(&queue, 279));
+    CHECK(lcd_cmd_begin(&queue, 0x2b));
+    CHECK(lcd_cmd_param(&queue, 0x00));
+    CHECK(lcd_cmd_param(&queue, 0x35));
+    CHECK(lcd_cmd_begin(&queue, 0x2c));
+    CHECK_EQ(queue.used, 2 + 4 + 2 + 2 + 2);
+
+    lcd_cmd_flush(&queue, emit, &e);
+    CHECK_EQ(e.segments, 5);
+    CHECK_EQ(e.commands, 3);
+    CHECK_EQ(e.len, sizeof(wire));
+    CHECK(memcmp(e.bytes, wire, sizeof(wire)) == 0);
+    CHECK_EQ(queue.used, 0);
+
+    // 恰好填满
+    for(int i = 0; i < LCD_CMD_QUEUE_SIZE / 2; i++)
+        CHECK(lcd_cmd_begin(&queue, 0x00));
+    CHECK_EQ(queue.used, LCD_CMD_QUEUE_SIZE);
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line };
+
+/* 改动前的发送方式: 每个命令字节与每个半字参数各一次 SPI 发送 */
+static void point_unbatched(uint16_t x, uint16_t y, uint16_t color)
+{
+    const uint8_t* offset = lcd_dev.offset;
+
+    lcd_io_begin(&io);
+    lcd_write_reg(&io, 0x2a);
+    lcd_write_halfword(&io, x + offset[0]);
+    lcd_write_halfword(&io, x + offset[1]);
+    lcd_write_reg(&io, 0x2b);
+    lcd_write_halfword(&io, y + offset[2]);
+    lcd_write_halfword(&io, y + offset[3]);
+    lcd_write_reg(&io, 0x2c);
+    lcd_write_halfword(&io, color);
+    lcd_io_end(&io);
+}
+
+/* 命令包方式; 每次复位窗口缓存, 只比较打包带来的差别 */
+static void point_batched(uint16_t x, uint16_t y, uint16_t color)
+{
+    lcd_window_reset(&lcd_dev.window);
+    lcd_draw_point(&lcd_dev, x, y, color);
+}
+
+typedef struct {
+    uint32_t xfers;
+    uint32_t dc_toggles;
+    char* stream;
+    size_t size;
+} point_cost;
+
+static void run_points(void (*fn)(uint16_t, uint16_t, uint16_t), point_cost* cost)
+{
+    pnl.log = open_memstream(&cost->stream, &cost->size);
+    panel_clear_stats(&pnl);
+    for(int i = 0; i < 100; i++)
+        fn(i * 2, i % 135, (uint16_t)(i * 0x0841));
+    fclose(pnl.log);
+    pnl.log = NULL;
+    cost->xfers = pnl.xfers;
+    cost->dc_toggles = pnl.dc_toggles;
+}
+
+static void test_transport(void)
+{
+    point_cost before, after;
+
+    panel_init(&pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+
+    run_points(point_unbatched, &before);
+    run_points(point_batched, &after);
+
+    // 面板收到的字节完全相同, 只是分段更少
+    CHECK_EQ(before.size, after.size);
+    CHECK(memcmp(before.stream, after.stream, before.size) == 0);
+    CHECK_EQ(before.xfers, 800);
+    CHECK_EQ(after.xfers, 600);
+    // DC 只在命令与参数之间切换 (lcd_io_dc 缓存电平), 两种方式相同
+    CHECK_EQ(after.dc_toggles, before.dc_toggles);
+    for(int i = 0; i < 100; i++)
+        CHECK_EQ(panel_lcd_pixel(&lcd_dev, i * 2, i % 135), (uint16_t)(i * 0x0841));
+
+    printf("100 x lcd_draw_point   transfers  DC toggles\n");
+    printf("  unbatched            %9u  %10u\n", before.xfers, before.dc_toggles);
+    printf("  command packets      %9u  %10u\n", after.xfers, after.dc_toggles);
+    free(before.stream);
+    free(after.stream);
+}
+
+/* lcd_config_reg 的可变参数完整打包: 最长的 0.96" gamma 设置 */
+static void test_config_reg(void)
+{
+    static const uint8_t gamma[] = { 0x07, 0x0E, 0x08, 0x07, 0x10, 0x07, 0x02, 0x07,
+                                     0x09, 0x0F, 0x25, 0x36, 0x00, 0x08, 0x04, 0x10 };
+
+    panel_init(&pnl);
+    lcd_io_begin(&io);
+    lcd_config_reg(&io, 0xE0, 0x07, 0x0E, 0x08, 0x07, 0x10, 0x07, 0x02, 0x07,
+                   0x09, 0x0F, 0x25, 0x36, 0x00, 0x08, 0x04, 0x10);
+    lcd_io_end(&io);
+    CHECK_EQ(pnl.cmd, 0xE0);
+    CHECK_EQ(pnl.nparam, sizeof(gamma));
+    CHECK(memcmp(pnl.param, gamma, sizeof(gamma)) == 0);
+    CHECK_EQ(pnl.xfers, 2);
+
+    // 三种面板的初始化序列都放得下 (放不下时断言失败)
+    for(int type = LCD_0_96_INCH; type <= LCD_1_47_INCH; type++) {
+        panel_init(&pnl);
+        lcd_init_dev(&lcd_dev, type, LCD_ROTATE_90);
+        CHECK_EQ(pnl.outside, 0);
+    }
+}
+
+int main(void)
+{
+    test_queue();
+    test_transport();
+    test_config_reg();
+    return test_result();
+}
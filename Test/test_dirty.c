@@ -0,0 +1,158 @@
+/*
+ * @Describe: 脏矩形: lcd_dirty 的裁剪与合并, 以及动画每帧只发送改变区域的字节数 (与整帧发送比较)
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+#define W   240
+#define H   135
+
+static uint8_t cover[H][W];
+
+/* 输入的每个像素都被输出的某个矩形覆盖, 输出都在屏幕内 */
+static bool covers(const lcd_dirty* dirty, const lcd_rect* in, int n)
+{
+    memset(cover, 0, sizeof(cover));
+    for(uint8_t i = 0; i < dirty->count; i++) {
+        const lcd_rect* r = &dirty->rect[i];
+
+        if(r->x1 < 0 || r->y1 < 0 || r->x2 >= W || r->y2 >= H || r->x1 > r->x2 || r->y1 > r->y2)
+            return false;
+        for(int y = r->y1; y <= r->y2; y++)
+            memset(&cover[y][r->x1], 1, r->x2 - r->x1 + 1);
+    }
+    for(int i = 0; i < n; i++)
+        for(int y = in[i].y1; y <= in[i].y2; y++)
+            for(int x = in[i].x1; x <= in[i].x2; x++)
+                if(!cover[y][x])
+                    return false;
+    return true;
+}
+
+static void test_add(void)
+{
+    lcd_dirty dirty;
+    lcd_rect in[40];
+
+    // 裁剪, 交换端点, 空区域忽略
+    lcd_dirty_init(&dirty, W, H);
+    lcd_dirty_add(&dirty, -10, -5, 9, 4);
+    lcd_dirty_add(&dirty, 300, 0, 400, 10);
+    lcd_dirty_add(&dirty, 239, 134, 230, 130);
+    CHECK_EQ(dirty.count, 2);
+    CHECK(dirty.rect[0].x1 == 0 && dirty.rect[0].y1 == 0 && dirty.rect[0].x2 == 9 && dirty.rect[0].y2 == 4);
+    CHECK(dirty.rect[1].x1 == 230 && dirty.rect[1].y1 == 130 && dirty.rect[1].x2 == 239 && dirty.rect[1].y2 == 134);
+    CHECK_EQ(lcd_dirty_area(&dirty), 50 + 50);
+
+    // 相邻或包含时合并; 相距较远时各发各的
+    lcd_dirty_reset(&dirty);
+    lcd_dirty_add(&dirty, 0, 0, 9, 9);
+    lcd_dirty_add(&dirty, 10, 0, 19, 9);
+    lcd_dirty_add(&dirty, 5, 5, 6, 6);
+    CHECK_EQ(dirty.count, 1);
+    CHECK_EQ(lcd_dirty_area(&dirty), 200);
+    lcd_dirty_add(&dirty, 100, 100, 109, 109);
+    CHECK_EQ(dirty.count, 2);
+    // 合并后多出的像素不超过 LCD_DIRTY_OVERHEAD
+    lcd_dirty_reset(&dirty);
+    lcd_dirty_add(&dirty, 0, 0, 0, 31);
+    lcd_dirty_add(&dirty, 2, 0, 2, 31);
+    CHECK_EQ(dirty.count, 1);
+    lcd_dirty_add(&dirty, 0, 40, 0, 71);
+    lcd_dirty_add(&dirty, 10, 40, 10, 71);
+    CHECK_EQ(dirty.count, 3);
+
+    // 超过 LCD_DIRTY_MAX 个分散的矩形: 合并代价最小的, 仍覆盖全部输入
+    lcd_dirty_reset(&dirty);
+    for(int i = 0; i < 40; i++) {
+        in[i] = (lcd_rect){ i * 37 % 230, i * 23 % 130, i * 37 % 230 + 3, i * 23 % 130 + 2 };
+        lcd_dirty_add(&dirty, in[i].x1, in[i].y1, in[i].x2, in[i].y2);
+        CHECK(dirty.count <= LCD_DIRTY_MAX);
+        CHECK(covers(&dirty, in, i + 1));
+    }
+    CHECK(lcd_dirty_area(&dirty) < W * H);
+
+    // 合并另一个集合
+    {
+        lcd_dirty other;
+
+        lcd_dirty_init(&other, W, H);
+        lcd_dirty_reset(&dirty);
+        for(int i = 0; i < 20; i++) {
+            lcd_dirty_add(i & 1 ? &other : &dirty, in[i].x1, in[i].y1, in[i].x2, in[i].y2);
+        }
+        lcd_dirty_merge(&dirty, &other);
+        CHECK(covers(&dirty, in, 20));
+    }
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+static bool panel_is_gram(void)
+{
+    for(uint16_t y = 0; y < H; y++)
+        for(uint16_t x = 0; x < W; x++)
+            if(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)) != g_gram[y * W + x])
+                return false;
+    return true;
+}
+
+#define FRAMES  60
+
+/* 立方体平移旋转加一行文字: 每帧清屏重画, 只发送上一帧与这一帧画过的区域 */
+static void test_frames(void)
+{
+    lcd_surface* screen;
+    lcd_anim_cube_t cube;
+    uint32_t bytes = 0;
+
+    panel_init(&pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    CHECK(screen != NULL);
+    lcd_set_font(&lcd_dev, FONT_1206, WHITE, BLACK);
+    lcd_anim_cube_init(&cube, screen, 30, LIGHTBLUE, 60, 67);
+
+    for(int f = 0; f <= FRAMES; f++) {
+        lcd_anim_clear();
+        cube.cx = 60 + f * 2;
+        lcd_anim_cube_update(&cube);
+        lcd_print_ram(screen, 5, 5, "frame %d", f);
+
+        panel_clear_stats(&pnl);
+        lcd_anim_flush(screen);
+        lcd_anim_flush_wait(screen);
+        if(f == 0) {
+            // 第一帧发送全屏
+            CHECK(pnl.pixel_bytes >= W * H * 2);
+        } else {
+            bytes += pnl.cmd_bytes + pnl.pixel_bytes;
+        }
+        if(f % 20 == 0)
+            CHECK(panel_is_gram());
+    }
+
+    printf("  %d frames: %u bytes/frame, full frame %u (%.1f%%)\n", FRAMES, bytes / FRAMES,
+           W * H * 2, 100.0 * bytes / FRAMES / (W * H * 2));
+    CHECK(bytes / FRAMES < W * H * 2 * 6 / 10);
+
+    // 没有改变时不发送
+    panel_clear_stats(&pnl);
+    lcd_anim_flush(screen);
+    CHECK_EQ(pnl.xfers, 0);
+}
+
+int main(void)
+{
+    test_add();
+    test_frames();
+    return test_result();
+}
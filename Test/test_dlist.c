@@ -0,0 +1,232 @@
+/*
+ * @Describe: 保留模式: lcd_dlist 对移动/改色/加入/移除给出的重画区域,
+ *            以及 lcd_anim_update 只重画改变的区域后, 画面与整屏重画相同
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+/************ lcd_dlist ************/
+static char drawn[32];
+static int ndrawn;
+static lcd_rect regions[8];
+static int nregions;
+static bool region_end;
+
+static void draw(void* obj)
+{
+    drawn[ndrawn++] = *(const char *)obj;
+    drawn[ndrawn] = '\0';
+}
+
+static void region(void* ctx, const lcd_rect* r)
+{
+    if(!r) {
+        region_end = true;
+        return;
+    }
+    regions[nregions++] = *r;
+}
+
+static bool rect_eq(const lcd_rect* r, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    return r->x1 == x1 && r->y1 == y1 && r->x2 == x2 && r->y2 == y2;
+}
+
+/* damage 中恰好是这些矩形 (顺序不限) */
+static bool damage_is(const lcd_dirty* d, int n, const lcd_rect* rects)
+{
+    if(d->count != n)
+        return false;
+    for(int i = 0; i < n; i++) {
+        bool found = false;
+
+        for(int j = 0; j < d->count; j++)
+            found |= rect_eq(&d->rect[j], rects[i].x1, rects[i].y1, rects[i].x2, rects[i].y2);
+        if(!found)
+            return false;
+    }
+    return true;
+}
+
+static void diff(lcd_dlist* list, lcd_dirty* d)
+{
+    lcd_dirty_reset(d);
+    lcd_dlist_diff(list, d);
+}
+
+static void test_list(void)
+{
+    static const char name[] = "abc";
+    lcd_dlist list;
+    lcd_dlist_item a, b, c;
+    lcd_dirty d;
+
+    lcd_dlist_init(&list);
+    lcd_dirty_init(&d, 240, 135);
+    lcd_dlist_add(&list, &a, draw, (void *)&name[0]);
+    lcd_dlist_add(&list, &b, draw, (void *)&name[1]);
+    lcd_dlist_set(&a, 0, 0, 9, 9, 1);
+    lcd_dlist_set(&b, 100, 100, 119, 109, 2);
+
+    // 加入: 新外包框
+    diff(&list, &d);
+    CHECK(damage_is(&d, 2, (lcd_rect[]){ { 0, 0, 9, 9 }, { 100, 100, 119, 109 } }));
+    // 没有改变
+    diff(&list, &d);
+    CHECK_EQ(d.count, 0);
+    lcd_dlist_set(&a, 0, 0, 9, 9, 1);
+    diff(&list, &d);
+    CHECK_EQ(d.count, 0);
+
+    // 移动: 新旧外包框
+    lcd_dlist_set(&b, 200, 10, 219, 19, 2);
+    diff(&list, &d);
+    CHECK(damage_is(&d, 2, (lcd_rect[]){ { 100, 100, 119, 109 }, { 200, 10, 219, 19 } }));
+    // 改色: 同一外包框
+    lcd_dlist_set(&a, 0, 0, 9, 9, 3);
+    diff(&list, &d);
+    CHECK(damage_is(&d, 1, (lcd_rect[]){ { 0, 0, 9, 9 } }));
+
+    // 移除最后一个: 旧外包框, 之后加入的接在 a 后面
+    lcd_dlist_remove(&list, &b);
+    diff(&list, &d);
+    CHECK(damage_is(&d, 1, (lcd_rect[]){ { 200, 10, 219, 19 } }));
+    CHECK(list.head == &a && list.tail == &a && a.next == NULL);
+    lcd_dlist_add(&list, &c, draw, (void *)&name[2]);
+    lcd_dlist_set(&c, 5, 5, 14, 14, 4);
+    CHECK(a.next == &c && list.tail == &c);
+    // 加入后在画出之前移除: 不产生重画
+    lcd_dlist_add(&list, &b, draw, (void *)&name[1]);
+    lcd_dlist_set(&b, 50, 50, 59, 59, 5);
+    lcd_dlist_remove(&list, &b);
+    diff(&list, &d);
+    CHECK(damage_is(&d, 1, (lcd_rect[]){ { 5, 5, 14, 14 } }));
+    CHECK(list.tail == &c && c.next == NULL);
+
+    // 重画: 每个区域只画相交的对象, 按列表顺序
+    lcd_dirty_reset(&d);
+    lcd_dirty_add(&d, 8, 8, 8, 8);
+    lcd_dirty_add(&d, 100, 100, 110, 110);
+    ndrawn = nregions = 0;
+    region_end = false;
+    lcd_dlist_render(&list, &d, region, NULL);
+    CHECK(strcmp(drawn, "ac") == 0);
+    CHECK_EQ(nregions, 2);
+    CHECK(region_end);
+
+    // 空的外包框不产生重画
+    lcd_dlist_set(&a, 0, 0, -1, -1, 6);
+    diff(&list, &d);
+    CHECK(damage_is(&d, 1, (lcd_rect[]){ { 0, 0, 9, 9 } }));
+
+    // FNV-1a
+    CHECK_EQ(lcd_dlist_key(LCD_DLIST_KEY_INIT, "a", 1), 0xe40c292cu);
+    CHECK_EQ(lcd_dlist_key(LCD_DLIST_KEY_INIT, "", 0), LCD_DLIST_KEY_INIT);
+}
+
+/************ lcd_anim 保留模式 ************/
+static panel pnl, ref_pnl;
+static lcd_io io = { .spi = &pnl }, ref_io = { .spi = &ref_pnl };
+static uint16_t line[2][LCD_LINE_MAX], ref_line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+static lcd ref_lcd = { .io = &ref_io, .line_buffer = ref_line };
+
+static lcd_anim_shape_t box, bar, diag;
+static lcd_anim_text_t label;
+static bool box_on, bar_on, label_on;
+
+/* 参考: 在另一块屏上按列表顺序整屏重画 */
+static void draw_ref(void)
+{
+    lcd_clear(&ref_lcd, BLACK);
+    if(box_on)
+        lcd_fill(&ref_lcd, box.x1, box.y1, box.x2, box.y2, box.color);
+    lcd_draw_line(&ref_lcd, diag.x1, diag.y1, diag.x2, diag.y2, diag.color);
+    if(label_on) {
+        ref_lcd.font = label.font;
+        lcd_show_string(&ref_lcd, label.x, label.y, (const uint8_t *)label.text);
+    }
+    if(bar_on)
+        lcd_fill(&ref_lcd, bar.x1, bar.y1, bar.x2, bar.y2, bar.color);
+}
+
+static bool frame_is_ref(lcd_surface* screen, uint32_t* bytes)
+{
+    panel_clear_stats(&pnl);
+    lcd_anim_update();
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    *bytes = pnl.cmd_bytes + pnl.pixel_bytes;
+
+    draw_ref();
+    for(uint16_t y = 0; y < 135; y++)
+        for(uint16_t x = 0; x < 240; x++)
+            if(panel_lcd_pixel(&lcd_dev, x, y) != panel_lcd_pixel(&ref_lcd, x, y))
+                return false;
+    return true;
+}
+
+static void test_retained(void)
+{
+    lcd_surface* screen;
+    uint32_t bytes;
+
+    panel_init(&pnl);
+    panel_init(&ref_pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_init_dev(&ref_lcd, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_set_font(&lcd_dev, FONT_1608, WHITE, BLUE);
+
+    lcd_anim_rect_add(&box, screen, 10, 10, 59, 39, RED);
+    lcd_anim_line_add(&diag, screen, 0, 134, 239, 0, YELLOW);
+    lcd_anim_text_add(&label, screen, 20, 20);
+    lcd_anim_text_printf(&label, "retained %d", 1);
+    box_on = label_on = true;
+    CHECK(frame_is_ref(screen, &bytes));
+
+    // 没有改变时不发送
+    CHECK(frame_is_ref(screen, &bytes));
+    CHECK_EQ(bytes, 0);
+
+    // 移动: 旧位置露出下面的线段与文字
+    lcd_anim_shape_set(&box, 100, 60, 149, 89, RED);
+    CHECK(frame_is_ref(screen, &bytes));
+    CHECK(bytes < 240 * 135 * 2 / 2);
+    printf("  move rect:      %6u bytes\n", bytes);
+
+    // 改色: 只重画文字
+    lcd_anim_text_color(&label, BLACK, GREEN);
+    CHECK(frame_is_ref(screen, &bytes));
+    CHECK(bytes < (11 * 8 + 8) * 16 * 2 * 2);
+    printf("  recolour text:  %6u bytes\n", bytes);
+
+    // 内容改变
+    lcd_anim_text_printf(&label, "retained %d", 22);
+    CHECK(frame_is_ref(screen, &bytes));
+
+    // 加入: 画在最上面
+    lcd_anim_rect_add(&bar, screen, 0, 28, 239, 31, MAGENTA);
+    bar_on = true;
+    CHECK(frame_is_ref(screen, &bytes));
+    printf("  add bar:        %6u bytes\n", bytes);
+
+    // 移除
+    lcd_anim_remove(&label.item);
+    label_on = false;
+    CHECK(frame_is_ref(screen, &bytes));
+    lcd_anim_remove(&box.item);
+    box_on = false;
+    CHECK(frame_is_ref(screen, &bytes));
+    printf("  remove rect:    %6u bytes (full frame %u)\n", bytes, 240 * 135 * 2);
+}
+
+int main(void)
+{
+    test_list();
+    test_retained();
+    return test_result();
+}
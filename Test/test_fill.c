@@ -0,0 +1,133 @@
+/*
+ * @Describe: 纯色填充: lcd_fill_plan 的分段规划, 以及 lcd_fill 在三种方式下的结果与传输次数
+ */
+#include "test.h"
+#include "panel.h"
+
+static void check_plan(uint16_t w, uint16_t h, uint32_t seg_max, bool dma, bool line_buffer,
+                       lcd_fill_mode mode, uint32_t segments, uint32_t seg_len, uint32_t last_len)
+{
+    lcd_fill_plan plan;
+
+    lcd_fill_plan_make(&plan, w, h, seg_max, dma, line_buffer);
+    CHECK_EQ(plan.mode, mode);
+    CHECK_EQ(plan.pixels, (uint32_t)w * h);
+    CHECK_EQ(plan.segments, segments);
+    CHECK_EQ(plan.seg_len, seg_len);
+    CHECK_EQ(plan.last_len, last_len);
+    if(segments)
+        CHECK_EQ((segments - 1) * seg_len + last_len, plan.pixels);
+}
+
+static void test_plan(void)
+{
+    // 有 DMA: 整块一次或按 seg_max 分段
+    check_plan(240, 135, 0xffff, true, true, LCD_FILL_REPEAT, 1, 32400, 32400);
+    check_plan(320, 172, 0xffff, true, true, LCD_FILL_REPEAT, 1, 55040, 55040);
+    check_plan(240, 320, 0xffff, true, true, LCD_FILL_REPEAT, 2, 0xffff, 76800 - 0xffff);
+    check_plan(255, 257, 0xffff, true, false, LCD_FILL_REPEAT, 1, 0xffff, 0xffff);
+    check_plan(256, 256, 0xffff, true, false, LCD_FILL_REPEAT, 2, 0xffff, 1);
+
+    // 太小不值得启动 DMA
+    check_plan(31, 1, 0xffff, true, true, LCD_FILL_LINES, 1, 31, 31);
+    check_plan(32, 1, 0xffff, true, true, LCD_FILL_REPEAT, 1, 32, 32);
+
+    // 没有 DMA (或 seg_max 为 0): 行缓冲逐行, 没有行缓冲逐点
+    check_plan(100, 20, 0xffff, false, true, LCD_FILL_LINES, 20, 100, 100);
+    check_plan(100, 20, 0, true, true, LCD_FILL_LINES, 20, 100, 100);
+    check_plan(10, 3, 0xffff, false, false, LCD_FILL_POINT, 30, 1, 1);
+
+    // 空区域不发送
+    check_plan(0, 10, 0xffff, true, true, LCD_FILL_LINES, 0, 0, 0);
+    check_plan(0, 10, 0xffff, false, false, LCD_FILL_POINT, 0, 1, 0);
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io };
+
+static bool rect_is(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+    for(uint16_t y = y1; y <= y2; y++)
+        for(uint16_t x = x1; x <= x2; x++)
+            if(panel_lcd_pixel(&lcd_dev, x, y) != color)
+                return false;
+    return true;
+}
+
+static void setup(bool dma, bool line_buffer)
+{
+    panel_init(&pnl);
+    pnl.dma = dma;
+    lcd_dev.line_buffer = line_buffer ? line : NULL;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+}
+
+/* 三种方式结果相同; 打印全屏清除的传输次数 */
+static void test_modes(void)
+{
+    static const struct {
+        const char* name;
+        bool dma, line_buffer;
+        uint32_t xfers;         // 全屏 240 x 135 的像素数据传输次数
+    } modes[] = {
+        { "repeat (DMA)", true,  true,  1 },
+        { "line buffer",  false, true,  135 },
+        { "per point",    false, false, 240 * 135 },
+    };
+
+    printf("lcd_clear 240x135   pixel transfers\n");
+    for(int i = 0; i < 3; i++) {
+        setup(modes[i].dma, modes[i].line_buffer);
+        lcd_clear(&lcd_dev, RED);
+        CHECK(rect_is(0, 0, 239, 134, RED));
+
+        lcd_fill(&lcd_dev, 20, 30, 119, 79, GREEN);
+        CHECK(rect_is(20, 30, 119, 79, GREEN));
+        CHECK(rect_is(0, 0, 239, 29, RED));
+        CHECK(rect_is(120, 30, 239, 79, RED));
+
+        panel_clear_stats(&pnl);
+        lcd_fill(&lcd_dev, 0, 0, 239, 134, BLUE);
+        CHECK(rect_is(0, 0, 239, 134, BLUE));
+        CHECK_EQ(pnl.pixel_bytes, 240 * 135 * 2);
+        CHECK_EQ(pnl.pixel_xfers, modes[i].xfers);
+        printf("  %-16s  %9u\n", modes[i].name, pnl.pixel_xfers);
+    }
+}
+
+/* DMA 中途失败只发出一部分: 回退后整块重发, 之后的绘制不受影响 */
+static void test_fallback(void)
+{
+    setup(true, true);
+    lcd_clear(&lcd_dev, RED);
+
+    pnl.repeat_fail = 1000;
+    lcd_fill(&lcd_dev, 10, 10, 109, 59, GREEN);
+    CHECK_EQ(pnl.repeat_fail, 0);
+    CHECK(rect_is(10, 10, 109, 59, GREEN));
+    CHECK(rect_is(10, 60, 109, 60, RED));
+
+    // 同列宽续写下面的行 (窗口缓存可能使用 RAMWRC)
+    lcd_fill(&lcd_dev, 10, 60, 109, 99, BLUE);
+    CHECK(rect_is(10, 10, 109, 59, GREEN));
+    CHECK(rect_is(10, 60, 109, 99, BLUE));
+    CHECK(rect_is(10, 100, 109, 134, RED));
+
+    // 没有行缓冲时回退到逐点
+    setup(true, false);
+    lcd_clear(&lcd_dev, RED);
+    pnl.repeat_fail = 7;
+    lcd_fill(&lcd_dev, 0, 0, 39, 9, WHITE);
+    CHECK(rect_is(0, 0, 39, 9, WHITE));
+    CHECK(rect_is(40, 0, 239, 9, RED));
+}
+
+int main(void)
+{
+    test_plan();
+    test_modes();
+    test_fallback();
+    return test_result();
+}
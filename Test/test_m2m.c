@@ -0,0 +1,327 @@
+/*
+ * @Describe: 存储器到存储器传输: lcd_m2m_plan 的拆段规则 (对齐/零头/单段上限),
+ *            以及模拟 DMA 后端 (完成/启动失败/传输出错) 与 CPU 完成的显存结果相同
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "lcd_m2m.h"
+
+/************ 模拟 DMA: start 记下一段, wait 时完成并调用 lcd_m2m_isr ************/
+#define SEG_LOG 64
+
+typedef struct {
+    lcd_m2m* m2m;
+    lcd_m2m_seg pending;
+    bool active;
+    int fail_start;                 // 每 N 段启动失败一次, 0 为不失败
+    int fail_xfer;                  // 每 N 段传输出错一次
+    int started, lock_depth;
+    bool misaligned, nested;
+    uint32_t dma_bytes, notified;
+    lcd_m2m_seg log[SEG_LOG];
+    int logged;
+} sim_dma;
+
+static bool sim_start(void* ctx, const lcd_m2m_seg* seg)
+{
+    sim_dma* d = ctx;
+
+    if(seg->len < LCD_M2M_MIN_LEN || seg->len % seg->width || seg->len / seg->width > LCD_M2M_MAX_ITEMS ||
+       ((uintptr_t)seg->dst | (uintptr_t)seg->src) & (seg->width - 1))
+        d->misaligned = true;
+    d->started++;
+    if(d->logged < SEG_LOG)
+        d->log[d->logged++] = *seg;
+    if(d->fail_start && d->started % d->fail_start == 0)
+        return false;
+    d->pending = *seg;
+    d->active = true;
+    return true;
+}
+
+static void sim_complete(sim_dma* d)
+{
+    const lcd_m2m_seg* seg = &d->pending;
+    bool ok = !(d->fail_xfer && d->started % d->fail_xfer == 0);
+
+    d->active = false;
+    if(ok) {
+        for(uint32_t i = 0; i < seg->len; i += seg->width)
+            memcpy(seg->dst + i, seg->src + (seg->fixed ? 0 : i), seg->width);
+        d->dma_bytes += seg->len;
+    }
+    lcd_m2m_isr(d->m2m, ok);
+}
+
+static void sim_wait(void* ctx)
+{
+    sim_dma* d = ctx;
+
+    if(d->active)
+        sim_complete(d);
+}
+
+static void sim_notify(void* ctx)
+{
+    ((sim_dma *)ctx)->notified++;
+}
+
+static void sim_lock(void* ctx)
+{
+    sim_dma* d = ctx;
+
+    d->nested |= d->lock_depth != 0;
+    d->lock_depth++;
+}
+
+static void sim_unlock(void* ctx)
+{
+    ((sim_dma *)ctx)->lock_depth--;
+}
+
+static const lcd_m2m_ops sim_ops = { sim_start, sim_wait, sim_notify, sim_lock, sim_unlock };
+
+static void sim_init(sim_dma* d, lcd_m2m* m2m, int fail_start, int fail_xfer)
+{
+    memset(d, 0, sizeof(*d));
+    d->m2m = m2m;
+    d->fail_start = fail_start;
+    d->fail_xfer = fail_xfer;
+    lcd_m2m_init(m2m, &sim_ops, d);
+}
+
+/************ 拆段 ************/
+static uint32_t big[0x10004];
+
+static bool seg_is(const lcd_m2m_seg* seg, const void* dst, uint32_t len, uint8_t width)
+{
+    return seg->dst == dst && seg->len == len && seg->width == width;
+}
+
+static void test_plan(void)
+{
+    static uint32_t a[64], b[64];
+    uint8_t* dst = (uint8_t *)a;
+    uint8_t* src = (uint8_t *)b;
+    lcd_m2m_req req;
+    lcd_m2m_seg seg;
+
+    // dst/src 相对字对齐: 行首零头, 中间按字, 行尾零头
+    req = (lcd_m2m_req){ .dst = dst + 1, .src = src + 1, .row = 100, .rows = 1, .unit = 1 };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 1, 3, 1) && seg.src == src + 1 && !seg.fixed);
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 4, 96, 4) && seg.src == src + 4);
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 100, 1, 1));
+    CHECK(!lcd_m2m_plan(&req, &seg));
+
+    // 相对不对齐: 整行按字节
+    req = (lcd_m2m_req){ .dst = dst + 1, .src = src + 2, .row = 100, .rows = 1, .unit = 1 };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 1, 100, 1));
+    CHECK(!lcd_m2m_plan(&req, &seg));
+    // 相对半字对齐
+    req = (lcd_m2m_req){ .dst = dst + 2, .src = src, .row = 20, .rows = 1, .unit = 1 };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 2, 20, 2));
+
+    // 16 位填充: 不拆开像素; 源地址不递增
+    req = (lcd_m2m_req){ .dst = dst + 2, .src = src, .row = 30, .rows = 2, .dst_stride = 64, .unit = 2, .fill = true };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 2, 2, 2) && seg.fixed && seg.src == src);
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 4, 28, 4));
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 66, 2, 2));
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 68, 28, 4));
+    CHECK(!lcd_m2m_plan(&req, &seg));
+    // 奇数字节的 16 位填充不会出现, 短行直接按单位
+    req = (lcd_m2m_req){ .dst = dst + 2, .src = src, .row = 6, .rows = 1, .unit = 2, .fill = true };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, dst + 2, 6, 2));
+
+    // 单段不超过 LCD_M2M_MAX_ITEMS 项
+    req = (lcd_m2m_req){ .dst = (uint8_t *)big, .src = src, .row = sizeof(big), .rows = 1, .unit = 1, .fill = true };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, big, LCD_M2M_MAX_ITEMS * 4, 4));
+    CHECK(lcd_m2m_plan(&req, &seg) && seg_is(&seg, (uint8_t *)big + LCD_M2M_MAX_ITEMS * 4,
+                                             sizeof(big) - LCD_M2M_MAX_ITEMS * 4, 4));
+    CHECK(!lcd_m2m_plan(&req, &seg));
+    req = (lcd_m2m_req){ .dst = (uint8_t *)big + 1, .src = src + 2, .row = 0x20000, .rows = 1, .unit = 1 };
+    CHECK(lcd_m2m_plan(&req, &seg) && seg.len == LCD_M2M_MAX_ITEMS && seg.width == 1);
+
+    // 空请求
+    req = (lcd_m2m_req){ .dst = dst, .src = src, .row = 0, .rows = 3, .unit = 1 };
+    CHECK(!lcd_m2m_plan(&req, &seg));
+}
+
+/************ 队列与后端 ************/
+static int done_order[16], ndone;
+
+static void on_done(void* arg)
+{
+    done_order[ndone++] = (int)(intptr_t)arg;
+}
+
+static void test_queue(void)
+{
+    static uint8_t dst[8][256], src[256];
+    lcd_m2m m2m;
+    sim_dma d;
+
+    for(int i = 0; i < 256; i++)
+        src[i] = (uint8_t)i;
+
+    // 各行首尾相接时合并为一段
+    sim_init(&d, &m2m, 0, 0);
+    lcd_m2m_copy(&m2m, dst[0], 64, src, 64, 64, 4, NULL, NULL);
+    lcd_m2m_wait(&m2m);
+    CHECK_EQ(d.started, 1);
+    CHECK(seg_is(&d.log[0], dst[0], 256, 4));
+    CHECK(memcmp(dst[0], src, 256) == 0);
+    CHECK(!lcd_m2m_busy(&m2m));
+
+    // 超出队列时提交者等待; 完成回调按提交顺序, 锁不嵌套且成对
+    sim_init(&d, &m2m, 0, 0);
+    ndone = 0;
+    memset(dst, 0, sizeof(dst));
+    for(int i = 0; i < 8; i++)
+        lcd_m2m_fill(&m2m, dst[i], 64, 64, 4, (uint16_t)(0x11 * (i + 1)), 1, on_done, (void *)(intptr_t)i);
+    CHECK(lcd_m2m_busy(&m2m));
+    lcd_m2m_wait(&m2m);
+    CHECK_EQ(ndone, 8);
+    for(int i = 0; i < 8; i++) {
+        bool ok = true;
+
+        CHECK_EQ(done_order[i], i);
+        for(int j = 0; j < 256; j++)
+            ok &= dst[i][j] == 0x11 * (i + 1);
+        CHECK(ok);
+    }
+    CHECK_EQ(m2m.complete, 8);
+    CHECK(!d.nested && d.lock_depth == 0);
+    CHECK(d.notified >= 1);
+
+    // 短于 LCD_M2M_MIN_LEN 的段由 CPU 完成, 不交给后端
+    sim_init(&d, &m2m, 0, 0);
+    lcd_m2m_copy(&m2m, dst[0] + 1, 64, src + 1, 64, LCD_M2M_MIN_LEN, 2, NULL, NULL);
+    lcd_m2m_wait(&m2m);
+    CHECK_EQ(d.started, 0);
+    CHECK(memcmp(dst[0] + 1, src + 1, LCD_M2M_MIN_LEN) == 0);
+    CHECK(memcmp(dst[0] + 65, src + 65, LCD_M2M_MIN_LEN) == 0);
+
+    // 启动失败/传输出错的段由 CPU 重做
+    sim_init(&d, &m2m, 2, 3);
+    memset(dst, 0, sizeof(dst));
+    lcd_m2m_copy(&m2m, dst[0], 256, src, 256, 128, 8, NULL, NULL);
+    lcd_m2m_wait(&m2m);
+    CHECK_EQ(d.started, 8);
+    CHECK(m2m.fallback >= 4);
+    for(int i = 0; i < 8; i++)
+        CHECK(memcmp(dst[i], src, 128) == 0);
+}
+
+/************ 表面接口: 各后端与逐像素参考相同 ************/
+#define SW  101
+#define SH  60
+
+static uint8_t ref[SH * 256], out[SH * 256], source[SH * 256];
+
+static uint16_t get_px(const uint8_t* p, uint32_t stride, uint8_t bpp, int x, int y)
+{
+    const uint8_t* row = p + (uint32_t)y * stride;
+
+    if(bpp == 16) return ((const uint16_t *)row)[x];
+    if(bpp == 8)  return row[x];
+    return (row[x >> 1] >> ((x & 1) * 4)) & 0x0F;
+}
+
+static void set_px(uint8_t* p, uint32_t stride, uint8_t bpp, int x, int y, uint16_t v)
+{
+    uint8_t* row = p + (uint32_t)y * stride;
+
+    if(bpp == 16)     ((uint16_t *)row)[x] = v;
+    else if(bpp == 8) row[x] = (uint8_t)v;
+    else              row[x >> 1] = (row[x >> 1] & (0xF0 >> ((x & 1) * 4))) | (v & 0x0F) << ((x & 1) * 4);
+}
+
+/* 与 view 求交后逐像素写参考; copy 时源坐标相对于 (x, y) */
+static void ref_rect(const lcd_surface* view, bool copy, int x, int y, int w, int h,
+                     uint16_t value, uint32_t src_stride)
+{
+    for(int j = 0; j < h; j++) {
+        for(int i = 0; i < w; i++) {
+            int sx = x + i, sy = y + j;
+
+            if(sx < 0 || sy < 0 || sx >= view->width || sy >= view->height)
+                continue;
+            set_px(ref, view->stride, view->bpp, view->x + sx, view->y + sy,
+                   copy ? get_px(source, src_stride, view->bpp, i, j) : value);
+        }
+    }
+}
+
+static uint32_t run_surface(uint8_t bpp, const lcd_m2m_ops* ops, int fail_start, int fail_xfer, sim_dma* d)
+{
+    lcd_surface root, ref_root, view;
+    lcd_m2m m2m;
+    uint32_t mask = bpp == 16 ? 0xFFFF : (1U << bpp) - 1;
+
+    lcd_surface_init(&root, NULL, out, sizeof(out), SW, SH, bpp);
+    lcd_surface_init(&ref_root, NULL, ref, sizeof(ref), SW, SH, bpp);
+    memset(out, 0, sizeof(out));
+    memset(ref, 0, sizeof(ref));
+    if(ops)
+        sim_init(d, &m2m, fail_start, fail_xfer);
+    else
+        lcd_m2m_init(&m2m, NULL, NULL);
+
+    srand(bpp);
+    for(size_t i = 0; i < sizeof(source); i++)
+        source[i] = (uint8_t)rand();
+    lcd_m2m_clear(&m2m, &root, 0x5 & mask);
+    ref_rect(&ref_root, false, 0, 0, SW, SH, 0x5 & mask, 0);
+
+    for(int n = 0; n < 400; n++) {
+        int vx = rand() % SW - 10, vy = rand() % SH - 10;
+        int x = rand() % 80 - 20, y = rand() % 50 - 10;
+        int w = rand() % 70, h = rand() % 30;
+        uint16_t value = (uint16_t)rand() & mask;
+
+        if(!lcd_surface_view(&view, &root, vx, vy, rand() % SW + 1, rand() % SH + 1))
+            continue;
+        if(rand() & 1) {
+            if(lcd_m2m_fill_rect(&m2m, &view, x, y, w, h, value, NULL, NULL))
+                ref_rect(&view, false, x, y, w, h, value, 0);
+        } else {
+            uint32_t stride = 256;
+
+            if(lcd_m2m_copy_rect(&m2m, &view, x, y, w, h, source, stride, NULL, NULL))
+                ref_rect(&view, true, x, y, w, h, 0, stride);
+        }
+    }
+    lcd_m2m_wait(&m2m);
+    CHECK(memcmp(out, ref, sizeof(out)) == 0);
+    if(ops)
+        CHECK(!d->misaligned && !d->nested && d->lock_depth == 0);
+    return m2m.fallback;
+}
+
+static void test_surface(void)
+{
+    static const uint8_t bpps[] = { 16, 8, 4 };
+    sim_dma d;
+
+    printf("  bpp  backend            started  dma bytes  fallback\n");
+    for(int i = 0; i < 3; i++) {
+        uint32_t fb;
+
+        run_surface(bpps[i], NULL, 0, 0, &d);
+        fb = run_surface(bpps[i], &sim_ops, 0, 0, &d);
+        CHECK_EQ(fb, 0);
+        printf("  %3u  dma                %7d %10u %9u\n", bpps[i], d.started, d.dma_bytes, fb);
+        fb = run_surface(bpps[i], &sim_ops, 3, 5, &d);
+        CHECK(fb > 0);
+        printf("  %3u  dma, faults 3/5    %7d %10u %9u\n", bpps[i], d.started, d.dma_bytes, fb);
+    }
+}
+
+int main(void)
+{
+    test_plan();
+    test_queue();
+    test_surface();
+    return test_result();
+}
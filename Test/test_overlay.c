@@ -0,0 +1,236 @@
+/*
+ * @Describe: 1 位覆盖层: 读改写与位带别名写入相同的位, 改变/ink 范围, 逐行合成,
+ *            以及刷新时合成到面板的画面与 "显存 + 覆盖层" 相同, 只改覆盖层时只重发改变的范围
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+#define W   240
+#define H   135
+
+static uint32_t bits[LCD_OVERLAY_WORDS(W) * H];
+static uint32_t alias_bits[LCD_OVERLAY_WORDS(W) * H];
+static uint32_t alias[LCD_OVERLAY_WORDS(W) * 32 * H];       // 模拟位带别名区, 每位一个字
+static bool mark[H][W];
+
+static bool bit(const lcd_overlay* ov, int x, int y)
+{
+    return (ov->bits[y * ov->words + x / 32] >> (x % 32)) & 1;
+}
+
+static bool rect_eq(const lcd_rect* r, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    return r->x1 == x1 && r->y1 == y1 && r->x2 == x2 && r->y2 == y2;
+}
+
+static void mark_fill(int x1, int y1, int x2, int y2, bool on)
+{
+    for(int y = y1 < 0 ? 0 : y1; y <= y2 && y < H; y++)
+        for(int x = x1 < 0 ? 0 : x1; x <= x2 && x < W; x++)
+            mark[y][x] = on;
+}
+
+static void test_bits(void)
+{
+    lcd_overlay ov, ab;
+    lcd_rect r;
+    bool ok = true;
+
+    CHECK(!lcd_overlay_init(&ov, bits, sizeof(bits) - 1, W, H, WHITE));
+    CHECK(lcd_overlay_init(&ov, bits, sizeof(bits), W, H, WHITE));
+    CHECK_EQ(ov.words, 8);
+    CHECK(!lcd_overlay_take_dirty(&ov, &r));
+    r = (lcd_rect){ 0, 0, W - 1, H - 1 };
+    CHECK(!lcd_overlay_hit(&ov, &r));
+
+    // 裁剪; 改变与 ink 范围
+    lcd_overlay_fill(&ov, 250, 10, -5, 12, true);
+    mark_fill(-5, 10, 250, 12, true);
+    CHECK(lcd_overlay_take_dirty(&ov, &r) && rect_eq(&r, 0, 10, W - 1, 12));
+    CHECK(!lcd_overlay_take_dirty(&ov, &r));
+    lcd_overlay_fill(&ov, 30, 11, 40, 11, false);
+    mark_fill(30, 11, 40, 11, false);
+    lcd_overlay_pixel(&ov, 100, 100, true);
+    lcd_overlay_pixel(&ov, -1, 100, true);
+    mark[100][100] = true;
+    CHECK(lcd_overlay_take_dirty(&ov, &r) && rect_eq(&r, 30, 11, 100, 100));
+    CHECK(rect_eq(&ov.ink, 0, 10, W - 1, 100));
+    r = (lcd_rect){ 0, 101, W - 1, H - 1 };
+    CHECK(!lcd_overlay_hit(&ov, &r));
+    r.y1 = 100;
+    CHECK(lcd_overlay_hit(&ov, &r));
+
+    // 随机的矩形: 读改写与参考相同; 位带写入的下标与读改写的位一一对应
+    lcd_overlay_init(&ab, alias_bits, sizeof(alias_bits), W, H, WHITE);
+    ab.alias = alias;
+    memset(alias, 0, sizeof(alias));
+    lcd_overlay_clear(&ov);
+    memset(mark, 0, sizeof(mark));
+    srand(5);
+    for(int i = 0; i < 300; i++) {
+        int x1 = rand() % (W + 40) - 20, y1 = rand() % (H + 40) - 20;
+        int x2 = x1 + rand() % 50, y2 = y1 + rand() % 20;
+        bool on = rand() % 3;
+
+        lcd_overlay_fill(&ov, x1, y1, x2, y2, on);
+        lcd_overlay_fill(&ab, x1, y1, x2, y2, on);
+        mark_fill(x1, y1, x2, y2, on);
+    }
+    for(int y = 0; y < H; y++) {
+        for(int x = 0; x < W; x++) {
+            ok &= bit(&ov, x, y) == mark[y][x];
+            ok &= alias[y * ov.words * 32 + x] == mark[y][x];
+        }
+    }
+    CHECK(ok);
+    for(uint32_t i = 0; i < LCD_OVERLAY_WORDS(W) * H; i++)
+        ok &= alias_bits[i] == 0;
+    CHECK(ok);
+
+    // 合成: 任意起点与长度, 不越过行尾
+    ok = true;
+    for(int y = 0; y < H; y += 7) {
+        for(int x = 0; x < W; x += 5) {
+            uint16_t count = (uint16_t)(rand() % (W + 20)), line[W + 21];
+
+            for(int i = 0; i <= count; i++)
+                line[i] = 0x1234;
+            lcd_overlay_blend(&ov, x, y, line, count, 0xabcd);
+            for(int i = 0; i <= count; i++) {
+                bool in = i < count && x + i < W;
+
+                ok &= line[i] == (in && mark[y][x + i] ? 0xabcd : 0x1234);
+            }
+        }
+    }
+    CHECK(ok);
+
+    // 清除: 原 ink 计入改变
+    lcd_overlay_take_dirty(&ov, &r);
+    r = ov.ink;
+    lcd_overlay_clear(&ov);
+    CHECK(ov.ink.x1 > ov.ink.x2);
+    {
+        lcd_rect d;
+
+        CHECK(lcd_overlay_take_dirty(&ov, &d) && rect_eq(&d, r.x1, r.y1, r.x2, r.y2));
+    }
+    for(uint32_t i = 0; i < LCD_OVERLAY_WORDS(W) * H; i++)
+        ok &= bits[i] == 0;
+    CHECK(ok);
+}
+
+/************ 与显存中的文字比较, 以及刷新时的合成 ************/
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+/* 面板上每个像素为覆盖层颜色 (置位) 或显存 */
+static bool panel_composed(const lcd_overlay* ov)
+{
+    for(int y = 0; y < H; y++) {
+        for(int x = 0; x < W; x++) {
+            uint16_t want = bit(ov, x, y) ? LCD_PIXEL(ov->color) : g_gram[y * W + x];
+
+            if(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)) != want)
+                return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t flush(lcd_surface* screen)
+{
+    panel_clear_stats(&pnl);
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    return pnl.cmd_bytes + pnl.pixel_bytes;
+}
+
+static void test_compose(void)
+{
+    static const char hud[] = "FPS:60 overlay wraps like lcd_show_string_ram";
+    lcd_surface* screen;
+    lcd_overlay ov;
+    lcd_anim_cube_t cube;
+    uint32_t bytes;
+    bool ok = true;
+
+    panel_init(&pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_set_font(&lcd_dev, FONT_1608, WHITE, BLACK);
+
+    // 字模与 lcd_show_string_ram 相同, 换行规则相同
+    lcd_overlay_init(&ov, bits, sizeof(bits), W, H, YELLOW);
+    lcd_overlay_fill(&ov, 0, 0, W - 1, 40, true);         // 字模为 0 的像素清除旧内容
+    lcd_overlay_string(&ov, 100, 3, &lcd_dev.font, hud);
+    lcd_anim_clear();
+    lcd_show_string_ram(screen, 100, 3, hud);
+    // 第一行 17 个字符 (100 ~ 235), 换行后 28 个 (0 ~ 223); 字符框外仍为填充
+    for(int y = 0; y < H; y++) {
+        for(int x = 0; x < W; x++) {
+            bool glyph = (y >= 3 && y < 19 && x >= 100 && x < 236) || (y >= 19 && y < 35 && x < 28 * 8);
+
+            if(glyph)
+                ok &= bit(&ov, x, y) == (g_gram[y * W + x] == LCD_PIXEL(WHITE));
+            else
+                ok &= bit(&ov, x, y) == (y <= 40);
+        }
+    }
+    CHECK(ok);
+
+    // 刷新: 面板为显存与覆盖层的合成
+    lcd_overlay_clear(&ov);
+    lcd_overlay_string(&ov, 5, 5, &lcd_dev.font, "FPS:60");
+    lcd_overlay_fill(&ov, 0, H - 4, W - 1, H - 1, true);
+    lcd_anim_set_overlay(&ov);
+    lcd_anim_cube_init(&cube, screen, 30, LIGHTBLUE, 60, 67);
+    lcd_anim_clear();
+    lcd_anim_cube_update(&cube);
+    lcd_print_ram(screen, 150, 60, "gram");
+    flush(screen);
+    CHECK(panel_composed(&ov));
+
+    // 只改覆盖层: 只重发改变的范围
+    lcd_overlay_string(&ov, 5, 5, &lcd_dev.font, "FPS:59");
+    bytes = flush(screen);
+    CHECK(panel_composed(&ov));
+    CHECK(bytes > 0 && bytes < 6 * 8 * 16 * 2 + 64);
+    printf("  overlay text change: %5u bytes\n", bytes);
+    CHECK_EQ(flush(screen), 0);
+
+    // 改色, 然后显存与覆盖层同时改变
+    lcd_overlay_color(&ov, RED);
+    flush(screen);
+    CHECK(panel_composed(&ov));
+    for(int f = 0; f < 10; f++) {
+        lcd_anim_clear();
+        cube.cx = 60 + f * 10;
+        lcd_anim_cube_update(&cube);
+        lcd_overlay_fill(&ov, f * 20, 100, f * 20 + 9, 109, f & 1);
+        flush(screen);
+        CHECK(panel_composed(&ov));
+    }
+
+    // 清除: 原来的位置露出显存
+    lcd_overlay_clear(&ov);
+    bytes = flush(screen);
+    CHECK(panel_composed(&ov));
+    printf("  overlay clear:       %5u bytes (full frame %u)\n", bytes, W * H * 2);
+    lcd_anim_set_overlay(NULL);
+}
+
+int main(void)
+{
+    test_bits();
+    test_compose();
+    return test_result();
+}
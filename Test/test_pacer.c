@@ -0,0 +1,212 @@
+/*
+ * @Describe: 帧节拍: 在模拟时钟上运行渲染循环 (vTaskDelayUntil 语义), 轻载/接近预算/过载时的档位与超时,
+ *            负载降低后恢复全质量, 以及 tick 计数回绕时节拍不变
+ */
+#include <stdlib.h>
+#include "test.h"
+#include "lcd_pacer.h"
+
+#define PERIOD  1000                // 模拟时钟的一帧周期
+
+/************ 模拟时钟与帧耗时 ************/
+static uint32_t now;
+
+/* 与 vTaskDelayUntil 相同: 唤醒时刻推进 increment, 已经过去时不阻塞 */
+static void delay_until(uint32_t* wake, uint32_t increment)
+{
+    *wake += increment;
+    if((int32_t)(*wake - now) > 0)
+        now = *wake;
+}
+
+/* 帧耗时: 基本工作加上各质量项, 被省略的项不计; jitter 为随机增加的上限 */
+typedef struct {
+    uint32_t core, hud, half, flush, jitter;
+} cost_model;
+
+static uint32_t frame_cost(const lcd_pacer* p, const cost_model* c)
+{
+    uint32_t work = c->core;
+
+    if(!lcd_pacer_drop(p, LCD_PACE_HUD))       work += c->hud;
+    if(!lcd_pacer_drop(p, LCD_PACE_HALF_RATE)) work += c->half;
+    if(!lcd_pacer_drop(p, LCD_PACE_FLUSH))     work += c->flush;
+    if(c->jitter)
+        work += rand() % c->jitter;
+    return work;
+}
+
+typedef struct {
+    uint32_t overruns, skipped, steps, changes;
+    uint8_t min_level, max_level;
+    bool even;                      // 没有超时的帧都在周期的整数倍开始
+} run_stats;
+
+/* 运行 frames 帧, 统计从 from 帧开始 */
+static void run(lcd_pacer* p, const cost_model* c, int frames, int from, run_stats* st)
+{
+    uint32_t t0 = p->wake, overruns = p->overruns, skipped = p->skipped;
+    uint8_t level = p->level;
+
+    *st = (run_stats){ .min_level = 0xff, .even = true };
+    for(int f = 0; f < frames; f++) {
+        uint32_t steps = lcd_pacer_begin(p, now);
+
+        if(f == from) {
+            overruns = p->overruns;
+            skipped = p->skipped;
+        }
+        if(f >= from) {
+            st->steps += steps;
+            st->even &= (now - t0) % PERIOD == 0;
+            if(p->level < st->min_level) st->min_level = p->level;
+            if(p->level > st->max_level) st->max_level = p->level;
+            st->changes += p->level != level;
+        }
+        level = p->level;
+        now += frame_cost(p, c);
+        delay_until(&p->wake, lcd_pacer_end(p, now));
+    }
+    st->overruns = p->overruns - overruns;
+    st->skipped = p->skipped - skipped;
+}
+
+static void report(const char* name, const lcd_pacer* p, const run_stats* st)
+{
+    printf("  %-12s level %u..%u  changes %3u  overruns %3u  skipped %3u  load %3u/256  peak %5u\n",
+           name, st->min_level, st->max_level, st->changes, st->overruns, st->skipped, p->load, p->peak);
+}
+
+static void test_drop(void)
+{
+    lcd_pacer p;
+
+    lcd_pacer_init(&p, 0, 9, 0);
+    CHECK_EQ(p.period, 1);
+    CHECK_EQ(p.max_level, LCD_PACE_LEVELS);
+    CHECK_EQ(lcd_pacer_begin(&p, 0), 1);
+
+    // 档位 > 项的值时生效; 隔帧项只在奇数帧省略
+    p.level = 1;
+    CHECK(lcd_pacer_drop(&p, LCD_PACE_HUD));
+    CHECK(!lcd_pacer_drop(&p, LCD_PACE_HALF_RATE));
+    p.level = 3;
+    p.frames = 4;
+    CHECK(!lcd_pacer_drop(&p, LCD_PACE_HALF_RATE) && !lcd_pacer_drop(&p, LCD_PACE_FLUSH));
+    p.frames = 5;
+    CHECK(lcd_pacer_drop(&p, LCD_PACE_HALF_RATE) && lcd_pacer_drop(&p, LCD_PACE_FLUSH));
+
+    // 超时: 跳到下一个未过去的周期, 返回的增量使唤醒时刻仍在周期上
+    lcd_pacer_init(&p, PERIOD, LCD_PACE_LEVELS, 5000);
+    lcd_pacer_begin(&p, 5000);
+    CHECK_EQ(lcd_pacer_end(&p, 5000 + 2 * PERIOD + 10), 3 * PERIOD);
+    CHECK(p.overruns == 1 && p.skipped == 2 && p.peak == 2 * PERIOD + 10);
+    CHECK_EQ(p.level, 1);
+    p.wake += 3 * PERIOD;
+    CHECK_EQ(lcd_pacer_begin(&p, 5000 + 3 * PERIOD), 3);
+    CHECK_EQ(lcd_pacer_end(&p, 5000 + 3 * PERIOD + 100), PERIOD);
+    CHECK_EQ(lcd_pacer_begin(&p, 0), 1);
+
+    // 改变周期后等待平均值跟上
+    lcd_pacer_set_period(&p, 0);
+    CHECK(p.period == 1 && p.hold == LCD_PACER_SETTLE);
+}
+
+static void test_loads(void)
+{
+    static const cost_model light    = { 300, 50, 50, 0, 50 };
+    static const cost_model moderate = { 700, 200, 50, 0, 40 };       // 全质量约 97%, 关闭 HUD 后约 77%
+    static const cost_model overload = { 400, 150, 100, 450, 40 };    // 全质量约 110%, 最低档重帧约 97%, 平均约 70%
+    lcd_pacer p;
+    run_stats st;
+
+    srand(7);
+    now = 12345;
+    lcd_pacer_init(&p, PERIOD, LCD_PACE_LEVELS, now);
+
+    // 轻载: 全质量, 无超时, 每帧间隔一个周期, 动画按一个周期推进
+    run(&p, &light, 300, 0, &st);
+    report("light", &p, &st);
+    CHECK(st.max_level == 0 && st.overruns == 0 && st.even);
+    CHECK_EQ(st.steps, 300);
+
+    // 接近预算: 只降到关闭 HUD, 稳定后不来回切换, 不超时
+    run(&p, &moderate, 600, 100, &st);
+    report("moderate", &p, &st);
+    CHECK(st.min_level == 1 && st.max_level == 1);
+    CHECK_EQ(st.changes, 0);
+    CHECK_EQ(st.overruns, 0);
+
+    // 过载 (从全质量开始): 逐级降到最低档; 稳定后不再超时, 动画推进的周期数与经过的时间一致
+    lcd_pacer_init(&p, PERIOD, LCD_PACE_LEVELS, now);
+    {
+        uint32_t t0 = now, steps = 0;
+
+        run(&p, &overload, 100, 0, &st);
+        report("overload", &p, &st);
+        CHECK_EQ(p.level, LCD_PACE_LEVELS);
+        CHECK(st.overruns > 0 && st.overruns < 20);
+        steps = st.steps;
+        run(&p, &overload, 400, 0, &st);
+        report("  settled", &p, &st);
+        CHECK_EQ(st.min_level, LCD_PACE_LEVELS);
+        CHECK_EQ(st.overruns, 0);
+        steps += st.steps;
+        // begin 返回的是上一帧结束时算出的周期数, 最后一帧的推进还未被取走
+        CHECK(steps <= (now - t0) / PERIOD + 1 && steps + p.steps >= (now - t0) / PERIOD);
+    }
+
+    // 恢复: 每升一档需要 LCD_PACER_CALM 帧低负载
+    {
+        int frames = 0;
+
+        while(p.level && frames < 1000) {
+            run(&p, &light, 1, 0, &st);
+            frames++;
+        }
+        printf("  recovered to level 0 after %d light frames\n", frames);
+        CHECK_EQ(p.level, 0);
+        CHECK(frames >= LCD_PACE_LEVELS * LCD_PACER_CALM);
+        CHECK(frames <= LCD_PACE_LEVELS * (LCD_PACER_CALM + LCD_PACER_SETTLE) + LCD_PACER_SETTLE + 8);
+        run(&p, &light, 200, 0, &st);
+        CHECK(st.max_level == 0 && st.overruns == 0 && st.even);
+    }
+
+    // 限制最高档位
+    lcd_pacer_init(&p, PERIOD, 1, now);
+    run(&p, &overload, 200, 0, &st);
+    CHECK_EQ(st.max_level, 1);
+}
+
+/* tick 计数回绕: 节拍与统计不受影响 */
+static void test_wrap(void)
+{
+    static const cost_model light = { 300, 50, 50, 0, 50 };
+    static const cost_model spike = { 2500, 0, 0, 0, 0 };
+    lcd_pacer p;
+    run_stats st;
+
+    now = UINT32_MAX - 50 * PERIOD + 1;
+    lcd_pacer_init(&p, PERIOD, LCD_PACE_LEVELS, now);
+    run(&p, &light, 100, 0, &st);
+    CHECK(st.max_level == 0 && st.overruns == 0 && st.even);
+    CHECK_EQ(st.steps, 100);
+    CHECK(p.peak < PERIOD);
+
+    // 回绕处的超时
+    now = UINT32_MAX - PERIOD / 2;
+    lcd_pacer_init(&p, PERIOD, LCD_PACE_LEVELS, now);
+    run(&p, &spike, 1, 0, &st);
+    CHECK(p.overruns == 1 && p.skipped == 2 && p.steps == 3);
+    CHECK_EQ(p.peak, 2500);
+    CHECK_EQ(p.wake - (UINT32_MAX - PERIOD / 2), 3 * PERIOD);
+    CHECK(now < 3 * PERIOD);
+}
+
+int main(void)
+{
+    test_drop();
+    test_loads();
+    test_wrap();
+    return test_result();
+}
@@ -0,0 +1,187 @@
+/*
+ * @Describe: 调色板: 颜色分配与最接近颜色, expand8/expand4 与逐像素查表相同 (任意起点与长度),
+ *            以及展开一行的吞吐量 (与 16 位显存直接复制比较)
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test.h"
+#include "lcd_palette.h"
+
+static lcd_palette pal;
+
+static uint32_t dist(uint16_t a, uint16_t b)
+{
+    int dr = (a >> 11) - (b >> 11);
+    int dg = ((a >> 5) & 0x3F) / 2 - ((b >> 5) & 0x3F) / 2;
+    int db = (a & 0x1F) - (b & 0x1F);
+
+    return dr * dr + dg * dg + db * db;
+}
+
+static void test_index(void)
+{
+    lcd_palette_init(&pal, 8, false);
+    CHECK_EQ(lcd_palette_index(&pal, 0x0000), 0);
+    CHECK_EQ(lcd_palette_index(&pal, 0xf800), 1);
+    CHECK_EQ(lcd_palette_index(&pal, 0x07e0), 2);
+    CHECK_EQ(lcd_palette_index(&pal, 0xf800), 1);
+    CHECK_EQ(lcd_palette_index(&pal, 0x0000), 0);
+    CHECK_EQ(pal.count, 3);
+    CHECK_EQ(pal.lut[1], 0xf800);
+
+    // 交换字节序 (8 位 SPI 帧)
+    lcd_palette_init(&pal, 8, true);
+    CHECK_EQ(lcd_palette_index(&pal, 0xf81f), 1);
+    CHECK_EQ(pal.lut[1], 0x1ff8);
+    CHECK_EQ(pal.rgb[1], 0xf81f);
+
+    // 4bpp 满 16 色后取最接近的颜色, 与逐个比较的结果相同
+    lcd_palette_init(&pal, 4, false);
+    srand(2);
+    for(int i = 1; i < 16; i++)
+        CHECK_EQ(lcd_palette_index(&pal, (uint16_t)(i * 0x1111)), i);
+    CHECK_EQ(pal.count, 16);
+    for(int i = 0; i < 1000; i++) {
+        uint16_t rgb = (uint16_t)rand();
+        uint8_t index = lcd_palette_index(&pal, rgb);
+        uint32_t best = UINT32_MAX;
+
+        for(int j = 0; j < 16; j++)
+            if(dist(rgb, pal.rgb[j]) < best)
+                best = dist(rgb, pal.rgb[j]);
+        CHECK(index < 16);
+        CHECK_EQ(dist(rgb, pal.rgb[index]), best);
+    }
+    CHECK_EQ(pal.count, 16);
+    // 两个像素的表与单像素表一致
+    for(int b = 0; b < 256; b++)
+        CHECK_EQ(pal.pair[b], pal.lut[b & 0x0F] | (uint32_t)pal.lut[b >> 4] << 16);
+}
+
+#define LEN     200
+#define GUARD   0x5a5a
+
+static void test_expand(void)
+{
+    static uint8_t src8[LEN + 40], src4[(LEN + 40) / 2];
+    static lcd_palette pal8, pal4;
+    uint16_t dst[LEN + 1];
+
+    lcd_palette_init(&pal8, 8, false);
+    lcd_palette_init(&pal4, 4, true);
+    for(int i = 1; i < 256; i++)
+        lcd_palette_index(&pal8, (uint16_t)(i * 257));
+    for(int i = 1; i < 16; i++)
+        lcd_palette_index(&pal4, (uint16_t)(i * 0x1234));
+    for(int i = 0; i < (int)sizeof(src8); i++)
+        src8[i] = (uint8_t)rand();
+    for(int i = 0; i < (int)sizeof(src4); i++)
+        src4[i] = (uint8_t)rand();
+
+    for(uint16_t x = 0; x < 40; x++) {
+        for(uint32_t count = 0; count < LEN; count++) {
+            bool ok8 = true, ok4 = true;
+
+            dst[count] = GUARD;
+            lcd_palette_expand8(&pal8, src8, x, dst, count);
+            for(uint32_t i = 0; i < count; i++)
+                ok8 &= dst[i] == pal8.lut[src8[x + i]];
+            ok8 &= dst[count] == GUARD;
+
+            dst[count] = GUARD;
+            lcd_palette_expand4(&pal4, src4, x, dst, count);
+            for(uint32_t i = 0; i < count; i++) {
+                uint32_t p = x + i;
+
+                ok4 &= dst[i] == pal4.lut[(src4[p >> 1] >> ((p & 1) * 4)) & 0x0F];
+            }
+            ok4 &= dst[count] == GUARD;
+
+            CHECK(ok8);
+            CHECK(ok4);
+        }
+    }
+}
+
+/************ 吞吐量 ************/
+#define WIDTH   240
+#define LINES   135
+#define ROUNDS  2000
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint16_t fb16[WIDTH * LINES];
+static uint8_t fb8[WIDTH * LINES], fb4[WIDTH * LINES / 2];
+static volatile uint16_t sink;
+
+static void expand_copy(uint16_t y, uint16_t* line)
+{
+    memcpy(line, &fb16[y * WIDTH], WIDTH * 2);
+}
+
+static void expand_8(uint16_t y, uint16_t* line)
+{
+    lcd_palette_expand8(&pal, &fb8[y * WIDTH], 0, line, WIDTH);
+}
+
+static void expand_4(uint16_t y, uint16_t* line)
+{
+    lcd_palette_expand4(&pal, &fb4[y * WIDTH / 2], 0, line, WIDTH);
+}
+
+/* 不用 pair 表, 每个像素取半字节后查表 */
+static void expand_4_naive(uint16_t y, uint16_t* line)
+{
+    const uint8_t* src = &fb4[y * WIDTH / 2];
+
+    for(uint16_t x = 0; x < WIDTH; x++)
+        line[x] = pal.lut[(src[x >> 1] >> ((x & 1) * 4)) & 0x0F];
+}
+
+static void bench(const char* name, void (*fn)(uint16_t, uint16_t*), uint32_t gram)
+{
+    static uint16_t line[WIDTH];
+    double t = now();
+
+    for(int r = 0; r < ROUNDS; r++) {
+        for(uint16_t y = 0; y < LINES; y++)
+            fn(y, line);
+        sink = line[r % WIDTH];
+    }
+    t = now() - t;
+    printf("  %-22s %6u B %9.1f Mpx/s\n", name, gram, (double)ROUNDS * WIDTH * LINES / t / 1e6);
+}
+
+static void test_throughput(void)
+{
+    lcd_palette_init(&pal, 4, false);
+    for(int i = 1; i < 16; i++)
+        lcd_palette_index(&pal, (uint16_t)(i * 0x1111));
+    for(int i = 0; i < WIDTH * LINES; i++) {
+        fb16[i] = (uint16_t)rand();
+        fb8[i]  = (uint8_t)rand();
+    }
+    for(int i = 0; i < WIDTH * LINES / 2; i++)
+        fb4[i] = (uint8_t)rand();
+
+    printf("  240 x 135 frame        gram  expand to line buffer\n");
+    bench("16bpp memcpy", expand_copy, sizeof(fb16));
+    bench("8bpp expand8", expand_8, sizeof(fb8));
+    bench("4bpp expand4", expand_4, sizeof(fb4));
+    bench("4bpp per-pixel", expand_4_naive, sizeof(fb4));
+}
+
+int main(void)
+{
+    test_index();
+    test_expand();
+    test_throughput();
+    return test_result();
+}
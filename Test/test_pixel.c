@@ -0,0 +1,99 @@
+/*
+ * @Describe: 像素帧格式: 同一组绘制分别按 LCD_SPI_16BIT = 0/1 编译,
+ *            面板收到的内容应正确, 且两种方式的 SPI 字节流相同 (由 compare.cmake 比较)
+ */
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+/* 区域内每个像素都是 a 或 b, 返回 a 的个数 */
+static int count_two(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t a, uint16_t b)
+{
+    int n = 0;
+
+    for(uint16_t y = y1; y <= y2; y++) {
+        for(uint16_t x = x1; x <= x2; x++) {
+            uint16_t c = panel_lcd_pixel(&lcd_dev, x, y);
+
+            CHECK(c == a || c == b);
+            n += c == a;
+        }
+    }
+    return n;
+}
+
+static void draw_core(void)
+{
+    static uint8_t pic[16 * 8 * 2];
+
+    lcd_fill(&lcd_dev, 10, 10, 59, 39, RED);
+    CHECK_EQ(count_two(10, 10, 59, 39, RED, RED), 50 * 30);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, 60, 40), BLACK);
+
+    lcd_draw_point(&lcd_dev, 100, 100, GREEN);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, 100, 100), GREEN);
+
+    lcd_draw_line(&lcd_dev, 0, 120, 99, 120, MAGENTA);
+    CHECK_EQ(count_two(0, 120, 99, 120, MAGENTA, MAGENTA), 100);
+
+    lcd_set_font(&lcd_dev, FONT_1608, YELLOW, BLUE);
+    lcd_show_string(&lcd_dev, 0, 60, (const uint8_t *)"Hello 16-bit");
+    CHECK(count_two(0, 60, 12 * 8 - 1, 75, YELLOW, BLUE) > 0);
+
+    // 图片为屏幕字节序: 高字节在前
+    for(int i = 0; i < 16 * 8; i++) {
+        pic[i * 2]     = (uint8_t)((i * 0x1234) >> 8);
+        pic[i * 2 + 1] = (uint8_t)(i * 0x1234);
+    }
+    lcd_show_picture(&lcd_dev, 200, 100, 16, 8, pic);
+    for(int i = 0; i < 16 * 8; i++)
+        CHECK_EQ(panel_lcd_pixel(&lcd_dev, 200 + i % 16, 100 + i / 16), (uint16_t)(i * 0x1234));
+}
+
+static void draw_anim(void)
+{
+    lcd_surface* screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_anim_cube_t cube;
+
+    CHECK(screen != NULL);
+    lcd_anim_cube_init(&cube, screen, 30, LIGHTBLUE, 120, 67);
+    lcd_anim_cube_update(&cube);
+    lcd_set_font(&lcd_dev, FONT_1206, WHITE, BLACK);
+    lcd_print_ram(screen, 5, 5, "FPS:%d", 60);
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+
+    // 第一次刷新发送全屏: 面板与显存一致, 显存为 LCD_PIXEL 格式
+    for(uint16_t y = 0; y < 135; y++)
+        for(uint16_t x = 0; x < 240; x++)
+            CHECK_EQ(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)), g_gram[y * 240 + x]);
+    CHECK(count_two(0, 20, 239, 134, LIGHTBLUE, BLACK) > 0);
+    CHECK(count_two(5, 5, 5 + 6 * 6 - 1, 5 + 11, WHITE, BLACK) > 0);
+}
+
+int main(int argc, char** argv)
+{
+    panel_init(&pnl);
+    pnl.dma = true;
+    if(argc > 1)
+        pnl.log = fopen(argv[1], "wb");
+
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    CHECK_EQ(count_two(0, 0, 239, 134, BLACK, BLACK), 240 * 135);
+
+    draw_core();
+    draw_anim();
+
+    if(pnl.log)
+        fclose(pnl.log);
+    printf("LCD_SPI_16BIT=%d: %u transfers, %u command bytes, %u pixel bytes\n",
+           LCD_SPI_16BIT, pnl.xfers, pnl.cmd_bytes, pnl.pixel_bytes);
+    return test_result();
+}
@@ -0,0 +1,198 @@
+/*
+ * @Describe: 读-改-写: lcd_rmw_region 的分块与读写顺序, 以及 lcd_fill_blend 在面板模型上的结果
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+
+static void test_pixel(void)
+{
+    static const uint8_t rgb[] = { 0xff, 0xff, 0xff,  0xf8, 0x00, 0x00,  0x00, 0xfc, 0x00,
+                                   0x00, 0x00, 0xf8,  0x87, 0x43, 0x2f };
+    uint16_t out[5];
+
+    CHECK_EQ(lcd_rmw_capacity(0), 0);
+    CHECK_EQ(lcd_rmw_capacity(LCD_RAMRD_DUMMY), 0);
+    CHECK_EQ(lcd_rmw_capacity(LCD_RAMRD_DUMMY + 2), 0);
+    CHECK_EQ(lcd_rmw_capacity(LCD_RAMRD_DUMMY + 3), 1);
+    CHECK_EQ(lcd_rmw_capacity(480), 159);
+
+    // 低位被舍弃
+    lcd_rmw_unpack(rgb, out, 5);
+    CHECK_EQ(out[0], WHITE);
+    CHECK_EQ(out[1], RED);
+    CHECK_EQ(out[2], GREEN);
+    CHECK_EQ(out[3], BLUE);
+    CHECK_EQ(out[4], (0x80 << 8) | (0x40 << 3) | (0x2f >> 3));
+
+    CHECK_EQ(lcd_rmw_blend(RED, BLUE, 255), RED);
+    CHECK_EQ(lcd_rmw_blend(RED, BLUE, 0), BLUE);
+    CHECK_EQ(lcd_rmw_blend(WHITE, BLACK, 128), (15 << 11) | (31 << 5) | 15);
+    CHECK_EQ(lcd_rmw_blend(GREEN, GREEN, 77), GREEN);
+}
+
+/************ 模拟的读写操作 ************/
+typedef struct {
+    char log[64];               // 每块一个记录: R / W
+    int ops;
+    uint16_t x1, y1, x2, y2;
+    uint32_t pixels;            // fn 修改过的像素数
+} trace;
+
+static void trace_address(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, bool read)
+{
+    trace* t = ctx;
+
+    t->log[t->ops++] = read ? 'R' : 'W';
+    t->x1 = x1;
+    t->y1 = y1;
+    t->x2 = x2;
+    t->y2 = y2;
+}
+
+/* 读回的像素为其坐标 */
+static void trace_read(void* ctx, uint8_t* data, uint32_t len)
+{
+    trace* t = ctx;
+    uint32_t count = (len - LCD_RAMRD_DUMMY) / LCD_RAMRD_BPP;
+
+    CHECK_EQ(len, LCD_RAMRD_DUMMY + count * LCD_RAMRD_BPP);
+    CHECK_EQ(count, (uint32_t)(t->x2 - t->x1 + 1) * (t->y2 - t->y1 + 1));
+    data[0] = 0xaa;
+    for(uint32_t i = 0; i < count; i++) {
+        uint16_t x = t->x1 + i % (t->x2 - t->x1 + 1), y = t->y1 + i / (t->x2 - t->x1 + 1);
+        uint8_t* p = data + LCD_RAMRD_DUMMY + i * LCD_RAMRD_BPP;
+
+        p[0] = (x & 0x1f) << 3;
+        p[1] = (y & 0x3f) << 2;
+        p[2] = 0;
+    }
+}
+
+static void trace_write(void* ctx, uint16_t* pixels, uint32_t count)
+{
+    trace* t = ctx;
+
+    CHECK_EQ(count, (uint32_t)(t->x2 - t->x1 + 1) * (t->y2 - t->y1 + 1));
+    for(uint32_t i = 0; i < count; i++) {
+        uint16_t x = t->x1 + i % (t->x2 - t->x1 + 1), y = t->y1 + i / (t->x2 - t->x1 + 1);
+
+        CHECK_EQ(pixels[i], ((x & 0x1f) << 11 | (y & 0x3f) << 5) + 1);
+    }
+}
+
+static void trace_fn(void* arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t* pixels)
+{
+    trace* t = arg;
+
+    CHECK_EQ(x, t->x1);
+    CHECK_EQ(y, t->y1);
+    for(uint32_t i = 0; i < (uint32_t)w * h; i++)
+        pixels[i]++;
+    t->pixels += (uint32_t)w * h;
+}
+
+static const lcd_rmw_ops trace_ops = { trace_address, trace_read, trace_write };
+
+static void check_region(uint16_t w, uint16_t h, uint32_t size, const char* log)
+{
+    static uint8_t scratch[1024] __attribute__((aligned(2)));
+    trace t = { 0 };
+
+    CHECK(lcd_rmw_region(&trace_ops, &t, 5, 7, w, h, scratch, size, trace_fn, &t));
+    CHECK(strcmp(t.log, log) == 0);
+    CHECK_EQ(t.pixels, (uint32_t)w * h);
+}
+
+/* 每块先读后写; 暂存区放得下多行时按整行分块, 放不下一行时行内分块 */
+static void test_region(void)
+{
+    static uint8_t scratch[16];
+    trace t = { 0 };
+
+    check_region(100, 7, LCD_RAMRD_DUMMY + 250 * LCD_RAMRD_BPP, "RWRWRWRW");
+    check_region(100, 2, LCD_RAMRD_DUMMY + 250 * LCD_RAMRD_BPP, "RW");
+    check_region(10, 3, LCD_RAMRD_DUMMY + 4 * LCD_RAMRD_BPP, "RWRWRWRWRWRWRWRWRW");
+    check_region(1, 1, LCD_RAMRD_DUMMY + LCD_RAMRD_BPP, "RW");
+
+    CHECK(!lcd_rmw_region(&trace_ops, &t, 0, 0, 10, 10, scratch, LCD_RAMRD_DUMMY + 2, trace_fn, &t));
+    CHECK(!lcd_rmw_region(&trace_ops, &t, 0, 0, 0, 10, scratch, sizeof(scratch), trace_fn, &t));
+    CHECK_EQ(t.ops, 0);
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line };
+
+static bool rect_is(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+    for(uint16_t y = y1; y <= y2; y++)
+        for(uint16_t x = x1; x <= x2; x++)
+            if(panel_lcd_pixel(&lcd_dev, x, y) != color)
+                return false;
+    return true;
+}
+
+static void test_blend(void)
+{
+    uint16_t half = lcd_rmw_blend(BLUE, RED, 128);
+
+    panel_init(&pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_clear(&lcd_dev, RED);
+
+    // 行缓冲 480 字节一次读回 159 个像素: 200 宽的区域行内分两块
+    panel_clear_stats(&pnl);
+    CHECK(lcd_fill_blend(&lcd_dev, 20, 10, 219, 29, BLUE, 128));
+    CHECK(rect_is(20, 10, 219, 29, half));
+    CHECK(rect_is(0, 9, 239, 9, RED));
+    CHECK(rect_is(0, 30, 239, 30, RED));
+    CHECK(rect_is(19, 10, 19, 29, RED));
+    CHECK(rect_is(220, 10, 220, 29, RED));
+    CHECK_EQ(pnl.read_bytes, 20 * (2 * LCD_RAMRD_DUMMY + 200 * LCD_RAMRD_BPP));
+    CHECK_EQ(pnl.pixel_bytes, 200 * 20 * 2);
+
+    CHECK(lcd_fill_blend(&lcd_dev, 20, 10, 219, 29, BLUE, 255));
+    CHECK(rect_is(20, 10, 219, 29, BLUE));
+
+    // 没有行缓冲时不能读回
+    lcd_dev.line_buffer = NULL;
+    CHECK(!lcd_fill_blend(&lcd_dev, 0, 0, 9, 9, BLUE, 128));
+    CHECK(rect_is(0, 0, 9, 9, RED));
+    lcd_dev.line_buffer = line;
+}
+
+/* 写指针恰好停在读取窗口的起点 (窗口缓存会选择 0x3C 续写) 时仍按新窗口读 */
+static void test_after_continue(void)
+{
+    static uint16_t pixels[100 * 10];
+
+    lcd_clear(&lcd_dev, RED);
+    for(int i = 0; i < 100 * 10; i++)
+        pixels[i] = LCD_PIXEL(GREEN);
+
+    // 窗口 (10,20)-(109,30) 写完前 10 行, 写指针停在第 30 行行首
+    lcd_io_begin(&io);
+    lcd_set_address(&lcd_dev, 10, 20, 109, 30);
+    lcd_write_pixels(&io, pixels, 100 * 10);
+    lcd_io_end(&io);
+    lcd_window_advance(&lcd_dev.window, 100 * 10);
+    CHECK(rect_is(10, 20, 109, 29, GREEN));
+
+    panel_clear_stats(&pnl);
+    CHECK(lcd_fill_blend(&lcd_dev, 10, 30, 109, 30, BLUE, 128));
+    CHECK_EQ(pnl.windows, 2);
+    CHECK(rect_is(10, 20, 109, 29, GREEN));
+    CHECK(rect_is(10, 30, 109, 30, lcd_rmw_blend(BLUE, RED, 128)));
+    CHECK(rect_is(10, 31, 109, 31, RED));
+}
+
+int main(void)
+{
+    test_pixel();
+    test_region();
+    test_blend();
+    test_after_continue();
+    return test_result();
+}
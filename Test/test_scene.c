@@ -0,0 +1,125 @@
+/*
+ * @Describe: 条带渲染: lcd_scene 分条光栅化与整块光栅化相同;
+ *            同一组动画分别按 LCD_ANIM_BANDED = 0/1 编译, 面板上的画面应相同 (由 compare.cmake 比较)
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+#define W   60
+#define H   40
+
+static lcd_prim prims[8];
+static uint16_t whole[W * H], band[W * H];
+
+static const uint8_t glyph[5 * 2] = {       // 10 x 5, 每行 2 字节
+    0xff, 0x03, 0x01, 0x02, 0x55, 0x01, 0x01, 0x02, 0xff, 0x03,
+};
+
+static void test_raster(void)
+{
+    lcd_scene scene;
+
+    lcd_scene_init(&scene, prims, 8, W, H);
+    scene.clear = 0x1111;
+    CHECK(lcd_scene_line(&scene, -5, -3, 70, 45, 0xaaaa));
+    CHECK(lcd_scene_line(&scene, 59, 0, 0, 39, 0xbbbb));
+    CHECK(lcd_scene_line(&scene, 3, 20, 3, 20, 0xcccc));
+    CHECK(lcd_scene_char(&scene, 55, 37, glyph, 10, 5, 0xdddd, 0xeeee));    // 超出右下角
+    lcd_scene_clip(&scene, 10, 10, 29, 19);
+    CHECK(lcd_scene_line(&scene, 0, 15, 59, 15, 0x2222));
+    CHECK(lcd_scene_char(&scene, 5, 8, glyph, 10, 5, 0x3333, 0x4444));
+    lcd_scene_clip(&scene, 0, 0, W - 1, H - 1);
+    CHECK(lcd_scene_char(&scene, W, 0, glyph, 10, 5, 0x5555, 0x5555));      // 整个在屏幕外, 不占位置
+    CHECK(lcd_scene_char(&scene, 20, 30, glyph, 10, 5, 0x6666, 0x7777));
+    CHECK(lcd_scene_line(&scene, 0, 0, 1, 1, 0x8888));
+    CHECK_EQ(scene.count, 8);
+    CHECK(!lcd_scene_line(&scene, 0, 0, 1, 1, 0x9999));
+
+    lcd_scene_raster(&scene, 0, H, whole);
+    CHECK_EQ(whole[0], 0x8888);
+    CHECK_EQ(whole[15 * W + 9], 0x1111);        // 裁剪范围外
+    CHECK_EQ(whole[15 * W + 10], 0x2222);
+    CHECK_EQ(whole[15 * W + 30], 0x1111);
+    CHECK_EQ(whole[10 * W + 10], 0x4444);       // 字模第 2 行, 前 5 列被裁掉
+    CHECK_EQ(whole[10 * W + 11], 0x3333);
+    CHECK_EQ(whole[13 * W + 11], 0x1111);
+    CHECK_EQ(whole[30 * W + 20], 0x6666);
+    CHECK_EQ(whole[32 * W + 21], 0x7777);
+    CHECK_EQ(whole[39 * W + 59], 0xdddd);
+
+    // 任意条高分条光栅化, 拼起来与整块相同 (最后一条可以超出场景)
+    for(uint16_t rows = 1; rows <= H; rows++) {
+        memset(band, 0, sizeof(band));
+        for(uint16_t y = 0; y < H; y += rows) {
+            static uint16_t buf[W * H];
+            uint16_t n = H - y < rows ? H - y : rows;
+
+            lcd_scene_raster(&scene, y, rows, buf);
+            memcpy(&band[y * W], buf, n * W * sizeof(uint16_t));
+        }
+        CHECK(memcmp(band, whole, sizeof(whole)) == 0);
+    }
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+static void frame(lcd_surface* screen, lcd_anim_cube_t* cube, int f)
+{
+    lcd_anim_clear();
+    cube->cx = 60 + f * 7;
+    lcd_anim_cube_update(cube);
+    lcd_print_ram(screen, 5, 5, "frame %d", f);
+    lcd_print_ram(screen, 200, 120, "%d", f * 111);
+    panel_clear_stats(&pnl);
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+}
+
+static void write_panel(FILE* out)
+{
+    for(uint16_t y = 0; y < 135; y++) {
+        for(uint16_t x = 0; x < 240; x++) {
+            uint16_t c = panel_lcd_pixel(&lcd_dev, x, y);
+
+            fwrite(&c, sizeof(c), 1, out);
+        }
+    }
+}
+
+static void test_anim(FILE* out)
+{
+    lcd_surface* screen;
+    lcd_anim_cube_t cube;
+
+    panel_init(&pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    CHECK(screen != NULL);
+    lcd_set_font(&lcd_dev, FONT_1206, WHITE, BLACK);
+    lcd_anim_cube_init(&cube, screen, 30, LIGHTBLUE, 60, 67);
+
+    for(int f = 0; f < 20; f++) {
+        frame(screen, &cube, f);
+        if(out && f % 5 == 4)
+            write_panel(out);
+    }
+    printf("LCD_ANIM_BANDED=%d: last frame %u transfers, %u bytes\n", LCD_ANIM_BANDED,
+           pnl.xfers, pnl.cmd_bytes + pnl.pixel_bytes);
+}
+
+int main(int argc, char** argv)
+{
+    FILE* out = argc > 1 ? fopen(argv[1], "wb") : NULL;
+
+    test_raster();
+    test_anim(out);
+    if(out)
+        fclose(out);
+    return test_result();
+}
@@ -0,0 +1,163 @@
+/*
+ * @Describe: 硬件滚动控制台: lcd_scroll 的行映射, 以及换行时只发送 0x37 与新行的像素
+ */
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_console.h"
+
+static void test_map(void)
+{
+    lcd_scroll sc;
+
+    // 1.14" 竖屏: 240 行从帧存储器第 40 行开始, 16 点行高正好 15 行
+    CHECK(lcd_scroll_init(&sc, 40, 240, 16));
+    CHECK_EQ(sc.lines, 15);
+    CHECK_EQ(sc.tfa, 40);
+    CHECK_EQ(sc.vsa, 240);
+    CHECK_EQ(sc.bfa, 40);
+    // 余数并入底部固定区
+    CHECK(lcd_scroll_init(&sc, 0, 240, 24));
+    CHECK(lcd_scroll_init(&sc, 0, 250, 24));
+    CHECK_EQ(sc.vsa, 240);
+    CHECK_EQ(sc.bfa, 80);
+    CHECK(!lcd_scroll_init(&sc, 0, 240, 0));
+    CHECK(!lcd_scroll_init(&sc, 0, 10, 16));
+    CHECK(!lcd_scroll_init(&sc, 300, 40, 16));
+
+    // 未满时只移动光标, 不发送命令
+    lcd_scroll_init(&sc, 40, 240, 16);
+    for(int i = 1; i < 15; i++) {
+        lcd_cmd_queue queue = { 0 };
+
+        CHECK_EQ(lcd_scroll_newline(&sc, &queue), i * 16);
+        CHECK_EQ(queue.used, 0);
+    }
+    // 已满: 新行复用最上面的槽位, 屏幕第一行随之下移一个槽位
+    for(int i = 0; i < 20; i++) {
+        lcd_cmd_queue queue = { 0 };
+        uint16_t top = (i + 1) % 15;
+
+        CHECK_EQ(lcd_scroll_newline(&sc, &queue), i % 15 * 16);
+        CHECK_EQ(sc.top, top);
+        CHECK_EQ(lcd_scroll_y(&sc, 0), top * 16);
+        CHECK_EQ(lcd_scroll_y(&sc, 14), i % 15 * 16);
+        // 一个 0x37 包: [命令][参数个数][起始行]
+        CHECK_EQ(queue.used, 4);
+        CHECK_EQ(queue.buf[0], 0x37);
+        CHECK_EQ(queue.buf[2] << 8 | queue.buf[3], 40 + top * 16);
+    }
+}
+
+static panel pnl, ref_pnl;
+static lcd_io io = { .spi = &pnl }, ref_io = { .spi = &ref_pnl };
+static uint16_t line[LCD_LINE_MAX], ref_line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line };
+static lcd ref_lcd = { .io = &ref_io, .line_buffer = ref_line };
+static lcd_console con;
+
+#define LINES   15
+
+/* 面板上显示的内容与 ref 逐行重绘的结果相同 */
+static bool shown_is_ref(void)
+{
+    for(uint16_t y = 0; y < 240; y++)
+        for(uint16_t x = 0; x < 135; x++)
+            if(panel_shown(&pnl, x + lcd_dev.offset[0], y + lcd_dev.offset[2])
+               != panel_lcd_pixel(&ref_lcd, x, y))
+                return false;
+    return true;
+}
+
+/* ref: 最后 LINES 行从屏幕顶部依次画出 */
+static void draw_ref(int last)
+{
+    char text[20];
+    int first = last >= LINES ? last - LINES + 1 : 0;
+
+    lcd_clear(&ref_lcd, BLACK);
+    for(int i = first; i <= last; i++) {
+        snprintf(text, sizeof(text), "line %02d", i);
+        lcd_show_string(&ref_lcd, 0, (i - first) * 16, (const uint8_t *)text);
+    }
+}
+
+static void test_console(void)
+{
+    char text[20];
+
+    panel_init(&pnl);
+    panel_init(&ref_pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    CHECK(!lcd_console_init(&con, &lcd_dev));
+
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_0);
+    lcd_init_dev(&ref_lcd, LCD_1_14_INCH, LCD_ROTATE_0);
+    lcd_set_font(&lcd_dev, FONT_1608, WHITE, BLACK);
+    lcd_set_font(&ref_lcd, FONT_1608, WHITE, BLACK);
+
+    CHECK(lcd_console_init(&con, &lcd_dev));
+    CHECK_EQ(con.cols, 16);
+    CHECK_EQ(con.scroll.lines, LINES);
+    CHECK_EQ(pnl.tfa, 40);
+    CHECK_EQ(pnl.vsa, 240);
+    CHECK_EQ(pnl.vsp, 40);
+
+    for(int i = 0; i < 40; i++) {
+        int n = snprintf(text, sizeof(text), i ? "\nline %02d" : "line %02d", i);
+
+        if(i == LINES) {
+            // 屏幕已满后的换行: 只有 0x37 和新行的清除, 不重绘其他行
+            panel_clear_stats(&pnl);
+            lcd_console_putc(&con, '\n');
+            CHECK_EQ(pnl.vsp, 40 + 16);
+            CHECK(pnl.commands <= 4);
+            CHECK_EQ(pnl.pixel_bytes, 135 * 16 * 2);
+            printf("  newline when full: %u bytes (full redraw %u)\n",
+                   pnl.cmd_bytes + pnl.pixel_bytes, 135 * 240 * 2);
+            CHECK(pnl.cmd_bytes + pnl.pixel_bytes < 135 * 240 * 2 / 10);
+            lcd_console_write(&con, text + 1, n - 1);
+        } else {
+            lcd_console_write(&con, text, n);
+        }
+        if(i == 3 || i == 14 || i == 20 || i == 39) {
+            draw_ref(i);
+            CHECK(shown_is_ref());
+        }
+    }
+
+    // 超过一行的文字自动换行; \r 回到行首覆盖
+    lcd_console_write(&con, "\n0123456789abcdefXY", 19);
+    lcd_console_write(&con, "\rZ", 2);
+    CHECK_EQ(con.col, 1);
+    CHECK_EQ(lcd_scroll_cursor_y(&con.scroll), lcd_scroll_y(&con.scroll, LINES - 1));
+}
+
+/* printf 只在绑定控制台后输出 */
+static void test_stdout(void)
+{
+    uint16_t y;
+
+    panel_clear_stats(&pnl);
+    lcd_console_stdout(NULL);
+    CHECK_EQ(lcd_console_putchar('A'), 'A');
+    CHECK_EQ(pnl.cmd_bytes + pnl.pixel_bytes, 0);
+
+    lcd_console_stdout(&con);
+    lcd_console_putchar('\n');
+    lcd_console_putchar('A');
+    y = lcd_scroll_cursor_y(&con.scroll);
+    CHECK_EQ(con.col, 1);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, 0, y), BLACK);
+    CHECK(pnl.pixel_bytes > 0);
+    lcd_console_stdout(NULL);
+}
+
+int main(void)
+{
+    test_map();
+    test_console();
+    test_stdout();
+    return test_result();
+}
@@ -0,0 +1,339 @@
+/*
+ * @Describe: 显示服务: 优先级排序与合并规则, 刷新命令等发送完成后才调用 done,
+ *            以及多个提交线程与一个服务线程 (pthread 代替 FreeRTOS 同步) 时每个 done 调用一次, 最终画面正确
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+#include "lcd_server.h"
+
+extern uint16_t g_gram[];
+
+/************ pthread 同步: 互斥量保护队列, 每个事件一个二值信号量 ************/
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_mutex_t ev_lock;
+    pthread_cond_t ev_cond;
+    bool ev[2];
+    int waits[2];
+} sync_ctx;
+
+static void sync_lock(void* ctx)
+{
+    pthread_mutex_lock(&((sync_ctx *)ctx)->lock);
+}
+
+static void sync_unlock(void* ctx)
+{
+    pthread_mutex_unlock(&((sync_ctx *)ctx)->lock);
+}
+
+static void sync_wait(void* ctx, lcd_server_event ev)
+{
+    sync_ctx* s = ctx;
+
+    pthread_mutex_lock(&s->ev_lock);
+    s->waits[ev]++;
+    while(!s->ev[ev])
+        pthread_cond_wait(&s->ev_cond, &s->ev_lock);
+    s->ev[ev] = false;
+    pthread_mutex_unlock(&s->ev_lock);
+}
+
+static void sync_post(void* ctx, lcd_server_event ev)
+{
+    sync_ctx* s = ctx;
+
+    pthread_mutex_lock(&s->ev_lock);
+    s->ev[ev] = true;
+    pthread_cond_broadcast(&s->ev_cond);
+    pthread_mutex_unlock(&s->ev_lock);
+}
+
+static const lcd_server_ops sync_ops = { sync_lock, sync_unlock, sync_wait, sync_post };
+
+static void sync_init(sync_ctx* s)
+{
+    memset(s, 0, sizeof(*s));
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_mutex_init(&s->ev_lock, NULL);
+    pthread_cond_init(&s->ev_cond, NULL);
+}
+
+/************ 排序与合并 ************/
+static lcd_server srv;
+static sync_ctx sync;
+static int done_count[8];
+
+static void on_done(void* arg)
+{
+    __atomic_add_fetch((int *)arg, 1, __ATOMIC_RELAXED);
+}
+
+static lcd_draw_cmd take(void)
+{
+    lcd_draw_cmd cmd = { .type = 0xff };
+
+    lcd_server_take(&srv, &cmd, false);
+    return cmd;
+}
+
+static void test_queue(void)
+{
+    static const uint16_t pic[4 * 4];
+    lcd_draw_cmd cmd;
+
+    sync_init(&sync);
+    lcd_server_init(&srv, &sync_ops, &sync);
+    lcd_server_size(&srv, 240, 135);
+
+    // 数值大的优先, 同优先级按提交顺序
+    lcd_server_fill(&srv, 0, 0, 0, 9, 9, RED);
+    lcd_server_fill(&srv, 2, 20, 0, 29, 9, GREEN);
+    lcd_server_fill(&srv, 1, 40, 0, 49, 9, BLUE);
+    lcd_server_fill(&srv, 2, 60, 0, 69, 9, WHITE);
+    CHECK_EQ(srv.count, 4);
+    CHECK_EQ(take().color, GREEN);
+    CHECK_EQ(take().color, WHITE);
+    CHECK_EQ(take().color, BLUE);
+    CHECK_EQ(take().color, RED);
+    CHECK(!lcd_server_take(&srv, &cmd, false));
+
+    // 同色相邻的填充合并; 中间有相交的命令时不越过它
+    lcd_server_fill(&srv, 0, 0, 0, 9, 9, RED);
+    lcd_server_fill(&srv, 0, 10, 0, 19, 9, RED);
+    CHECK_EQ(srv.count, 1);
+    CHECK_EQ(srv.merged, 1);
+    lcd_server_fill(&srv, 0, 25, 5, 34, 14, BLUE);
+    lcd_server_fill(&srv, 0, 20, 0, 29, 9, RED);
+    CHECK_EQ(srv.count, 3);
+    cmd = take();
+    CHECK(cmd.x == 0 && cmd.width == 20 && cmd.height == 10);
+    take();
+    take();
+
+    // 填充覆盖排队的图片: 图片被丢弃, 它的 done 在提交时调用
+    memset(done_count, 0, sizeof(done_count));
+    lcd_server_picture(&srv, 0, 10, 10, 4, 4, pic, on_done, &done_count[0]);
+    lcd_server_fill(&srv, 0, 0, 0, 50, 50, BLACK);
+    CHECK_EQ(srv.count, 1);
+    CHECK_EQ(srv.dropped, 1);
+    CHECK_EQ(done_count[0], 1);
+    // 同位置同尺寸的图片取代旧图片
+    lcd_server_picture(&srv, 0, 100, 10, 4, 4, pic, on_done, &done_count[1]);
+    lcd_server_picture(&srv, 0, 100, 10, 4, 4, pic, on_done, &done_count[2]);
+    CHECK_EQ(srv.count, 2);
+    CHECK(done_count[1] == 1 && done_count[2] == 0);
+    take();
+    cmd = take();
+    CHECK(cmd.type == LCD_DRAW_PICTURE && cmd.arg == &done_count[2]);
+    lcd_server_finish(&srv, &cmd);
+    CHECK_EQ(done_count[2], 1);
+
+    // 同位置的文本: 新文本之后仍显示旧文本的剩余部分
+    lcd_server_text(&srv, 0, 5, 100, FONT_1206, WHITE, BLACK, "12345");
+    lcd_server_text(&srv, 0, 5, 100, FONT_1206, WHITE, BLACK, "ab");
+    CHECK_EQ(srv.count, 1);
+    cmd = take();
+    CHECK(strcmp(cmd.text, "ab345") == 0);
+    CHECK(cmd.x1 == 5 && cmd.x2 == 5 + 5 * 6 - 1 && cmd.y1 == 100 && cmd.y2 == 111);
+
+    // 刷新命令是屏障
+    lcd_server_fill(&srv, 0, 0, 0, 9, 9, RED);
+    lcd_server_flush(&srv, 0, NULL, NULL, NULL);
+    lcd_server_fill(&srv, 0, 10, 0, 19, 9, RED);
+    CHECK_EQ(srv.count, 3);
+    while(lcd_server_take(&srv, &cmd, false))
+        ;
+
+    // 队列满时不等待的提交返回 false; 不画像素的命令直接完成
+    for(int i = 0; i < LCD_SERVER_QUEUE; i++)
+        lcd_server_fill(&srv, 0, i * 12, 0, i * 12 + 9, 9, (uint16_t)i);
+    cmd = (lcd_draw_cmd){ .type = LCD_DRAW_FILL, .x = 0, .y = 100, .width = 5, .height = 5 };
+    CHECK(!lcd_server_submit(&srv, &cmd, false));
+    cmd = (lcd_draw_cmd){ .type = LCD_DRAW_FILL, .x = 300, .y = 0, .width = 5, .height = 5,
+                          .done = on_done, .arg = &done_count[3] };
+    CHECK(lcd_server_submit(&srv, &cmd, false));
+    CHECK_EQ(done_count[3], 1);
+    CHECK_EQ(srv.count, LCD_SERVER_QUEUE);
+    while(lcd_server_take(&srv, &cmd, false))
+        ;
+}
+
+/************ 在面板上执行 ************/
+static panel pnl, ref_pnl;
+static lcd_io io = { .spi = &pnl }, ref_io = { .spi = &ref_pnl };
+static uint16_t line[2][LCD_LINE_MAX], ref_line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+static lcd ref_lcd = { .io = &ref_io, .line_buffer = ref_line };
+
+static bool flushed_at_done;
+
+static bool panel_is_gram(void)
+{
+    for(uint16_t y = 0; y < 135; y++)
+        for(uint16_t x = 0; x < 240; x++)
+            if(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)) != g_gram[y * 240 + x])
+                return false;
+    return true;
+}
+
+/* done 时发送应已完成, 显存可以改写 */
+static void on_flush(void* arg)
+{
+    flushed_at_done = pnl.pending == NULL && panel_is_gram();
+}
+
+static void test_exec(void)
+{
+    lcd_surface* screen;
+    lcd_anim_cube_t cube;
+
+    panel_init(&pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_set_font(&lcd_dev, FONT_1608, WHITE, BLACK);
+    lcd_anim_cube_init(&cube, screen, 30, LIGHTBLUE, 60, 67);
+
+    sync_init(&sync);
+    lcd_server_init(&srv, &sync_ops, &sync);
+    lcd_server_size(&srv, 240, 135);
+    for(int f = 0; f < 3; f++) {
+        lcd_anim_clear();
+        cube.cx = 60 + f * 40;
+        lcd_anim_cube_update(&cube);
+        lcd_print_ram(screen, 4, 4, "frame %d", f);
+        flushed_at_done = false;
+        lcd_server_flush(&srv, 0, screen, on_flush, NULL);
+        CHECK_EQ(lcd_server_poll(&srv, &lcd_dev), 1);
+        CHECK(flushed_at_done);
+    }
+
+    // 文本命令自带字体, 不改变面板的字体
+    lcd_server_text(&srv, 0, 0, 120, FONT_1206, RED, BLUE, "srv");
+    lcd_server_poll(&srv, &lcd_dev);
+    CHECK(lcd_dev.font.type == FONT_1608 && lcd_dev.font.front_color == WHITE);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, 0, 120), BLUE);
+}
+
+/************ 多线程 ************/
+#define SUBMITTERS  4
+#define BAND        32
+#define COMMANDS    300
+
+static uint16_t colors[SUBMITTERS] = { RED, GREEN, BLUE, MAGENTA };
+static uint16_t pictures[SUBMITTERS][8 * 8];
+static int picture_done[SUBMITTERS], picture_sent[SUBMITTERS];
+static volatile bool stop;
+
+static void on_stop(void* arg)
+{
+    stop = true;
+}
+
+static void* server_loop(void* arg)
+{
+    lcd_draw_cmd cmd;
+
+    while(!stop && lcd_server_take(&srv, &cmd, true)) {
+        lcd_server_exec(&lcd_dev, &cmd);
+        lcd_server_finish(&srv, &cmd);
+    }
+    return NULL;
+}
+
+/* 每个线程只画自己的一条; 最后整条填充并写文字, 优先级 0 */
+static void* submit_loop(void* arg)
+{
+    int t = (int)(intptr_t)arg;
+    int y0 = t * BAND;
+    unsigned seed = t + 1;
+    char text[16];
+
+    for(int i = 0; i < COMMANDS; i++) {
+        int x = rand_r(&seed) % 220, y = y0 + rand_r(&seed) % (BAND - 12);
+        uint8_t priority = rand_r(&seed) % 3;
+
+        switch(rand_r(&seed) % 3) {
+        case 0:
+            lcd_server_fill(&srv, priority, x, y, x + rand_r(&seed) % 20, y + rand_r(&seed) % 12,
+                            (uint16_t)rand_r(&seed));
+            break;
+        case 1:
+            snprintf(text, sizeof(text), "%d:%d", t, i);
+            lcd_server_text(&srv, priority, x % 180, y, FONT_1206, WHITE, (uint16_t)rand_r(&seed), text);
+            break;
+        default:
+            picture_sent[t]++;
+            lcd_server_picture(&srv, priority, x & ~7, y, 8, 8, pictures[t], on_done, &picture_done[t]);
+            break;
+        }
+    }
+    lcd_server_fill(&srv, 0, 0, y0, 239, y0 + BAND - 1, colors[t]);
+    snprintf(text, sizeof(text), "task %d done", t);
+    lcd_server_text(&srv, 0, 4, y0 + 10, FONT_1206, WHITE, BLACK, text);
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    pthread_t server, submitter[SUBMITTERS];
+    bool ok = true;
+
+    panel_init(&pnl);
+    panel_init(&ref_pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_init_dev(&ref_lcd, LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_clear(&lcd_dev, BLACK);
+    for(int t = 0; t < SUBMITTERS; t++)
+        for(int i = 0; i < 8 * 8; i++)
+            pictures[t][i] = colors[t] ^ 0x5555;
+
+    sync_init(&sync);
+    lcd_server_init(&srv, &sync_ops, &sync);
+    lcd_server_size(&srv, 240, 135);
+    stop = false;
+    pthread_create(&server, NULL, server_loop, NULL);
+    for(int t = 0; t < SUBMITTERS; t++)
+        pthread_create(&submitter[t], NULL, submit_loop, (void *)(intptr_t)t);
+    for(int t = 0; t < SUBMITTERS; t++)
+        pthread_join(submitter[t], NULL);
+    // 优先级最低的空刷新排在所有命令之后, 执行完后服务线程退出
+    lcd_server_flush(&srv, 0, NULL, on_stop, NULL);
+    pthread_join(server, NULL);
+
+    CHECK_EQ(srv.count, 0);
+    CHECK_EQ(srv.used, 0);
+    CHECK_EQ(srv.submitted, SUBMITTERS * (COMMANDS + 2) + 1);
+    for(int t = 0; t < SUBMITTERS; t++)
+        CHECK_EQ(picture_done[t], picture_sent[t]);
+
+    // 参考: 每条为最后的填充与文字, 其余为清屏的黑色
+    lcd_clear(&ref_lcd, BLACK);
+    for(int t = 0; t < SUBMITTERS; t++) {
+        char text[16];
+
+        snprintf(text, sizeof(text), "task %d done", t);
+        lcd_fill(&ref_lcd, 0, t * BAND, 239, t * BAND + BAND - 1, colors[t]);
+        lcd_set_font(&ref_lcd, FONT_1206, WHITE, BLACK);
+        lcd_show_string(&ref_lcd, 4, t * BAND + 10, (const uint8_t *)text);
+    }
+    for(uint16_t y = 0; y < 135; y++)
+        for(uint16_t x = 0; x < 240; x++)
+            ok &= panel_lcd_pixel(&lcd_dev, x, y) == panel_lcd_pixel(&ref_lcd, x, y);
+    CHECK(ok);
+    printf("  %d submitters x %d commands: %u merged, %u dropped, %d waits for space\n",
+           SUBMITTERS, COMMANDS + 2, srv.merged, srv.dropped, sync.waits[LCD_SERVER_EV_SPACE]);
+}
+
+int main(void)
+{
+    test_queue();
+    test_exec();
+    test_threads();
+    return test_result();
+}
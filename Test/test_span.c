@@ -0,0 +1,189 @@
+/*
+ * @Describe: 按像素段清屏: lcd_spans 的合并规则, 以及与 memset 整个显存的结果逐帧相同, 擦除的字节数更少
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+#define W   240
+#define H   135
+
+static lcd_span rows[H][LCD_SPAN_MAX];
+static uint8_t counts[H];
+static uint8_t mark[H][W];
+
+/* 加入过的像素都在某一段中 */
+static bool spans_cover(const lcd_spans* sp)
+{
+    for(int y = 0; y < H; y++) {
+        for(int x = 0; x < W; x++) {
+            bool in = false;
+
+            for(uint8_t i = 0; i < sp->count[y]; i++)
+                in |= x >= sp->row[y][i].x1 && x <= sp->row[y][i].x2;
+            if(mark[y][x] && !in)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void test_spans(void)
+{
+    lcd_spans sp;
+
+    lcd_spans_init(&sp, rows, counts, W, H);
+    CHECK_EQ(lcd_spans_area(&sp), 0);
+
+    // 相交/相邻/间隔不超过 LCD_SPAN_GAP 时合并
+    lcd_spans_add(&sp, 5, 10, 19);
+    lcd_spans_add(&sp, 5, 20, 29);
+    CHECK_EQ(sp.count[5], 1);
+    lcd_spans_add(&sp, 5, 30 + LCD_SPAN_GAP, 40);
+    CHECK_EQ(sp.count[5], 1);
+    CHECK(sp.row[5][0].x1 == 10 && sp.row[5][0].x2 == 40);
+    lcd_spans_add(&sp, 5, 41 + LCD_SPAN_GAP + 1, 60);
+    CHECK_EQ(sp.count[5], 2);
+    // 新段把两段连起来
+    lcd_spans_add(&sp, 5, 38, 52);
+    CHECK_EQ(sp.count[5], 1);
+    CHECK(sp.row[5][0].x1 == 10 && sp.row[5][0].x2 == 60);
+
+    // 超出 LCD_SPAN_MAX 时与最近的段合并
+    lcd_spans_reset(&sp);
+    CHECK_EQ(sp.count[5], 0);
+    for(int i = 0; i < LCD_SPAN_MAX; i++)
+        lcd_spans_add(&sp, 7, i * 40, i * 40 + 1);
+    CHECK_EQ(sp.count[7], LCD_SPAN_MAX);
+    lcd_spans_add(&sp, 7, 25, 26);
+    CHECK_EQ(sp.count[7], LCD_SPAN_MAX);
+    CHECK_EQ(lcd_spans_area(&sp), (LCD_SPAN_MAX - 1) * 2 + 41 - 25 + 1);     // 与 40~41 合并
+
+    // 裁剪; 行范围
+    lcd_spans_reset(&sp);
+    lcd_spans_add(&sp, -1, 0, 10);
+    lcd_spans_add(&sp, H, 0, 10);
+    lcd_spans_add(&sp, 3, 300, 400);
+    CHECK(sp.y1 > sp.y2);
+    lcd_spans_add_rect(&sp, -5, -5, 4, 1);
+    CHECK_EQ(lcd_spans_area(&sp), 5 * 2);
+    CHECK(sp.y1 == 0 && sp.y2 == 1);
+
+    // 随机的段: 覆盖所有加入的像素
+    lcd_spans_reset(&sp);
+    memset(mark, 0, sizeof(mark));
+    srand(3);
+    for(int i = 0; i < 3000; i++) {
+        int y = rand() % H, x1 = rand() % W, x2 = x1 + rand() % 30;
+
+        lcd_spans_add(&sp, y, x1, x2);
+        for(int x = x1; x <= x2 && x < W; x++)
+            mark[y][x] = 1;
+        CHECK(sp.count[y] <= LCD_SPAN_MAX);
+    }
+    CHECK(spans_cover(&sp));
+}
+
+/************ 与整屏清除比较 ************/
+#define FRAMES  60
+#define POISON  0xdead
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+static uint16_t frames[FRAMES][W * H];
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* 清屏只写 0: 先把背景换成 POISON, 清屏后仍为 POISON 的像素没有被写过, 再换回 0 */
+static uint32_t clear_counted(double* t)
+{
+    uint32_t written = 0;
+    double t0;
+
+    for(int i = 0; i < W * H; i++)
+        if(!g_gram[i])
+            g_gram[i] = POISON;
+    t0 = now();
+    lcd_anim_clear();
+    *t += now() - t0;
+    for(int i = 0; i < W * H; i++) {
+        if(g_gram[i] == POISON)
+            g_gram[i] = 0;
+        else
+            written += 2;
+    }
+    return written;
+}
+
+static void run(lcd_anim_clear_mode mode, bool record, uint32_t* cleared, uint32_t* sent, double* t)
+{
+    lcd_surface* screen;
+    lcd_anim_cube_t cube[3];
+
+    panel_init(&pnl);
+    pnl.dma = true;
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_anim_set_clear_mode(mode);
+    lcd_set_font(&lcd_dev, FONT_1608, WHITE, BLACK);
+    for(int i = 0; i < 3; i++)
+        lcd_anim_cube_init(&cube[i], screen, 14 + i * 6, i ? GREEN : LIGHTBLUE, 40 + i * 75, 70);
+
+    *cleared = *sent = 0;
+    *t = 0;
+    for(int f = 0; f < FRAMES; f++) {
+        *cleared += clear_counted(t);
+        for(int i = 0; i < 3; i++) {
+            cube[i].cy = 70 + (f * (i + 1)) % 40 - 20;
+            lcd_anim_cube_update(&cube[i]);
+        }
+        lcd_print_ram(screen, 4, 4, "frame %d", f);
+
+        panel_clear_stats(&pnl);
+        lcd_anim_flush(screen);
+        lcd_anim_flush_wait(screen);
+        *sent += pnl.cmd_bytes + pnl.pixel_bytes;
+
+        if(record)
+            memcpy(frames[f], g_gram, sizeof(frames[f]));
+        else
+            CHECK(memcmp(frames[f], g_gram, sizeof(frames[f])) == 0);
+    }
+}
+
+static void test_clear(void)
+{
+    uint32_t full_cleared, full_sent, span_cleared, span_sent;
+    double full_t, span_t;
+
+    run(LCD_ANIM_CLEAR_FULL, true, &full_cleared, &full_sent, &full_t);
+    run(LCD_ANIM_CLEAR_SPANS, false, &span_cleared, &span_sent, &span_t);
+
+    // 显存逐帧相同, 发送的区域相同
+    CHECK_EQ(span_sent, full_sent);
+    CHECK_EQ(full_cleared, FRAMES * W * H * 2);
+    CHECK(span_cleared < full_cleared / 2);
+    printf("  %d frames      cleared bytes/frame  clear us/frame  sent bytes/frame\n", FRAMES);
+    printf("  full memset    %19u %15.1f %17u\n", full_cleared / FRAMES, full_t * 1e6 / FRAMES, full_sent / FRAMES);
+    printf("  spans          %19u %15.1f %17u\n", span_cleared / FRAMES, span_t * 1e6 / FRAMES, span_sent / FRAMES);
+}
+
+int main(void)
+{
+    test_spans();
+    test_clear();
+    return test_result();
+}
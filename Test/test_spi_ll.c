@@ -0,0 +1,177 @@
+/*
+ * @Describe: lcd_spi_ll 寄存器时序: 寄存器访问重定义到模拟外设, 记录每次读写
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+
+typedef struct {
+    bool write;
+    volatile uint32_t* reg;
+    uint32_t val;
+} reg_op;
+
+static reg_op ops[256];
+static int nops;
+
+/* 模拟外设: DR 写入后 TXE 在 txe_reads 次读 SR 后才置位, BSY 在 bsy_reads 次后清零 */
+static volatile uint32_t* sr_reg;
+static int txe_reads = 2, bsy_reads = 4;
+static int txe_wait, bsy_wait;
+
+static void mock_write(volatile uint32_t* reg, uint32_t val)
+{
+    ops[nops++] = (reg_op){ true, reg, val };
+    *reg = val;
+    if(sr_reg && reg == sr_reg + 1) {      // DR 紧跟 SR
+        txe_wait = txe_reads;
+        bsy_wait = bsy_reads;
+    }
+}
+
+static uint32_t mock_read(volatile uint32_t* reg)
+{
+    uint32_t val = *reg;
+
+    if(reg == sr_reg) {
+        val = 0;
+        if(txe_wait)
+            txe_wait--;
+        else
+            val |= 1u << 1;     // TXE
+        if(bsy_wait) {
+            bsy_wait--;
+            val |= 1u << 7;     // BSY
+        }
+    }
+    ops[nops++] = (reg_op){ false, reg, val };
+    return val;
+}
+
+#define LCD_LL_WRITE(reg, val)  mock_write(&(reg), (val))
+#define LCD_LL_READ(reg)        mock_read(&(reg))
+#include "lcd_spi_ll.c"
+
+static lcd_ll_spi spi;
+static lcd_ll_gpio gpio;
+
+static void reset(uint32_t cr1)
+{
+    memset(&spi, 0, sizeof(spi));
+    memset(&gpio, 0, sizeof(gpio));
+    spi.CR1 = cr1;
+    sr_reg = &spi.SR;
+    txe_wait = bsy_wait = 0;
+    nops = 0;
+}
+
+/* BSRR 单次写入: 置位写低 16 位, 复位写高 16 位, 不读 ODR */
+static void test_pin(void)
+{
+    reset(0);
+    lcd_ll_pin(&gpio, 1u << 5, true);
+    lcd_ll_pin(&gpio, 1u << 5, false);
+    lcd_ll_pin(&gpio, 1u << 15, false);
+    CHECK_EQ(nops, 3);
+    for(int i = 0; i < nops; i++) {
+        CHECK(ops[i].write);
+        CHECK(ops[i].reg == &gpio.BSRR);
+    }
+    CHECK_EQ(ops[0].val, 0x00000020);
+    CHECK_EQ(ops[1].val, 0x00200000);
+    CHECK_EQ(ops[2].val, 0x80000000);
+}
+
+/* 检查一次 lcd_ll_write 的记录: 每次写 DR 之前读到 TXE,
+ * 写完最后一帧后先等 TXE 再等 BSY 清零, 之后不再访问寄存器 */
+static void check_sequence(const uint32_t* expect, int frames)
+{
+    int frame = 0;
+    bool txe = false;
+
+    for(int i = 0; i < nops; i++) {
+        const reg_op* op = &ops[i];
+
+        if(op->reg == &spi.DR) {
+            CHECK(op->write);
+            CHECK(txe);
+            if(frame < frames)
+                CHECK_EQ(op->val, expect[frame]);
+            frame++;
+            txe = false;
+        } else if(op->reg == &spi.SR) {
+            CHECK(!op->write);
+            txe = op->val & LCD_LL_SR_TXE;
+        }
+    }
+    CHECK_EQ(frame, frames);
+
+    // 结尾: ... 读到 TXE, 读到 BSY=0 后返回
+    const reg_op* last = &ops[nops - 1];
+    CHECK(last->reg == &spi.SR && !(last->val & LCD_LL_SR_BSY) && (last->val & LCD_LL_SR_TXE));
+    CHECK_EQ(bsy_wait, 0);
+}
+
+static void test_write8(void)
+{
+    static const uint8_t data[] = { 0x2a, 0x00, 0x28 };
+    static const uint32_t frames[] = { 0x2a, 0x00, 0x28 };
+
+    reset(LCD_LL_CR1_SPE | LCD_LL_CR1_BIDIOE);
+    lcd_ll_write(&spi, data, sizeof(data));
+    check_sequence(frames, 3);
+    // 已使能且为发送方向: 不写 CR1
+    for(int i = 0; i < nops; i++)
+        CHECK(!(ops[i].write && ops[i].reg == &spi.CR1));
+}
+
+/* 16 位帧: 按半字写 DR, 字节数为 2 * 帧数 */
+static void test_write16(void)
+{
+    static const uint16_t data[] = { 0xf800, 0x07e0, 0x001f, 0xffff };
+    static const uint32_t frames[] = { 0xf800, 0x07e0, 0x001f, 0xffff };
+
+    reset(LCD_LL_CR1_SPE | LCD_LL_CR1_BIDIOE | LCD_LL_CR1_DFF);
+    lcd_ll_write(&spi, (const uint8_t *)data, sizeof(data));
+    check_sequence(frames, 4);
+}
+
+/* 未使能或处于接收方向 (RAMRD 之后): 先写 CR1, 保留其他位 */
+static void test_enable(void)
+{
+    static const uint8_t data[] = { 0x2c };
+    static const uint32_t frames[] = { 0x2c };
+
+    reset(0x0304);      // MSTR | SSI | SSM
+    lcd_ll_write(&spi, data, 1);
+    CHECK(ops[0].reg == &spi.CR1 && !ops[0].write);
+    CHECK(ops[1].reg == &spi.CR1 && ops[1].write);
+    CHECK_EQ(ops[1].val, 0x0304 | LCD_LL_CR1_SPE | LCD_LL_CR1_BIDIOE);
+    check_sequence(frames, 1);
+}
+
+/* TXE 一直置位时也要等 BSY: 最后一帧还在移位寄存器中 */
+static void test_busy(void)
+{
+    static const uint8_t data[] = { 0x00 };
+    static const uint32_t frames[] = { 0x00 };
+
+    txe_reads = 0;
+    bsy_reads = 5;
+    reset(LCD_LL_CR1_SPE | LCD_LL_CR1_BIDIOE);
+    lcd_ll_write(&spi, data, 1);
+    check_sequence(frames, 1);
+    txe_reads = 2;
+    bsy_reads = 4;
+}
+
+int main(void)
+{
+    test_pin();
+    test_write8();
+    test_write16();
+    test_enable();
+    test_busy();
+    return test_result();
+}
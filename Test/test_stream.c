@@ -0,0 +1,124 @@
+/*
+ * @Describe: lcd_stream 乒乓行缓冲: 模拟的传输在下一次写入或等待时才完成,
+ *            检查输出顺序, 以及生成回调不会写到正在发送的缓冲
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+#include "lcd_stream.h"
+
+#define WIDTH   37
+#define HEIGHT  23
+
+typedef struct {
+    const uint8_t* data;            // 正在发送的缓冲, NULL 为空闲
+    uint32_t len;
+    uint8_t copy[WIDTH * HEIGHT * 2];   // 启动时的内容, 完成时应未被修改
+    uint16_t out[WIDTH * HEIGHT];   // 面板收到的像素
+    uint32_t count;
+    int writes;
+    int waits;
+    int aliased;                    // 生成到正在发送的缓冲的次数
+} fake_wire;
+
+static fake_wire wire;
+
+static void wire_complete(void)
+{
+    if(!wire.data)
+        return;
+    CHECK(memcmp(wire.copy, wire.data, wire.len) == 0);
+    memcpy(&wire.out[wire.count], wire.data, wire.len);
+    wire.count += wire.len / 2;
+    wire.data = NULL;
+}
+
+/* 启动前须等待上一次完成 (与 lcd_write_pixels_async 相同) */
+static void wire_write(void* ctx, uint8_t* data, uint32_t len)
+{
+    wire_complete();
+    wire.data = data;
+    wire.len  = len;
+    memcpy(wire.copy, data, len);
+    wire.writes++;
+}
+
+static void wire_wait(void* ctx)
+{
+    wire_complete();
+    wire.waits++;
+}
+
+static uint16_t pixel(uint16_t row, uint16_t col)
+{
+    return (uint16_t)(row * 256 + col);
+}
+
+static void gen_line(void* arg, uint16_t row, uint16_t* line, uint16_t width)
+{
+    if((const uint8_t *)line == wire.data)
+        wire.aliased++;
+    for(uint16_t i = 0; i < width; i++)
+        line[i] = pixel(row, i);
+}
+
+static void gen_band(void* arg, uint16_t row, uint16_t rows, uint16_t* buf, uint16_t width)
+{
+    if((const uint8_t *)buf == wire.data)
+        wire.aliased++;
+    for(uint16_t r = 0; r < rows; r++)
+        for(uint16_t i = 0; i < width; i++)
+            buf[r * width + i] = pixel(row + r, i);
+}
+
+static void check_output(uint16_t width, uint16_t height)
+{
+    CHECK_EQ(wire.count, (uint32_t)width * height);
+    for(uint16_t r = 0; r < height; r++)
+        for(uint16_t i = 0; i < width; i++)
+            CHECK_EQ(wire.out[r * width + i], pixel(r, i));
+    CHECK(wire.data == NULL);
+    CHECK_EQ(wire.aliased, 0);
+}
+
+static void test_lines(bool pingpong)
+{
+    static uint16_t buf[2][WIDTH];
+    lcd_stream stream = {
+        .buf   = { buf[0], pingpong ? buf[1] : NULL },
+        .write = wire_write,
+        .wait  = wire_wait,
+    };
+
+    memset(&wire, 0, sizeof(wire));
+    lcd_stream_lines(&stream, WIDTH, HEIGHT, gen_line, NULL);
+    check_output(WIDTH, HEIGHT);
+    CHECK_EQ(wire.writes, HEIGHT);
+    // 乒乓时只在最后等待一次, 单缓冲时每行等待
+    CHECK_EQ(wire.waits, pingpong ? 1 : HEIGHT + 1);
+}
+
+static void test_bands(bool pingpong, uint16_t band)
+{
+    static uint16_t buf[2][WIDTH * 8];
+    lcd_stream stream = {
+        .buf   = { buf[0], pingpong ? buf[1] : NULL },
+        .write = wire_write,
+        .wait  = wire_wait,
+    };
+
+    memset(&wire, 0, sizeof(wire));
+    lcd_stream_bands(&stream, WIDTH, HEIGHT, band, gen_band, NULL);
+    check_output(WIDTH, HEIGHT);
+    CHECK_EQ(wire.writes, (HEIGHT + band - 1) / band);
+}
+
+int main(void)
+{
+    test_lines(true);
+    test_lines(false);
+    test_bands(true, 8);
+    test_bands(true, 1);
+    test_bands(false, 5);
+    return test_result();
+}
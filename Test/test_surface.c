@@ -0,0 +1,162 @@
+/*
+ * @Describe: 表面与子视图: 裁剪与坐标换算, 以及三种屏幕 (横竖屏) 上视图内的绘制只落在视图中
+ *            主机上显存放大到 320 x 320 (LCD_ANIM_GRAM_BYTES), 使 1.47" 屏也能分配
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+static bool rect_eq(const lcd_rect* r, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    return r->x1 == x1 && r->y1 == y1 && r->x2 == x2 && r->y2 == y2;
+}
+
+static void test_view(void)
+{
+    static uint8_t buf[160 * 80 * 2];
+    lcd_surface root, view, sub;
+    lcd_rect r;
+
+    CHECK_EQ(LCD_SURFACE_STRIDE(160, 16), 320);
+    CHECK_EQ(LCD_SURFACE_STRIDE(135, 8), 136);
+    CHECK_EQ(LCD_SURFACE_STRIDE(135, 4), 68);
+    CHECK_EQ(LCD_SURFACE_STRIDE(3, 4), 2);
+
+    CHECK(lcd_surface_init(&root, NULL, buf, sizeof(buf), 160, 80, 16));
+    CHECK(!lcd_surface_init(&root, NULL, buf, sizeof(buf) - 1, 160, 80, 16));
+    CHECK(lcd_surface_init(&root, NULL, NULL, 0, 160, 80, 16));     // 条带渲染没有像素
+    lcd_surface_init(&root, NULL, buf, sizeof(buf), 160, 80, 16);
+
+    // 视图超出右下角: 裁掉
+    CHECK(lcd_surface_view(&view, &root, 100, 50, 100, 100));
+    CHECK(view.x == 100 && view.y == 50 && view.width == 60 && view.height == 30);
+    CHECK(view.pixels == root.pixels && view.stride == root.stride);
+    lcd_surface_rect(&view, &r);
+    CHECK(rect_eq(&r, 100, 50, 159, 79));
+
+    // 超出左上角: 原点移到裁剪后的左上角
+    CHECK(lcd_surface_view(&view, &root, -10, -20, 30, 30));
+    CHECK(view.x == 0 && view.y == 0 && view.width == 20 && view.height == 10);
+
+    // 嵌套视图的坐标相对于父视图
+    CHECK(lcd_surface_view(&view, &root, 40, 20, 80, 40));
+    CHECK(lcd_surface_view(&sub, &view, 70, 30, 20, 20));
+    CHECK(sub.x == 110 && sub.y == 50 && sub.width == 10 && sub.height == 10);
+
+    // 完全在外, 或大小为 0
+    CHECK(!lcd_surface_view(&sub, &view, 80, 0, 10, 10));
+    CHECK_EQ(sub.width, 0);
+    CHECK(!lcd_surface_view(&sub, &view, 0, 0, 0, 10));
+
+    // 表面坐标裁剪后换算为根表面坐标
+    r = (lcd_rect){ -5, -5, 5, 5 };
+    CHECK(lcd_surface_clip(&view, &r));
+    CHECK(rect_eq(&r, 40, 20, 45, 25));
+    r = (lcd_rect){ 70, 30, 200, 200 };
+    CHECK(lcd_surface_clip(&view, &r));
+    CHECK(rect_eq(&r, 110, 50, 119, 59));
+    r = (lcd_rect){ 80, 0, 90, 10 };
+    CHECK(!lcd_surface_clip(&view, &r));
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+/* 视图内为 inside, 之外为 0; 面板与显存相同 */
+static bool check_gram(const lcd_surface* screen, const lcd_surface* view, uint16_t inside)
+{
+    uint16_t words = screen->stride / 2;
+
+    for(uint16_t y = 0; y < screen->height; y++) {
+        for(uint16_t x = 0; x < screen->width; x++) {
+            bool in = x >= view->x && x < view->x + view->width && y >= view->y && y < view->y + view->height;
+            uint16_t px = g_gram[y * words + x];
+
+            if(px != (in ? LCD_PIXEL(inside) : 0))
+                return false;
+            if(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)) != px)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void check_geometry(lcd_type type, lcd_rotate rotate)
+{
+    lcd_surface* screen;
+    lcd_surface view;
+    lcd_anim_shape_t fill, edge;
+    lcd_anim_text_t text;
+    uint16_t w, h;
+
+    panel_init(&pnl);
+    lcd_init_dev(&lcd_dev, type, rotate);
+    w = lcd_dev.hw->width;
+    h = lcd_dev.hw->height;
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    CHECK(screen != NULL);
+    if(!screen)
+        return;
+    CHECK(screen->width == w && screen->height == h);
+    CHECK_EQ(screen->stride, w * 2);
+
+    // 右下角的视图, 一部分在屏幕外
+    CHECK(lcd_surface_view(&view, screen, w / 2, h / 2, w, h));
+    CHECK(view.width == w - w / 2 && view.height == h - h / 2);
+
+    // 超出视图的矩形只填满视图
+    lcd_anim_rect_add(&fill, &view, -10, -10, 1000, 1000, RED);
+    lcd_anim_update();
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    CHECK(check_gram(screen, &view, RED));
+
+    // 视图坐标的线段与文字: 起点在视图左上角, 不越过视图的左边和上边
+    lcd_set_font(&lcd_dev, FONT_1206, WHITE, BLUE);
+    lcd_anim_line_add(&edge, &view, -5, 0, view.width + 5, 0, YELLOW);
+    lcd_anim_text_add(&text, &view, 0, 2);
+    lcd_anim_text_printf(&text, "%ux%u", w, h);
+    lcd_anim_update();
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x, view.y), YELLOW);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x + view.width - 1, view.y), YELLOW);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x - 1, view.y), BLACK);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x, view.y - 1), BLACK);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x, view.y + 2), BLUE);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, view.x - 1, view.y + 2), BLACK);
+
+    // 移除后视图内只剩矩形
+    lcd_anim_remove(&edge.item);
+    lcd_anim_remove(&text.item);
+    lcd_anim_update();
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    CHECK(check_gram(screen, &view, RED));
+    lcd_anim_remove(&fill.item);
+    lcd_anim_update();
+    printf("  %-10s rotate %2d: %3u x %3u, view at (%u, %u) %u x %u\n", lcd_dev.hw->name, rotate == LCD_ROTATE_0 ? 0 : 90,
+           w, h, view.x, view.y, view.width, view.height);
+}
+
+static void test_geometry(void)
+{
+    static const lcd_type types[] = { LCD_0_96_INCH, LCD_1_14_INCH, LCD_1_47_INCH };
+
+    for(int i = 0; i < 3; i++) {
+        check_geometry(types[i], LCD_ROTATE_90);
+        check_geometry(types[i], LCD_ROTATE_0);
+    }
+}
+
+int main(void)
+{
+    test_view();
+    test_geometry();
+    return test_result();
+}
@@ -0,0 +1,116 @@
+/*
+ * @Describe: 文字: 每行文字一个窗口经行缓冲发送, 与没有行缓冲时逐字符逐像素发送的画面相同;
+ *            lcd_print 在几种负载下两种方式的发送次数/窗口数/字节数
+ */
+#include <string.h>
+#include <time.h>
+#include "test.h"
+#include "panel.h"
+
+#define CALLS   100
+
+static panel pnl[2];
+static lcd_io io[2] = { { .spi = &pnl[0] }, { .spi = &pnl[1] } };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev[2] = {
+    { .io = &io[0], .line_buffer = line[0], .line_buffer_alt = line[1] },
+    { .io = &io[1] },                                       // 没有行缓冲
+};
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool same_image(void)
+{
+    return memcmp(pnl[0].gram, pnl[1].gram, sizeof(pnl[0].gram)) == 0;
+}
+
+static void setup(bool dma)
+{
+    for(int i = 0; i < 2; i++) {
+        panel_init(&pnl[i]);
+        pnl[i].dma = dma;
+        lcd_init_dev(&lcd_dev[i], LCD_1_14_INCH, LCD_ROTATE_90);
+        lcd_clear(&lcd_dev[i], BLACK);
+        panel_clear_stats(&pnl[i]);
+    }
+}
+
+/* 没有行缓冲时也能画, 画面相同; 放不下的字符不画 */
+static void test_fallback(void)
+{
+    setup(false);
+    for(int i = 0; i < 2; i++) {
+        lcd_set_font(&lcd_dev[i], FONT_1608, WHITE, BLUE);
+        lcd_show_char(&lcd_dev[i], 10, 10, 'A');
+        lcd_show_char(&lcd_dev[i], 236, 10, 'B');           // 右边放不下
+        lcd_show_char(&lcd_dev[i], 10, 125, 'C');           // 下边放不下
+        lcd_show_string(&lcd_dev[i], 200, 40, (const uint8_t *)"wraps to the next row");
+        lcd_set_font(&lcd_dev[i], FONT_3216, RED, BLACK);
+        lcd_show_string(&lcd_dev[i], 0, 100, (const uint8_t *)"bottom row is cut");
+    }
+    CHECK(same_image());
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev[1], 10, 10), BLUE);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev[1], 236, 10), BLACK);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev[1], 10, 125), BLACK);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev[1], 0, 56), BLUE);            // 换行后的第二行
+    CHECK(pnl[0].outside == 0 && pnl[1].outside == 0);
+    CHECK_EQ(pnl[0].pixel_bytes, pnl[1].pixel_bytes);
+}
+
+typedef struct {
+    const char* name;
+    font_type font;
+    uint16_t x, y;
+    const char* fmt;
+} workload;
+
+static const workload loads[] = {
+    { "FPS 8x16",       FONT_1608, 5, 5,    "FPS:%d" },
+    { "sensor 6x12",    FONT_1206, 0, 60,   "Temperature %d.%d C" },
+    { "clock 12x24",    FONT_2412, 20, 40,  "%02d:%02d" },
+    { "large 16x32",    FONT_3216, 0, 90,   "%d mV" },
+    { "wraps 8x16",     FONT_1608, 120, 20, "line %d wraps across the panel edge %d" },
+};
+
+static void bench(bool dma)
+{
+    printf("  %-13s %-6s %10s %8s %10s %9s\n", "lcd_print", "path", "xfers", "windows", "bytes", "us");
+    for(size_t w = 0; w < sizeof(loads) / sizeof(loads[0]); w++) {
+        const workload* wl = &loads[w];
+        double t[2];
+
+        setup(dma);
+        for(int i = 0; i < 2; i++) {
+            lcd_set_font(&lcd_dev[i], wl->font, YELLOW, BLACK);
+            t[i] = now();
+            for(int n = 0; n < CALLS; n++)
+                lcd_print(&lcd_dev[i], wl->x, wl->y, wl->fmt, n * 7, n % 10);
+            t[i] = (now() - t[i]) * 1e6 / CALLS;
+        }
+        CHECK(same_image());
+        CHECK_EQ(pnl[0].pixel_bytes, pnl[1].pixel_bytes);
+        CHECK(pnl[0].xfers * 10 < pnl[1].xfers);
+        CHECK(pnl[0].windows <= pnl[1].windows);
+        for(int i = 0; i < 2; i++) {
+            printf("  %-13s %-6s %10.1f %8.1f %10.1f %9.2f\n", i ? "" : wl->name, i ? "pixel" : "lines",
+                   (double)pnl[i].xfers / CALLS, (double)pnl[i].windows / CALLS,
+                   (double)(pnl[i].cmd_bytes + pnl[i].pixel_bytes) / CALLS, t[i]);
+        }
+    }
+}
+
+int main(void)
+{
+    test_fallback();
+    printf("blocking SPI\n");
+    bench(false);
+    printf("DMA\n");
+    bench(true);
+    return test_result();
+}
@@ -0,0 +1,191 @@
+/*
+ * @Describe: 分块哈希: 软件 CRC 与 CRC 单元一致, 扫描出的块与逐像素比较两帧的结果相同
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+#include "lcd_anim.h"
+
+extern uint16_t g_gram[];
+
+/* STM32 CRC 单元: 初值 0xFFFFFFFF 写入 0x12345678 */
+static void test_crc(void)
+{
+    static const uint16_t word[2] = { 0x5678, 0x1234 };
+    uint32_t crc;
+
+    lcd_tile_hash_soft.reset(&crc);
+    lcd_tile_hash_soft.feed(&crc, word, 2);
+    CHECK_EQ(lcd_tile_hash_soft.result(&crc), 0xDF8A8A2Bu);
+
+    // 分两次输入与一次输入相同; 奇数个像素时最后一个不输入
+    {
+        uint16_t px[6] = { 1, 2, 3, 4, 5, 6 };
+        uint32_t a, b;
+
+        lcd_tile_hash_soft.reset(&a);
+        lcd_tile_hash_soft.feed(&a, px, 6);
+        lcd_tile_hash_soft.reset(&b);
+        lcd_tile_hash_soft.feed(&b, px, 2);
+        lcd_tile_hash_soft.feed(&b, px + 2, 5);
+        CHECK_EQ(lcd_tile_hash_soft.result(&a), lcd_tile_hash_soft.result(&b));
+    }
+}
+
+/* 135 宽: 最后一列块 7 像素宽 (奇数) */
+#define W   135
+#define H   100
+#define COLS    LCD_TILE_COLS(W)
+#define ROWS    LCD_TILE_ROWS(H)
+
+static uint16_t fb[W * H], prev[W * H];
+static uint32_t hash[COLS * ROWS];
+static uint8_t marked[ROWS][COLS];
+static uint32_t segments;
+
+static void mark(void* ctx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    // 段在块边界上, 同一块行, 不超出显存
+    CHECK_EQ(x1 % LCD_TILE_W, 0);
+    CHECK_EQ(y1 % LCD_TILE_H, 0);
+    CHECK(x2 == W - 1 || (x2 + 1) % LCD_TILE_W == 0);
+    CHECK(y2 == H - 1 || y2 == y1 + LCD_TILE_H - 1);
+    CHECK(x2 < W && y2 < H && x1 <= x2);
+    for(uint16_t c = x1 / LCD_TILE_W; c <= x2 / LCD_TILE_W; c++) {
+        CHECK(!marked[y1 / LCD_TILE_H][c]);
+        marked[y1 / LCD_TILE_H][c] = 1;
+    }
+    segments++;
+}
+
+/* 逐像素比较 prev 与 fb 得出的改变块, 与扫描结果逐块相同 */
+static void check_scan(lcd_tiles* tiles, bool all)
+{
+    uint32_t expect = 0, changed;
+
+    memset(marked, 0, sizeof(marked));
+    segments = 0;
+    changed = lcd_tiles_scan(tiles, fb, &lcd_tile_hash_soft, &(uint32_t){ 0 }, mark, NULL);
+
+    for(int r = 0; r < ROWS; r++) {
+        for(int c = 0; c < COLS; c++) {
+            bool diff = all;
+
+            for(int y = r * LCD_TILE_H; y < H && y < (r + 1) * LCD_TILE_H; y++)
+                for(int x = c * LCD_TILE_W; x < W && x < (c + 1) * LCD_TILE_W; x++)
+                    diff |= fb[y * W + x] != prev[y * W + x];
+            CHECK_EQ(marked[r][c], diff);
+            expect += diff;
+        }
+    }
+    CHECK_EQ(changed, expect);
+    memcpy(prev, fb, sizeof(fb));
+}
+
+static void test_scan(void)
+{
+    lcd_tiles tiles;
+
+    srand(1);
+    for(int i = 0; i < W * H; i++)
+        fb[i] = (uint16_t)rand();
+
+    // 第一次扫描: 全部改变, 每块行一段
+    lcd_tiles_init(&tiles, W, H, hash);
+    CHECK_EQ(tiles.cols, 9);
+    CHECK_EQ(tiles.rows, 7);
+    check_scan(&tiles, true);
+    CHECK_EQ(segments, ROWS);
+
+    // 没有改变
+    check_scan(&tiles, false);
+    CHECK_EQ(segments, 0);
+
+    // 单个像素 (包括奇数宽度块的最后一个像素与最后一行)
+    fb[W - 1] ^= 1;
+    check_scan(&tiles, false);
+    fb[(H - 1) * W + 17] ^= 0x8000;
+    check_scan(&tiles, false);
+    CHECK_EQ(segments, 1);
+
+    // 随机改变若干像素或小矩形
+    for(int frame = 0; frame < 50; frame++) {
+        int n = rand() % 8;
+
+        for(int i = 0; i < n; i++) {
+            int x = rand() % W, y = rand() % H, w = 1 + rand() % 20, h = 1 + rand() % 20;
+
+            for(int yy = y; yy < y + h && yy < H; yy++)
+                for(int xx = x; xx < x + w && xx < W; xx++)
+                    fb[yy * W + xx] = (uint16_t)rand();
+        }
+        check_scan(&tiles, false);
+    }
+
+    // 写入相同的值不算改变; 交换块内两个像素算改变
+    fb[20 * W + 3] = RED;
+    fb[20 * W + 4] = BLUE;
+    check_scan(&tiles, false);
+    fb[5] = prev[5];
+    check_scan(&tiles, false);
+    CHECK_EQ(segments, 0);
+    fb[20 * W + 3] = BLUE;
+    fb[20 * W + 4] = RED;
+    check_scan(&tiles, false);
+    CHECK_EQ(segments, 1);
+
+    // 面板内容未知后全部重发
+    lcd_tiles_invalidate(&tiles);
+    check_scan(&tiles, true);
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[2][LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line[0], .line_buffer_alt = line[1] };
+
+static bool panel_is_gram(void)
+{
+    for(uint16_t y = 0; y < 135; y++)
+        for(uint16_t x = 0; x < 240; x++)
+            if(LCD_PIXEL(panel_lcd_pixel(&lcd_dev, x, y)) != g_gram[y * 240 + x])
+                return false;
+    return true;
+}
+
+/* 分块模式: 不经绘制函数直接修改显存也能发现, 只发送改变的块 */
+static void test_anim(void)
+{
+    lcd_surface* screen;
+
+    panel_init(&pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    screen = lcd_anim_init_buffer(&lcd_dev);
+    lcd_anim_set_flush_mode(LCD_ANIM_FLUSH_TILES);
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    CHECK(panel_is_gram());
+
+    panel_clear_stats(&pnl);
+    g_gram[10 * 240 + 10] = LCD_PIXEL(RED);
+    g_gram[100 * 240 + 200] = LCD_PIXEL(GREEN);
+    lcd_anim_flush(screen);
+    lcd_anim_flush_wait(screen);
+    CHECK(panel_is_gram());
+    CHECK_EQ(pnl.pixel_bytes, 2 * LCD_TILE_W * LCD_TILE_H * 2);
+    printf("  2 changed pixels: %u bytes sent (full frame %u)\n", pnl.cmd_bytes + pnl.pixel_bytes,
+           240 * 135 * 2);
+
+    panel_clear_stats(&pnl);
+    lcd_anim_flush(screen);
+    CHECK_EQ(pnl.xfers, 0);
+}
+
+int main(void)
+{
+    test_crc();
+    test_scan();
+    test_anim();
+    return test_result();
+}
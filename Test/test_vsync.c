@@ -0,0 +1,247 @@
+/*
+ * @Describe: TE 同步调度仿真: 面板以周期 T 扫描, 渲染循环按 lcd_vsync 的决定开始刷新,
+ *            统计每次扫描显示的行是否来自同一帧 (撕裂), 以及刷新次数与错过的 TE
+ *            时间单位为微秒, 从接近 UINT32_MAX 处开始以覆盖回绕
+ */
+#include <string.h>
+#include "test.h"
+#include "lcd_vsync.h"
+
+#define ROWS        240         // 扫描方向的行数 (写入与扫描同向)
+#define PERIOD      16667       // 60Hz
+#define BLANK       1160        // 消隐期: TE 上升沿之后, 约 24 / 344 行
+#define GUARD       500
+#define DURATION    2000000
+#define MAX_FLUSH   (DURATION / 1000)
+
+typedef struct {
+    uint32_t render;            // 渲染一帧的耗时 (与上一帧的发送并行)
+    uint32_t flush;             // 发送一帧的耗时
+    bool vsync;                 // false: 渲染完立即发送 (上一帧发完后)
+    bool te;                    // false: 面板没有 TE 输出
+    uint32_t timeout;           // 等不到 TE 时强制开始
+
+    /* 结果 */
+    uint32_t flushes;
+    uint32_t passes;            // 统计的扫描次数 (第一帧写完之后)
+    uint32_t torn;              // 显示了不止一帧的扫描次数
+    uint32_t missed;
+} sim;
+
+static uint32_t flush_start[MAX_FLUSH];
+
+/* 时间以开始时刻为 0 计算, 传给 lcd_vsync 的时间加上 base 后回绕 */
+static const uint32_t base = 0xffffffffu - 500000;
+
+/* 第 k 次刷新写完第 r 行的时间 */
+static uint32_t row_written(const sim* s, int k, int r)
+{
+    return flush_start[k] + (uint32_t)((uint64_t)(r + 1) * s->flush / ROWS);
+}
+
+/* 每次扫描逐行取当时最后写入的帧 */
+static void check_tearing(sim* s)
+{
+    static int latest[ROWS];
+
+    for(int r = 0; r < ROWS; r++)
+        latest[r] = -1;
+
+    for(uint32_t edge = 0; edge + PERIOD <= DURATION; edge += PERIOD) {
+        int first = -2;
+        bool torn = false;
+
+        for(int r = 0; r < ROWS; r++) {
+            uint32_t scan = edge + BLANK + (uint32_t)((uint64_t)r * (PERIOD - BLANK) / ROWS);
+
+            while(latest[r] + 1 < (int)s->flushes && row_written(s, latest[r] + 1, r) <= scan)
+                latest[r]++;
+            if(first == -2)
+                first = latest[r];
+            torn |= latest[r] != first;
+        }
+        if(first < 0 && !torn)
+            continue;           // 还没有完整的一帧
+        s->passes++;
+        s->torn += torn;
+    }
+}
+
+static void run(sim* s)
+{
+    lcd_vsync vs;
+    uint32_t ready = s->render;     // 当前帧渲染完成的时间
+    uint32_t done = 0;              // 正在发送的帧的结束时间
+    uint32_t waiting = 0;           // 开始等待 TE 的时间
+    bool busy = false, wait = false;
+
+    lcd_vsync_init(&vs, GUARD, BLANK);
+    s->flushes = 0;
+    s->passes  = 0;
+    s->torn    = 0;
+
+    for(uint32_t t = 0; t < DURATION && s->flushes < MAX_FLUSH; t++) {
+        bool start = false;
+
+        if(busy && t == done) {
+            busy = false;
+            lcd_vsync_done(&vs, base + t);
+        }
+        if(s->te && t % PERIOD == 0 && lcd_vsync_edge(&vs, base + t))
+            start = true;
+
+        if(!wait && t >= ready) {
+            wait = true;
+            waiting = t;
+            if(s->vsync && lcd_vsync_request(&vs, base + t))
+                start = true;
+        }
+        if(wait && !s->vsync && !busy)
+            start = true;
+        // lcd_io_vsync_begin 的超时; 上一帧还在发送时 lcd_vsync 不会开始新的一帧
+        if(wait && s->vsync && !start && !busy && t - waiting >= s->timeout) {
+            lcd_vsync_force(&vs, base + t);
+            start = true;
+        }
+
+        // lcd_vsync 可能决定稍后开始 (等扫描离开消隐期)
+        if(start) {
+            uint32_t at = s->vsync ? vs.start - base : t;
+
+            flush_start[s->flushes++] = at;
+            busy = true;
+            done = at + s->flush;
+            wait = false;
+            ready = at + s->render;
+        }
+    }
+    s->missed = vs.missed;
+    check_tearing(s);
+}
+
+static void report(const char* name, const sim* s)
+{
+    printf("  %-28s %5.1f fps  %4u scans  %4u torn  %4u missed\n", name,
+           s->flushes * 1e6 / DURATION, s->passes, s->torn, s->missed);
+}
+
+static void test_scenarios(void)
+{
+    sim s;
+
+    printf("  T = %u us, blanking %u us\n", PERIOD, BLANK);
+
+    // 不同步: 刷新与扫描相对位置漂移, 出现撕裂
+    s = (sim){ .render = 5000, .flush = 12000, .vsync = false, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("F < T, no vsync", &s);
+    CHECK(s.torn > 0);
+
+    // F <= T: 在消隐期内开始, 写入一直领先扫描
+    s = (sim){ .render = 5000, .flush = 12000, .vsync = true, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("F < T, vsync", &s);
+    CHECK_EQ(s.torn, 0);
+    CHECK(s.flushes >= DURATION / PERIOD - 1);
+    for(uint32_t k = 0; k < s.flushes; k++)
+        CHECK(flush_start[k] % PERIOD <= GUARD);
+
+    // 刷新几乎占满一个周期: 只能紧跟边沿开始 (窗口为 T - F)
+    s = (sim){ .render = 5000, .flush = PERIOD - 200, .vsync = true, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("F = T - 200us, vsync", &s);
+    CHECK_EQ(s.torn, 0);
+
+    // 渲染慢于一个周期: 只能隔帧刷新, 仍不撕裂
+    s = (sim){ .render = 20000, .flush = 12000, .vsync = true, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("F < T, render > T, vsync", &s);
+    CHECK_EQ(s.torn, 0);
+
+    // T < F <= 2T: 扫描离开消隐期后开始, 从后面追赶扫描, 在下一次扫描到达前写完
+    s = (sim){ .render = 5000, .flush = 25000, .vsync = false, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("T < F < 2T, no vsync", &s);
+    CHECK(s.torn > 0);
+    s.vsync = true;
+    run(&s);
+    report("T < F < 2T, vsync", &s);
+    // 第一帧还不知道刷新耗时, 按快于扫描处理
+    CHECK(s.torn <= 1);
+    // 准备好时上一帧还在发送, 错过一个 TE, 隔帧刷新
+    CHECK(s.missed > 0);
+    CHECK(s.flushes >= DURATION / (2 * PERIOD) - 1);
+    for(uint32_t k = 1; k < s.flushes; k++)
+        CHECK_EQ(flush_start[k] % PERIOD, BLANK);
+
+    // F > 2T: 没有不撕裂的起点, 只保证持续刷新
+    s = (sim){ .render = 5000, .flush = 40000, .vsync = true, .te = true, .timeout = 2 * PERIOD };
+    run(&s);
+    report("F > 2T, vsync", &s);
+    CHECK(s.flushes >= DURATION / (3 * PERIOD) - 1);
+
+    // 没有 TE: 每帧等到超时后开始, 全部计入 missed, 不会卡住
+    s = (sim){ .render = 5000, .flush = 12000, .vsync = true, .te = false, .timeout = 20000 };
+    run(&s);
+    report("no TE output, timeout 20ms", &s);
+    CHECK(s.flushes > 0);
+    CHECK_EQ(s.missed, s.flushes);
+}
+
+/* 窗口: F <= T 为 min(guard, T - F), T < F <= 2T 为 [blank, 2T - F], 更慢时为 0 */
+static void test_window(void)
+{
+    lcd_vsync vs;
+
+    lcd_vsync_init(&vs, GUARD, BLANK);
+    CHECK_EQ(lcd_vsync_window(&vs), GUARD);
+    CHECK_EQ(lcd_vsync_delay(&vs), 0);
+    vs.period = PERIOD;
+    vs.flush_time = PERIOD / 2;
+    CHECK_EQ(lcd_vsync_window(&vs), GUARD);
+    vs.flush_time = PERIOD - 100;
+    CHECK_EQ(lcd_vsync_window(&vs), 100);
+    CHECK_EQ(lcd_vsync_delay(&vs), 0);
+    vs.flush_time = PERIOD + 100;
+    CHECK_EQ(lcd_vsync_window(&vs), PERIOD - 100);
+    CHECK_EQ(lcd_vsync_delay(&vs), BLANK);
+    vs.flush_time = 2 * PERIOD;
+    CHECK_EQ(lcd_vsync_window(&vs), 0);
+    vs.flush_time = 2 * PERIOD + 1;
+    CHECK_EQ(lcd_vsync_window(&vs), 0);
+
+    // 收到 TE 之前的请求挂起; 第一个边沿开始; 周期跨过回绕
+    lcd_vsync_init(&vs, GUARD, BLANK);
+    CHECK(!lcd_vsync_request(&vs, 0xfffffff0u));
+    CHECK(lcd_vsync_edge(&vs, 0xfffffff8u));
+    CHECK(!vs.pending && vs.busy);
+    CHECK_EQ(vs.start, 0xfffffff8u);
+    lcd_vsync_done(&vs, 0xfffffff8u + 100);
+    CHECK_EQ(vs.flush_time, 100);
+    CHECK(!lcd_vsync_edge(&vs, 0xfffffff8u + PERIOD));
+    CHECK_EQ(vs.period, PERIOD);
+    CHECK(lcd_vsync_request(&vs, 0xfffffff8u + PERIOD + GUARD));
+    lcd_vsync_done(&vs, 0xfffffff8u + PERIOD + GUARD + 100);
+    CHECK(!lcd_vsync_request(&vs, 0xfffffff8u + PERIOD + GUARD + 101));
+    CHECK_EQ(vs.missed, 0);
+
+    // 刷新慢于扫描: 在边沿或消隐期内决定开始, 开始时间推迟到消隐期结束
+    lcd_vsync_init(&vs, GUARD, BLANK);
+    lcd_vsync_edge(&vs, 0);
+    CHECK(lcd_vsync_request(&vs, 10));
+    lcd_vsync_done(&vs, 10 + 25000);
+    lcd_vsync_edge(&vs, PERIOD);
+    CHECK(lcd_vsync_request(&vs, PERIOD + 300));
+    CHECK_EQ(vs.start, PERIOD + BLANK);
+    lcd_vsync_done(&vs, PERIOD + BLANK + 25000);
+    CHECK(!lcd_vsync_request(&vs, PERIOD + BLANK + 25000));
+    CHECK(lcd_vsync_edge(&vs, 2 * PERIOD));
+    CHECK_EQ(vs.start, 2 * PERIOD + BLANK);
+}
+
+int main(void)
+{
+    test_window();
+    test_scenarios();
+    return test_result();
+}
@@ -0,0 +1,140 @@
+/*
+ * @Describe: 窗口缓存: lcd_window_set 的命令选择, 以及文字/画线时省掉的地址命令字节
+ */
+#include <string.h>
+#include "test.h"
+#include "panel.h"
+
+static void test_set(void)
+{
+    lcd_window win;
+
+    lcd_window_reset(&win);
+    CHECK_EQ(lcd_window_set(&win, 0, 0, 9, 19), LCD_WIN_CASET | LCD_WIN_RASET | LCD_WIN_RAMWR);
+    // 窗口不变: 只从起点重新写
+    CHECK_EQ(lcd_window_set(&win, 0, 0, 9, 19), LCD_WIN_RAMWR);
+    CHECK_EQ(lcd_window_set(&win, 10, 0, 19, 19), LCD_WIN_CASET | LCD_WIN_RAMWR);
+    CHECK_EQ(lcd_window_set(&win, 10, 5, 19, 19), LCD_WIN_RASET | LCD_WIN_RAMWR);
+    CHECK_EQ(lcd_window_set(&win, 10, 5, 19, 6), LCD_WIN_RASET | LCD_WIN_RAMWR);
+
+    // 写满 3 行后从第 3 行续写
+    lcd_window_set(&win, 0, 0, 9, 19);
+    lcd_window_advance(&win, 30);
+    CHECK_EQ(lcd_window_set(&win, 0, 3, 9, 19), LCD_WIN_RAMWRC);
+    // 续写不改变缓存的窗口: 写指针仍按原窗口计
+    CHECK_EQ(win.y1, 0);
+    CHECK_EQ(win.pos, 30);
+    lcd_window_advance(&win, 50);
+    CHECK_EQ(lcd_window_set(&win, 0, 8, 9, 19), LCD_WIN_RAMWRC);
+
+    // 写指针不在行首, 或与新起始行不符
+    lcd_window_set(&win, 0, 0, 9, 19);
+    lcd_window_advance(&win, 25);
+    CHECK_EQ(lcd_window_set(&win, 0, 2, 9, 19), LCD_WIN_RASET | LCD_WIN_RAMWR);
+    lcd_window_advance(&win, 10);
+    CHECK_EQ(lcd_window_set(&win, 0, 4, 9, 19), LCD_WIN_RASET | LCD_WIN_RAMWR);
+    // 结束行不同
+    lcd_window_set(&win, 0, 0, 9, 19);
+    lcd_window_advance(&win, 10);
+    CHECK_EQ(lcd_window_set(&win, 0, 1, 9, 18), LCD_WIN_RASET | LCD_WIN_RAMWR);
+
+    // 写满整个窗口后写指针回到起点
+    lcd_window_set(&win, 0, 0, 9, 1);
+    lcd_window_advance(&win, 20);
+    CHECK_EQ(win.pos, 0);
+    CHECK_EQ(lcd_window_set(&win, 0, 1, 9, 1), LCD_WIN_RASET | LCD_WIN_RAMWR);
+
+    // 复位后 (如面板重新初始化) 全部重发, 无效时不记录写入
+    lcd_window_reset(&win);
+    lcd_window_advance(&win, 10);
+    CHECK_EQ(win.pos, 0);
+    CHECK_EQ(lcd_window_set(&win, 0, 1, 9, 1), LCD_WIN_CASET | LCD_WIN_RASET | LCD_WIN_RAMWR);
+}
+
+static panel pnl;
+static lcd_io io = { .spi = &pnl };
+static uint16_t line[LCD_LINE_MAX];
+static lcd lcd_dev = { .io = &io, .line_buffer = line };
+
+/* 没有缓存时每次设置地址都发送 CASET(5) + RASET(5) + RAMWR(1) */
+#define ADDRESS_BYTES   11
+
+static void report(const char* name)
+{
+    uint32_t sets = pnl.ramwr + pnl.ramwrc;
+
+    CHECK(pnl.cmd_bytes < sets * ADDRESS_BYTES);
+    printf("  %-22s %6u %9u %9u %6.1f%%\n", name, sets, sets * ADDRESS_BYTES, pnl.cmd_bytes,
+           100.0 * (sets * ADDRESS_BYTES - pnl.cmd_bytes) / (sets * ADDRESS_BYTES));
+}
+
+static void text_chars(void)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog 0123456789";
+
+    for(int row = 0; row < 8; row++)
+        for(int i = 0; i < 30; i++)
+            lcd_show_char(&lcd_dev, i * 8, row * 16, text[(row * 30 + i) % (sizeof(text) - 1)]);
+}
+
+static void text_strings(void)
+{
+    for(int row = 0; row < 8; row++)
+        lcd_print(&lcd_dev, 0, row * 16, "line %d: %s", row, "status OK, 23.5 C");
+}
+
+static void lines_hv(void)
+{
+    for(int i = 0; i < 10; i++) {
+        lcd_draw_line(&lcd_dev, 0, i * 13, 239, i * 13, RED);
+        lcd_draw_line(&lcd_dev, i * 24, 0, i * 24, 134, GREEN);
+    }
+}
+
+static void lines_diagonal(void)
+{
+    for(int i = 0; i < 10; i++)
+        lcd_draw_line(&lcd_dev, i * 10, 0, 239 - i * 10, 134, BLUE);
+    lcd_draw_rectangle(&lcd_dev, 20, 20, 219, 114, WHITE);
+}
+
+static void test_workloads(void)
+{
+    static const struct {
+        const char* name;
+        void (*run)(void);
+    } loads[] = {
+        { "lcd_show_char x 240", text_chars },
+        { "lcd_print x 8 rows", text_strings },
+        { "h/v lines x 20", lines_hv },
+        { "diagonal + rectangle", lines_diagonal },
+    };
+
+    panel_init(&pnl);
+    lcd_init_dev(&lcd_dev, LCD_1_14_INCH, LCD_ROTATE_90);
+    lcd_set_font(&lcd_dev, FONT_1608, YELLOW, BLACK);
+
+    printf("  %-22s %6s %9s %9s %7s\n", "workload", "sets", "uncached", "cached", "saved");
+    for(int i = 0; i < 4; i++) {
+        lcd_clear(&lcd_dev, BLACK);
+        panel_clear_stats(&pnl);
+        loads[i].run();
+        report(loads[i].name);
+    }
+
+    // 跳过命令后像素仍落在正确位置; 交点为后画的线
+    lcd_clear(&lcd_dev, BLACK);
+    lines_hv();
+    for(int x = 0; x < 240; x++)
+        CHECK_EQ(panel_lcd_pixel(&lcd_dev, x, 13), (x % 24 == 0 && x >= 24 && x <= 216) ? GREEN : RED);
+    for(int y = 0; y < 135; y++)
+        CHECK_EQ(panel_lcd_pixel(&lcd_dev, 48, y), (y % 13 == 0 && y >= 39 && y <= 117) ? RED : GREEN);
+    CHECK_EQ(panel_lcd_pixel(&lcd_dev, 47, 12), BLACK);
+}
+
+int main(void)
+{
+    test_set();
+    test_workloads();
+    return test_result();
+}
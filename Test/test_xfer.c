@@ -0,0 +1,280 @@
+/*
+ * @Describe: lcd_xfer 传输状态机与分段接续, 后端为模拟的 DMA: 任务等待时由模拟中断完成传输
+ */
+#include <string.h>
+#include "test.h"
+#include "lcd_xfer.h"
+
+typedef struct {
+    lcd_xfer* xfer;
+    int starts;
+    int waits;
+    int notifies;
+    int spurious;           // 前几次等待不触发中断 (残留的通知)
+    bool fail;              // start 返回 false
+    int fail_at;            // 第 fail_at 次 start 返回 false (从 1 开始, 0 为不失败)
+    int error_at;           // 第 error_at 段传输出错 (错误中断代替完成中断, 0 为不出错)
+    const uint8_t* data[8];
+    uint32_t len[8];
+} fake_dma;
+
+static bool fake_start(void* ctx, const uint8_t* data, uint32_t len)
+{
+    fake_dma* dma = ctx;
+
+    if(dma->fail || dma->starts + 1 == dma->fail_at)
+        return false;
+    if(dma->starts < 8) {
+        dma->data[dma->starts] = data;
+        dma->len[dma->starts]  = len;
+    }
+    dma->starts++;
+    return true;
+}
+
+/* 任务阻塞期间传输完成: 在这里调用中断处理 */
+static void fake_wait(void* ctx)
+{
+    fake_dma* dma = ctx;
+
+    dma->waits++;
+    if(dma->spurious) {
+        dma->spurious--;
+        return;
+    }
+    if(dma->starts == dma->error_at)
+        lcd_xfer_abort(dma->xfer);
+    else
+        lcd_xfer_isr(dma->xfer);
+}
+
+static void fake_notify(void* ctx)
+{
+    ((fake_dma *)ctx)->notifies++;
+}
+
+static const lcd_xfer_ops fake_ops = {
+    .start  = fake_start,
+    .wait   = fake_wait,
+    .notify = fake_notify,
+};
+
+static lcd_xfer xfer;
+static fake_dma dma;
+
+static void setup(void)
+{
+    memset(&dma, 0, sizeof(dma));
+    dma.xfer = &xfer;
+    lcd_xfer_init(&xfer, &fake_ops, &dma);
+}
+
+/* 提交后立即返回, 完成中断通知一次 */
+static void test_async(void)
+{
+    uint8_t buf[100];
+
+    setup();
+    CHECK(lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    CHECK(lcd_xfer_busy(&xfer));
+    CHECK_EQ(dma.starts, 1);
+    CHECK(dma.data[0] == buf);
+    CHECK_EQ(dma.len[0], sizeof(buf));
+    CHECK_EQ(dma.notifies, 0);
+
+    lcd_xfer_isr(&xfer);
+    CHECK(!lcd_xfer_busy(&xfer));
+    CHECK_EQ(xfer.complete, 1);
+    CHECK_EQ(dma.notifies, 1);
+
+    // 已完成时等待不阻塞
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(dma.waits, 0);
+}
+
+/* 上一次未完成时再次提交: 先等待, 两次传输按顺序启动 */
+static void test_back_to_back(void)
+{
+    uint8_t a[64], b[64];
+
+    setup();
+    CHECK(lcd_xfer_submit(&xfer, a, sizeof(a)));
+    CHECK(lcd_xfer_submit(&xfer, b, sizeof(b)));
+    CHECK_EQ(dma.waits, 1);
+    CHECK_EQ(dma.starts, 2);
+    CHECK(dma.data[0] == a && dma.data[1] == b);
+    CHECK_EQ(xfer.complete, 1);
+
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(xfer.complete, 2);
+    CHECK_EQ(dma.notifies, 2);
+}
+
+/* 后端不可用: 返回 false 由调用者阻塞发送, 状态保持空闲 */
+static void test_start_fail(void)
+{
+    uint8_t buf[64];
+
+    setup();
+    dma.fail = true;
+    CHECK(!lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    CHECK(!lcd_xfer_busy(&xfer));
+    CHECK_EQ(xfer.complete, 0);
+    CHECK_EQ(dma.notifies, 0);
+
+    // 长度为 0 不启动
+    dma.fail = false;
+    CHECK(!lcd_xfer_submit(&xfer, buf, 0));
+    CHECK_EQ(dma.starts, 0);
+
+    // 没有后端
+    lcd_xfer_init(&xfer, NULL, NULL);
+    CHECK(!lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+}
+
+/* 残留的通知让等待提前返回: 以状态为准继续等待 */
+static void test_stale_notify(void)
+{
+    uint8_t buf[64];
+
+    setup();
+    CHECK(lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    dma.spurious = 2;
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(dma.waits, 3);
+    CHECK(!lcd_xfer_busy(&xfer));
+    CHECK_EQ(xfer.complete, 1);
+}
+
+/* 空闲时的中断 (如迟到的完成或错误回调) 不改变状态 */
+static void test_idle_isr(void)
+{
+    setup();
+    lcd_xfer_isr(&xfer);
+    lcd_xfer_abort(&xfer);
+    CHECK_EQ(xfer.error, 0);
+    CHECK_EQ(xfer.complete, 0);
+    CHECK_EQ(dma.notifies, 0);
+    CHECK(!lcd_xfer_busy(&xfer));
+}
+
+/* 按 seg_max 分段: 每段从上一段结尾开始, 只有最后一段可以较短, 全部完成才通知一次 */
+static void check_chain(const uint8_t* buf, uint32_t len, uint32_t seg_max, bool fixed)
+{
+    uint32_t segments = (len + seg_max - 1) / seg_max;
+    uint32_t sum = 0;
+
+    setup();
+    xfer.seg_max = seg_max;
+    if(fixed)
+        CHECK(lcd_xfer_repeat(&xfer, buf, len));
+    else
+        CHECK(lcd_xfer_submit(&xfer, buf, len));
+    CHECK_EQ(dma.starts, 1);
+    lcd_xfer_wait(&xfer);
+
+    CHECK_EQ(dma.starts, segments);
+    CHECK_EQ(dma.waits, segments);
+    for(uint32_t i = 0; i < segments && i < 8; i++) {
+        CHECK(dma.data[i] == (fixed ? buf : buf + sum));
+        CHECK_EQ(dma.len[i], i + 1 < segments ? seg_max : len - sum);
+        sum += dma.len[i];
+    }
+    CHECK_EQ(sum, len);
+    CHECK_EQ(xfer.complete, 1);
+    CHECK_EQ(xfer.error, 0);
+    CHECK_EQ(dma.notifies, 1);
+    CHECK(!lcd_xfer_busy(&xfer));
+}
+
+/* 每个 65535 倍数附近的长度; 16 位帧时 seg_max 为 2 * 65535 字节 */
+static void test_segments(void)
+{
+    static const uint8_t buf[6 * 65535 * 2];
+
+    for(uint32_t k = 1; k <= 5; k++) {
+        for(int d = -1; d <= 1; d++) {
+            check_chain(buf, k * 65535 + d, 65535, false);
+            check_chain(buf, k * 65535 + d, 65535, true);
+            check_chain(buf, (k * 65535 + d) * 2, 65535 * 2, false);
+        }
+    }
+    // 小于一段与不分段
+    check_chain(buf, 1, 65535, false);
+    check_chain(buf, sizeof(buf), sizeof(buf), false);
+}
+
+/* 中途接续失败: 记录错误并结束传输, 仍通知一次, 等待者不会卡住 */
+static void test_segment_fail(void)
+{
+    static const uint8_t buf[3 * 65535];
+
+    setup();
+    xfer.seg_max = 65535;
+    dma.fail_at = 2;
+    CHECK(lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    lcd_xfer_wait(&xfer);
+    CHECK(!lcd_xfer_busy(&xfer));
+    CHECK_EQ(dma.starts, 1);
+    CHECK_EQ(xfer.error, 1);
+    CHECK_EQ(xfer.complete, 1);
+    CHECK_EQ(dma.notifies, 1);
+
+    // 之后的传输不受影响
+    dma.fail_at = 0;
+    CHECK(lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(dma.starts, 4);
+    CHECK_EQ(xfer.complete, 2);
+    CHECK_EQ(xfer.error, 1);
+}
+
+/* 某一段传输出错: 不接续后面的段, 记录错误, 仍通知一次; 单段传输出错同样记录 */
+static void test_segment_error(void)
+{
+    static const uint8_t buf[3 * 65535];
+    uint16_t pixel = 0xf800;
+
+    setup();
+    xfer.seg_max = 65535;
+    dma.error_at = 2;
+    CHECK(lcd_xfer_repeat(&xfer, (const uint8_t *)&pixel, sizeof(buf)));
+    lcd_xfer_wait(&xfer);
+    CHECK(!lcd_xfer_busy(&xfer));
+    CHECK_EQ(dma.starts, 2);
+    CHECK_EQ(xfer.error, 1);
+    CHECK_EQ(xfer.complete, 1);
+    CHECK_EQ(dma.notifies, 1);
+
+    // 迟到的完成中断不会接续已中止的传输
+    lcd_xfer_isr(&xfer);
+    CHECK_EQ(dma.starts, 2);
+    CHECK_EQ(xfer.complete, 1);
+
+    dma.error_at = 3;
+    CHECK(lcd_xfer_submit(&xfer, buf, 100));
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(xfer.error, 2);
+    CHECK_EQ(xfer.complete, 2);
+
+    // 之后的传输不受影响
+    dma.error_at = 0;
+    CHECK(lcd_xfer_submit(&xfer, buf, sizeof(buf)));
+    lcd_xfer_wait(&xfer);
+    CHECK_EQ(dma.starts, 6);
+    CHECK_EQ(xfer.error, 2);
+    CHECK_EQ(xfer.complete, 3);
+}
+
+int main(void)
+{
+    test_async();
+    test_back_to_back();
+    test_start_fail();
+    test_stale_notify();
+    test_idle_isr();
+    test_segments();
+    test_segment_fail();
+    test_segment_error();
+    return test_result();
+}